@@ -64,6 +64,7 @@ MUSESCORE_BUILD_VST=$BUILD_VST \
 MUSESCORE_VST3_SDK_PATH=$VST3_SDK_PATH \
 MUSESCORE_DOWNLOAD_SOUNDFONT=OFF \
 MUSESCORE_BUILD_UNIT_TESTS=ON \
+MUSESCORE_AUDIO_REALTIME_GUARD=ON \
 bash ./ninja_build.sh -t debug          
 
 df -h .
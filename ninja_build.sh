@@ -35,6 +35,7 @@ MUSESCORE_BUILD_VST=${MUSESCORE_BUILD_VST:-"OFF"}
 MUSESCORE_VST3_SDK_PATH=${MUSESCORE_VST3_SDK_PATH:-""}
 MUSESCORE_DOWNLOAD_SOUNDFONT=${MUSESCORE_DOWNLOAD_SOUNDFONT:-"ON"}
 MUSESCORE_BUILD_UNIT_TESTS=${MUSESCORE_BUILD_UNIT_TESTS:-"OFF"}
+MUSESCORE_AUDIO_REALTIME_GUARD=${MUSESCORE_AUDIO_REALTIME_GUARD:-"OFF"}
 MUSESCORE_NO_RPATH=${MUSESCORE_NO_RPATH:-"OFF"}
 MUSESCORE_YOUTUBE_API_KEY=${MUSESCORE_YOUTUBE_API_KEY:-""}
 
@@ -76,6 +77,7 @@ function do_build() {
         -DVST3_SDK_PATH="${MUSESCORE_VST3_SDK_PATH}" \
         -DDOWNLOAD_SOUNDFONT="${MUSESCORE_DOWNLOAD_SOUNDFONT}" \
         -DBUILD_UNIT_TESTS="${MUSESCORE_BUILD_UNIT_TESTS}" \
+        -DAUDIO_REALTIME_GUARD="${MUSESCORE_AUDIO_REALTIME_GUARD}" \
         -DCMAKE_SKIP_RPATH="${MUSESCORE_NO_RPATH}" \
         -DYOUTUBE_API_KEY="${MUSESCORE_YOUTUBE_API_KEY}"
 
@@ -24,6 +24,8 @@
 
 #include "config.h"
 
+#include <functional>
+
 #include <QApplication>
 #include <QQmlApplicationEngine>
 #include <QQuickWindow>
@@ -55,6 +57,26 @@ void AppShell::addModule(modularity::IModuleSetup* module)
     m_modules.push_back(module);
 }
 
+void AppShell::addGuiModule(modularity::IModuleSetup* module)
+{
+    m_modules.push_back(module);
+    m_guiModules.push_back(module);
+}
+
+//! NOTE Each setup step of each module is measured as a profiler function,
+//! so they show up in the profiler data printed on exit
+static void traceSetupStep(modularity::IModuleSetup* module, const char* step, const std::function<void()>& func)
+{
+#ifdef HAW_PROFILER_ENABLED
+    const std::string& info = haw::profiler::Profiler::instance()->staticInfo(module->moduleName() + "::" + step);
+    haw::profiler::FuncMarker marker(info);
+#else
+    UNUSED(module);
+    UNUSED(step);
+#endif
+    func();
+}
+
 int AppShell::run(int argc, char** argv)
 {
     // ====================================================
@@ -87,6 +109,22 @@ int AppShell::run(int argc, char** argv)
     QCoreApplication::setOrganizationDomain("musescore.org");
     QCoreApplication::setApplicationVersion(QString::fromStdString(framework::Version::fullVersion()));
 
+    BEGIN_STEP_TIME("Startup");
+
+    // ====================================================
+    // Parse command line options
+    // ====================================================
+    //! NOTE Only parse here, the options are applied when the modules are set up,
+    //! but the run mode is needed to know which modules to set up
+    CommandLineController commandLine;
+    commandLine.parse(QCoreApplication::arguments());
+
+    if (commandLine.isConverterMode()) {
+        for (mu::modularity::IModuleSetup* m : m_guiModules) {
+            m_modules.removeOne(m);
+        }
+    }
+
     // ====================================================
     // Setup modules: Resources, Exports, Imports, UiTypes
     // ====================================================
@@ -95,24 +133,24 @@ int AppShell::run(int argc, char** argv)
     globalModule.registerUiTypes();
 
     for (mu::modularity::IModuleSetup* m : m_modules) {
-        m->registerResources();
+        traceSetupStep(m, "registerResources", [m]() { m->registerResources(); });
     }
 
     for (mu::modularity::IModuleSetup* m : m_modules) {
-        m->registerExports();
+        traceSetupStep(m, "registerExports", [m]() { m->registerExports(); });
     }
 
     globalModule.resolveImports();
     for (mu::modularity::IModuleSetup* m : m_modules) {
-        m->registerUiTypes();
-        m->resolveImports();
+        traceSetupStep(m, "registerUiTypes", [m]() { m->registerUiTypes(); });
+        traceSetupStep(m, "resolveImports", [m]() { m->resolveImports(); });
     }
 
+    STEP_TIME("Startup", "modules registered");
+
     // ====================================================
-    // Parse and apply command line options
+    // Apply command line options
     // ====================================================
-    CommandLineController commandLine;
-    commandLine.parse(QCoreApplication::arguments());
     commandLine.apply();
     framework::IApplication::RunMode runMode = muapplication()->runMode();
 
@@ -121,17 +159,21 @@ int AppShell::run(int argc, char** argv)
     // ====================================================
     globalModule.onInit(runMode);
     for (mu::modularity::IModuleSetup* m : m_modules) {
-        m->onInit(runMode);
+        traceSetupStep(m, "onInit", [m, runMode]() { m->onInit(runMode); });
     }
 
+    STEP_TIME("Startup", "modules inited");
+
     // ====================================================
     // Setup modules: onAllInited
     // ====================================================
     globalModule.onAllInited(runMode);
     for (mu::modularity::IModuleSetup* m : m_modules) {
-        m->onAllInited(runMode);
+        traceSetupStep(m, "onAllInited", [m, runMode]() { m->onAllInited(runMode); });
     }
 
+    STEP_TIME("Startup", "modules all inited");
+
     // ====================================================
     // Setup modules: onStartApp (on next event loop)
     // ====================================================
@@ -153,6 +195,7 @@ int AppShell::run(int argc, char** argv)
         // ====================================================
         auto task = commandLine.converterTask();
         QMetaObject::invokeMethod(qApp, [this, task]() {
+                STEP_TIME("Startup", "converter started");
                 int code = processConverter(task);
                 qApp->exit(code);
             }, Qt::QueuedConnection);
@@ -207,13 +250,15 @@ int AppShell::run(int argc, char** argv)
 
         engine->load(url);
 
+        STEP_TIME("Startup", "main qml loaded");
+
         // ====================================================
         // Setup modules: onDelayedInit
         // ====================================================
         QTimer::singleShot(5000, [this]() {
                 globalModule.onDelayedInit();
                 for (mu::modularity::IModuleSetup* m : m_modules) {
-                    m->onDelayedInit();
+                    traceSetupStep(m, "onDelayedInit", [m]() { m->onDelayedInit(); });
                 }
             });
     }
@@ -43,6 +43,9 @@ public:
 
     void addModule(modularity::IModuleSetup* module);
 
+    //! NOTE Modules needed only by the editor UI, they are not set up at all in the converter mode
+    void addGuiModule(modularity::IModuleSetup* module);
+
     int run(int argc, char** argv);
 
 private:
@@ -50,6 +53,7 @@ private:
     int processConverter(const CommandLineController::ConverterTask& task);
 
     QList<modularity::IModuleSetup*> m_modules;
+    QList<modularity::IModuleSetup*> m_guiModules;
 };
 }
 
@@ -79,6 +79,22 @@ void CommandLineController::parse(const QStringList& args)
     m_parser.process(args);
 }
 
+bool CommandLineController::isConverterMode() const
+{
+    //! NOTE The options for which apply() sets the converter run mode
+    static const QStringList CONVERTER_OPTIONS = {
+        "o", "j", "score-media", "score-meta", "score-parts", "score-parts-pdf", "score-transpose", "source-update"
+    };
+
+    for (const QString& option : CONVERTER_OPTIONS) {
+        if (m_parser.isSet(option)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void CommandLineController::apply()
 {
     auto floatValue = [this](const QString& name) -> std::optional<float> {
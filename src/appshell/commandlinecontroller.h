@@ -82,6 +82,8 @@ public:
     void parse(const QStringList& args);
     void apply();
 
+    bool isConverterMode() const;
+
     ConverterTask converterTask() const;
 
 private:
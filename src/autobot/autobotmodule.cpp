@@ -35,7 +35,7 @@
 
 using namespace mu::autobot;
 
-static const std::shared_ptr<Autobot> s_autobot = std::make_shared<Autobot>();
+static std::shared_ptr<Autobot> s_autobot;
 
 std::string AutobotModule::moduleName() const
 {
@@ -44,6 +44,9 @@ std::string AutobotModule::moduleName() const
 
 void AutobotModule::registerExports()
 {
+    //! NOTE Created here rather than statically, so nothing is created when the module is not set up (converter mode)
+    s_autobot = std::make_shared<Autobot>();
+
     modularity::ioc()->registerExport<IAutobot>(moduleName(), s_autobot);
     modularity::ioc()->registerExport<IAutobotConfiguration>(moduleName(), new AutobotConfiguration());
 
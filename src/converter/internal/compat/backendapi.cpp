@@ -22,6 +22,7 @@
 #include "backendapi.h"
 
 #include <stdio.h>
+#include <functional>
 
 #include <QString>
 #include <QBuffer>
@@ -30,6 +31,7 @@
 #include <QJsonArray>
 #include <QJsonValue>
 #include <QRandomGenerator>
+#include <QElapsedTimer>
 
 #include "engraving/compat/scoreaccess.h"
 #include "libmscore/excerpt.h"
@@ -54,6 +56,7 @@ static const std::string PDF_WRITER_NAME = "pdf";
 static const std::string MIDI_WRITER_NAME = "midi";
 static const std::string MUSICXML_WRITER_NAME = "mxml";
 static const std::string META_DATA_NAME = "metadata";
+static const std::string TIMINGS_NAME = "timings";
 
 static constexpr bool ADD_SEPARATOR = true;
 static constexpr auto NO_STYLE = "";
@@ -77,14 +80,31 @@ Ret BackendApi::exportScoreMedia(const io::path& in, const io::path& out, const
 
     BackendJsonWriter jsonWriter(&outputFile);
 
-    result &= exportScorePngs(notation, jsonWriter, ADD_SEPARATOR);
-    result &= exportScoreSvgs(notation, highlightConfigPath, jsonWriter, ADD_SEPARATOR);
-    result &= exportScoreElementsPositions(SEGMENTS_POSITIONS_WRITER_NAME, notation, jsonWriter, ADD_SEPARATOR);
-    result &= exportScoreElementsPositions(MEASURES_POSITIONS_WRITER_NAME, notation, jsonWriter, ADD_SEPARATOR);
-    result &= exportScorePdf(notation, jsonWriter, ADD_SEPARATOR);
-    result &= exportScoreMidi(notation, jsonWriter, ADD_SEPARATOR);
-    result &= exportScoreMusicXML(notation, jsonWriter, ADD_SEPARATOR);
-    result &= exportScoreMetaData(notation, jsonWriter);
+    //! NOTE The writers run one after another: they share the score and temporarily
+    //! change its state (printing mode, pixel ratio, midi rendering)
+    WritersTimings timings;
+    auto measure = [&timings](const std::string& name, const std::function<Ret()>& write) {
+        QElapsedTimer timer;
+        timer.start();
+        Ret ret = write();
+        timings.push_back({ name, timer.elapsed() });
+        return ret;
+    };
+
+    result &= measure(PNG_WRITER_NAME, [&]() { return exportScorePngs(notation, jsonWriter, ADD_SEPARATOR); });
+    result &= measure(SVG_WRITER_NAME, [&]() { return exportScoreSvgs(notation, highlightConfigPath, jsonWriter, ADD_SEPARATOR); });
+    result &= measure(SEGMENTS_POSITIONS_WRITER_NAME, [&]() {
+        return exportScoreElementsPositions(SEGMENTS_POSITIONS_WRITER_NAME, notation, jsonWriter, ADD_SEPARATOR);
+    });
+    result &= measure(MEASURES_POSITIONS_WRITER_NAME, [&]() {
+        return exportScoreElementsPositions(MEASURES_POSITIONS_WRITER_NAME, notation, jsonWriter, ADD_SEPARATOR);
+    });
+    result &= measure(PDF_WRITER_NAME, [&]() { return exportScorePdf(notation, jsonWriter, ADD_SEPARATOR); });
+    result &= measure(MIDI_WRITER_NAME, [&]() { return exportScoreMidi(notation, jsonWriter, ADD_SEPARATOR); });
+    result &= measure(MUSICXML_WRITER_NAME, [&]() { return exportScoreMusicXML(notation, jsonWriter, ADD_SEPARATOR); });
+    result &= measure(META_DATA_NAME, [&]() { return exportScoreMetaData(notation, jsonWriter, ADD_SEPARATOR); });
+
+    exportWritersTimings(timings, jsonWriter);
 
     return result ? make_ret(Ret::Code::Ok) : make_ret(Ret::Code::InternalError);
 }
@@ -307,7 +327,7 @@ Ret BackendApi::exportScorePngs(const INotationPtr notation, BackendJsonWriter&
         }
 
         bool lastArrayValue = ((notationPages.size() - 1) == i);
-        jsonWriter.addValue(pngData.toBase64(), lastArrayValue);
+        jsonWriter.addBase64Value(pngData, !lastArrayValue);
     }
 
     jsonWriter.closeArray(addSeparator);
@@ -351,7 +371,7 @@ Ret BackendApi::exportScoreSvgs(const INotationPtr notation, const io::path& hig
         }
 
         bool lastArrayValue = ((notationPages.size() - 1) == i);
-        jsonWriter.addValue(svgData.toBase64(), !lastArrayValue);
+        jsonWriter.addBase64Value(svgData, !lastArrayValue);
     }
 
     jsonWriter.closeArray(addSeparator);
@@ -364,13 +384,13 @@ Ret BackendApi::exportScoreElementsPositions(const std::string& elementsPosition
 {
     TRACEFUNC
 
-    RetVal<QByteArray> writerRetVal = processWriter(elementsPositionsWriterName, notation);
+    RetVal<QByteArray> writerRetVal = processWriterRaw(elementsPositionsWriterName, notation);
     if (!writerRetVal.ret) {
         return writerRetVal.ret;
     }
 
     jsonWriter.addKey(elementsPositionsWriterName.c_str());
-    jsonWriter.addValue(writerRetVal.val, addSeparator, false);
+    jsonWriter.addBase64Value(writerRetVal.val, addSeparator);
 
     return make_ret(Ret::Code::Ok);
 }
@@ -379,13 +399,13 @@ Ret BackendApi::exportScorePdf(const INotationPtr notation, BackendJsonWriter& j
 {
     TRACEFUNC
 
-    RetVal<QByteArray> writerRetVal = processWriter(PDF_WRITER_NAME, notation);
+    RetVal<QByteArray> writerRetVal = processWriterRaw(PDF_WRITER_NAME, notation);
     if (!writerRetVal.ret) {
         return writerRetVal.ret;
     }
 
     jsonWriter.addKey(PDF_WRITER_NAME.c_str());
-    jsonWriter.addValue(writerRetVal.val, addSeparator);
+    jsonWriter.addBase64Value(writerRetVal.val, addSeparator);
 
     return make_ret(Ret::Code::Ok);
 }
@@ -409,13 +429,13 @@ Ret BackendApi::exportScoreMidi(const INotationPtr notation, BackendJsonWriter&
 {
     TRACEFUNC
 
-    RetVal<QByteArray> writerRetVal = processWriter(MIDI_WRITER_NAME, notation);
+    RetVal<QByteArray> writerRetVal = processWriterRaw(MIDI_WRITER_NAME, notation);
     if (!writerRetVal.ret) {
         return writerRetVal.ret;
     }
 
     jsonWriter.addKey(MIDI_WRITER_NAME.c_str());
-    jsonWriter.addValue(writerRetVal.val, addSeparator);
+    jsonWriter.addBase64Value(writerRetVal.val, addSeparator);
 
     return make_ret(Ret::Code::Ok);
 }
@@ -424,13 +444,13 @@ Ret BackendApi::exportScoreMusicXML(const INotationPtr notation, BackendJsonWrit
 {
     TRACEFUNC
 
-    RetVal<QByteArray> writerRetVal = processWriter(MUSICXML_WRITER_NAME, notation);
+    RetVal<QByteArray> writerRetVal = processWriterRaw(MUSICXML_WRITER_NAME, notation);
     if (!writerRetVal.ret) {
         return writerRetVal.ret;
     }
 
     jsonWriter.addKey(MUSICXML_WRITER_NAME.c_str());
-    jsonWriter.addValue(writerRetVal.val, addSeparator);
+    jsonWriter.addBase64Value(writerRetVal.val, addSeparator);
 
     return make_ret(Ret::Code::Ok);
 }
@@ -451,7 +471,30 @@ Ret BackendApi::exportScoreMetaData(const INotationPtr notation, BackendJsonWrit
     return make_ret(Ret::Code::Ok);
 }
 
+Ret BackendApi::exportWritersTimings(const WritersTimings& timings, BackendJsonWriter& jsonWriter, bool addSeparator)
+{
+    QJsonObject timingsObj;
+    for (const auto& timing : timings) {
+        timingsObj[QString::fromStdString(timing.first)] = static_cast<double>(timing.second);
+    }
+
+    jsonWriter.addKey(TIMINGS_NAME.c_str());
+    jsonWriter.addValue(QJsonDocument(timingsObj).toJson(QJsonDocument::Compact), addSeparator, true);
+
+    return make_ret(Ret::Code::Ok);
+}
+
 mu::RetVal<QByteArray> BackendApi::processWriter(const std::string& writerName, const INotationPtr notation)
+{
+    RetVal<QByteArray> result = processWriterRaw(writerName, notation);
+    if (result.ret) {
+        result.val = result.val.toBase64();
+    }
+
+    return result;
+}
+
+mu::RetVal<QByteArray> BackendApi::processWriterRaw(const std::string& writerName, const INotationPtr notation)
 {
     auto writer = writers()->writer(writerName);
     if (!writer) {
@@ -469,11 +512,11 @@ mu::RetVal<QByteArray> BackendApi::processWriter(const std::string& writerName,
         return writeRet;
     }
 
+    device.close();
+
     RetVal<QByteArray> result;
     result.ret = make_ret(Ret::Code::Ok);
-    result.val = data.toBase64();
-
-    device.close();
+    result.val = data;
 
     return result;
 }
@@ -22,6 +22,8 @@
 #ifndef MU_CONVERTER_BACKENDAPI_H
 #define MU_CONVERTER_BACKENDAPI_H
 
+#include <vector>
+
 #include "retval.h"
 
 #include "io/path.h"
@@ -79,7 +81,12 @@ private:
     static Ret exportScoreMusicXML(const notation::INotationPtr notation, BackendJsonWriter& jsonWriter, bool addSeparator = false);
     static Ret exportScoreMetaData(const notation::INotationPtr notation, BackendJsonWriter& jsonWriter, bool addSeparator = false);
 
+    //! NOTE Writer name and its time in milliseconds, in the order the writers ran
+    using WritersTimings = std::vector<std::pair<std::string, qint64> >;
+    static Ret exportWritersTimings(const WritersTimings& timings, BackendJsonWriter& jsonWriter, bool addSeparator = false);
+
     static mu::RetVal<QByteArray> processWriter(const std::string& writerName, const notation::INotationPtr notation);
+    static mu::RetVal<QByteArray> processWriterRaw(const std::string& writerName, const notation::INotationPtr notation);
     static mu::RetVal<QByteArray> processWriter(const std::string& writerName, const notation::INotationPtrList notations,
                                                 const project::INotationWriter::Options& options);
 
@@ -21,6 +21,8 @@
  */
 #include "backendjsonwriter.h"
 
+#include <algorithm>
+
 using namespace mu::converter;
 using namespace mu::io;
 
@@ -58,6 +60,24 @@ void BackendJsonWriter::addValue(const QByteArray& data, bool addSeparator, bool
     }
 }
 
+//! NOTE Encodes chunk by chunk straight into the destination,
+//! so the whole base64 copy of the data is never held in memory
+void BackendJsonWriter::addBase64Value(const QByteArray& rawData, bool addSeparator)
+{
+    //! NOTE Must be a multiple of 3, so that chunks are encoded without padding
+    static constexpr int CHUNK_SIZE = 3 * 16 * 1024;
+
+    m_destinationDevice->write("\"");
+    for (int pos = 0; pos < rawData.size(); pos += CHUNK_SIZE) {
+        QByteArray chunk = QByteArray::fromRawData(rawData.constData() + pos, std::min(CHUNK_SIZE, rawData.size() - pos));
+        m_destinationDevice->write(chunk.toBase64());
+    }
+    m_destinationDevice->write("\"");
+    if (addSeparator) {
+        m_destinationDevice->write(",\n");
+    }
+}
+
 void BackendJsonWriter::openArray()
 {
     m_destinationDevice->write(" [");
@@ -34,6 +34,7 @@ public:
 
     void addKey(const char* arrayName);
     void addValue(const QByteArray& data, bool addSeparator = false, bool isJson = false);
+    void addBase64Value(const QByteArray& rawData, bool addSeparator = false);
 
     void openArray();
     void closeArray(bool addSeparator = false);
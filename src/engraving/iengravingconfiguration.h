@@ -60,6 +60,8 @@ public:
     virtual async::Channel<int, draw::Color> selectionColorChanged() const = 0;
 
     virtual draw::Color highlightSelectionColor(int voiceIndex = 0) const = 0;
+
+    virtual QString glyphMetricsCacheDir() const = 0;
 };
 }
 
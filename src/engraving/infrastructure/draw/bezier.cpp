@@ -22,7 +22,125 @@
 
 #include "bezier.h"
 
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MU_BEZIER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MU_BEZIER_NEON
+#endif
+
 namespace mu {
+//! NOTE The same threshold as qFuzzyIsNull(double)
+static constexpr double FUZZY_NULL = 0.000000000001;
+
+//! NOTE Vec2 holds the x and y coordinates of a point (or of the coefficients) in its two lanes,
+//! so both coordinates are evaluated by the same instructions
+#if defined(MU_BEZIER_SSE2)
+using Vec2 = __m128d;
+using Mask2 = __m128d;
+
+static inline Vec2 vset(double x, double y) { return _mm_set_pd(y, x); }
+static inline Vec2 vdup(double v) { return _mm_set1_pd(v); }
+static inline Vec2 vadd(Vec2 a, Vec2 b) { return _mm_add_pd(a, b); }
+static inline Vec2 vsub(Vec2 a, Vec2 b) { return _mm_sub_pd(a, b); }
+static inline Vec2 vmul(Vec2 a, Vec2 b) { return _mm_mul_pd(a, b); }
+static inline Vec2 vdiv(Vec2 a, Vec2 b) { return _mm_div_pd(a, b); }
+static inline Vec2 vmin(Vec2 a, Vec2 b) { return _mm_min_pd(a, b); }
+static inline Vec2 vmax(Vec2 a, Vec2 b) { return _mm_max_pd(a, b); }
+static inline Vec2 vsqrt(Vec2 a) { return _mm_sqrt_pd(a); }
+static inline Vec2 vabs(Vec2 a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+static inline Mask2 vle(Vec2 a, Vec2 b) { return _mm_cmple_pd(a, b); }
+static inline Mask2 vlt(Vec2 a, Vec2 b) { return _mm_cmplt_pd(a, b); }
+static inline Mask2 vand(Mask2 a, Mask2 b) { return _mm_and_pd(a, b); }
+static inline Vec2 vselect(Mask2 m, Vec2 a, Vec2 b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+static inline double vx(Vec2 a) { return _mm_cvtsd_f64(a); }
+static inline double vy(Vec2 a) { return _mm_cvtsd_f64(_mm_unpackhi_pd(a, a)); }
+#elif defined(MU_BEZIER_NEON)
+using Vec2 = float64x2_t;
+using Mask2 = uint64x2_t;
+
+static inline Vec2 vset(double x, double y) { return vcombine_f64(vdup_n_f64(x), vdup_n_f64(y)); }
+static inline Vec2 vdup(double v) { return vdupq_n_f64(v); }
+static inline Vec2 vadd(Vec2 a, Vec2 b) { return vaddq_f64(a, b); }
+static inline Vec2 vsub(Vec2 a, Vec2 b) { return vsubq_f64(a, b); }
+static inline Vec2 vmul(Vec2 a, Vec2 b) { return vmulq_f64(a, b); }
+static inline Vec2 vdiv(Vec2 a, Vec2 b) { return vdivq_f64(a, b); }
+static inline Vec2 vmin(Vec2 a, Vec2 b) { return vminq_f64(a, b); }
+static inline Vec2 vmax(Vec2 a, Vec2 b) { return vmaxq_f64(a, b); }
+static inline Vec2 vsqrt(Vec2 a) { return vsqrtq_f64(a); }
+static inline Vec2 vabs(Vec2 a) { return vabsq_f64(a); }
+static inline Mask2 vle(Vec2 a, Vec2 b) { return vcleq_f64(a, b); }
+static inline Mask2 vlt(Vec2 a, Vec2 b) { return vcltq_f64(a, b); }
+static inline Mask2 vand(Mask2 a, Mask2 b) { return vandq_u64(a, b); }
+static inline Vec2 vselect(Mask2 m, Vec2 a, Vec2 b) { return vbslq_f64(m, a, b); }
+static inline Mask2 vselect(Mask2 m, Mask2 a, Mask2 b) { return vbslq_u64(m, a, b); }
+static inline double vx(Vec2 a) { return vgetq_lane_f64(a, 0); }
+static inline double vy(Vec2 a) { return vgetq_lane_f64(a, 1); }
+#endif
+
+#if defined(MU_BEZIER_SSE2) || defined(MU_BEZIER_NEON)
+#define MU_BEZIER_SIMD
+
+static inline Vec2 vpointAt(Vec2 p1, Vec2 p2, Vec2 p3, Vec2 p4, Vec2 t)
+{
+    const Vec2 t1 = vsub(vdup(1.0), t);
+    Vec2 a = vadd(vmul(p1, t1), vmul(p2, t));
+    Vec2 b = vadd(vmul(p2, t1), vmul(p3, t));
+    const Vec2 c = vadd(vmul(p3, t1), vmul(p4, t));
+    a = vadd(vmul(a, t1), vmul(b, t));
+    b = vadd(vmul(b, t1), vmul(c, t));
+    return vadd(vmul(a, t1), vmul(b, t));
+}
+
+#else
+
+static inline double coordinateAt(double p1, double p2, double p3, double p4, double t)
+{
+    const double t1 = 1. - t;
+    double a = p1 * t1 + p2 * t;
+    double b = p2 * t1 + p3 * t;
+    const double c = p3 * t1 + p4 * t;
+    a = a * t1 + b * t;
+    b = b * t1 + c * t;
+    return a * t1 + b * t;
+}
+
+//! extends [min, max] by the extrema of one coordinate, where its derivative is zero
+static void extendByExtrema(double p1, double p2, double p3, double p4, double& min, double& max)
+{
+    auto check = [&](double t) {
+        if (t >= 0 && t <= 1) {
+            const double v = coordinateAt(p1, p2, p3, p4, t);
+            min = std::min(min, v);
+            max = std::max(max, v);
+        }
+    };
+
+    const double a = 3 * (-p1 + 3 * p2 - 3 * p3 + p4);
+    const double b = 6 * (p1 - 2 * p2 + p3);
+    const double c = 3 * (p2 - p1);
+
+    if (qFuzzyIsNull(a)) {
+        // linear curves are covered by the end points
+        if (!qFuzzyIsNull(b)) {
+            check(-c / b);
+        }
+        return;
+    }
+
+    const double disc = b * b - 4 * a * c;
+    if (disc >= 0) {
+        const double root = std::sqrt(disc);
+        const double rcp = 1 / (2 * a);
+        check((-b + root) * rcp);
+        check((-b - root) * rcp);
+    }
+}
+
+#endif
 Bezier::Bezier(double x1, double y1,
                double x2, double y2,
                double x3, double y3,
@@ -103,4 +221,105 @@ PointF Bezier::pointAt(double t) const
     }
     return PointF(x, y);
 }
+
+void Bezier::flatten(size_t segmentsCount, PointF* points) const
+{
+    if (segmentsCount == 0) {
+        return;
+    }
+
+    const double step = 1.0 / static_cast<double>(segmentsCount);
+
+    // the power basis: ((a * t + b) * t + c) * t + p1
+#ifdef MU_BEZIER_SIMD
+    const Vec2 p1 = vset(m_x1, m_y1);
+    const Vec2 p2 = vset(m_x2, m_y2);
+    const Vec2 p3 = vset(m_x3, m_y3);
+    const Vec2 p4 = vset(m_x4, m_y4);
+
+    const Vec2 three = vdup(3.0);
+    const Vec2 a = vadd(vsub(p4, p1), vmul(three, vsub(p2, p3)));
+    const Vec2 b = vmul(three, vadd(vsub(p1, vmul(vdup(2.0), p2)), p3));
+    const Vec2 c = vmul(three, vsub(p2, p1));
+
+    for (size_t i = 0; i + 1 < segmentsCount; ++i) {
+        const Vec2 t = vdup(static_cast<double>(i + 1) * step);
+        const Vec2 p = vadd(vmul(vadd(vmul(vadd(vmul(a, t), b), t), c), t), p1);
+        points[i] = PointF(vx(p), vy(p));
+    }
+#else
+    const double ax = m_x4 - m_x1 + 3 * (m_x2 - m_x3);
+    const double ay = m_y4 - m_y1 + 3 * (m_y2 - m_y3);
+    const double bx = 3 * (m_x1 - 2 * m_x2 + m_x3);
+    const double by = 3 * (m_y1 - 2 * m_y2 + m_y3);
+    const double cx = 3 * (m_x2 - m_x1);
+    const double cy = 3 * (m_y2 - m_y1);
+
+    for (size_t i = 0; i + 1 < segmentsCount; ++i) {
+        const double t = static_cast<double>(i + 1) * step;
+        points[i] = PointF(((ax * t + bx) * t + cx) * t + m_x1, ((ay * t + by) * t + cy) * t + m_y1);
+    }
+#endif
+
+    // exactly the end point
+    points[segmentsCount - 1] = pt4();
+}
+
+RectF Bezier::boundingRect() const
+{
+#ifdef MU_BEZIER_SIMD
+    const Vec2 p1 = vset(m_x1, m_y1);
+    const Vec2 p2 = vset(m_x2, m_y2);
+    const Vec2 p3 = vset(m_x3, m_y3);
+    const Vec2 p4 = vset(m_x4, m_y4);
+
+    // initialize with the end points
+    Vec2 lo = vmin(p1, p4);
+    Vec2 hi = vmax(p1, p4);
+
+    // the derivative: a * t^2 + b * t + c
+    const Vec2 zero = vdup(0.0);
+    const Vec2 one = vdup(1.0);
+    const Vec2 three = vdup(3.0);
+    const Vec2 a = vmul(three, vadd(vsub(p4, p1), vmul(three, vsub(p2, p3))));
+    const Vec2 b = vmul(vdup(6.0), vadd(vsub(p1, vmul(vdup(2.0), p2)), p3));
+    const Vec2 c = vmul(three, vsub(p2, p1));
+
+    // the lanes of the quadratic derivatives take its single root (linear curves are covered by the end points),
+    // the values of the other branch are just masked out, so the divisions by zero don't matter
+    const Vec2 eps = vdup(FUZZY_NULL);
+    const Mask2 isQuadratic = vle(vabs(a), eps);
+
+    const Vec2 disc = vsub(vmul(b, b), vmul(vmul(vdup(4.0), a), c));
+    const Vec2 root = vsqrt(vmax(disc, zero));
+    const Vec2 rcp = vdiv(one, vmul(vdup(2.0), a));
+    const Vec2 singleRoot = vdiv(vsub(zero, c), b);
+
+    const Mask2 hasRoots = vselect(isQuadratic, vlt(eps, vabs(b)), vle(zero, disc));
+    const Vec2 t1 = vselect(isQuadratic, singleRoot, vmul(vsub(root, b), rcp));
+    const Vec2 t2 = vselect(isQuadratic, singleRoot, vmul(vsub(vsub(zero, b), root), rcp));
+
+    const Mask2 valid1 = vand(hasRoots, vand(vle(zero, t1), vle(t1, one)));
+    const Vec2 v1 = vselect(valid1, vpointAt(p1, p2, p3, p4, t1), lo);
+    lo = vmin(lo, v1);
+    hi = vmax(hi, v1);
+
+    const Mask2 valid2 = vand(hasRoots, vand(vle(zero, t2), vle(t2, one)));
+    const Vec2 v2 = vselect(valid2, vpointAt(p1, p2, p3, p4, t2), lo);
+    lo = vmin(lo, v2);
+    hi = vmax(hi, v2);
+
+    return RectF(vx(lo), vy(lo), vx(hi) - vx(lo), vy(hi) - vy(lo));
+#else
+    double minx = std::min(m_x1, m_x4);
+    double maxx = std::max(m_x1, m_x4);
+    double miny = std::min(m_y1, m_y4);
+    double maxy = std::max(m_y1, m_y4);
+
+    extendByExtrema(m_x1, m_x2, m_x3, m_x4, minx, maxx);
+    extendByExtrema(m_y1, m_y2, m_y3, m_y4, miny, maxy);
+
+    return RectF(minx, miny, maxx - minx, maxy - miny);
+#endif
+}
 }
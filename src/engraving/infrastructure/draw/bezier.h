@@ -43,12 +43,26 @@ public:
 
     PointF pointAt(double t) const;
 
+    bool operator==(const Bezier& b) const
+    {
+        return m_x1 == b.m_x1 && m_y1 == b.m_y1 && m_x2 == b.m_x2 && m_y2 == b.m_y2
+               && m_x3 == b.m_x3 && m_y3 == b.m_y3 && m_x4 == b.m_x4 && m_y4 == b.m_y4;
+    }
+    bool operator!=(const Bezier& b) const { return !(*this == b); }
+
+    //! NOTE The points at t = i / segmentsCount, i = 1..segmentsCount (the start point is not included),
+    //! points must have room for segmentsCount items. The coordinates are evaluated together, in SIMD registers
+    void flatten(size_t segmentsCount, PointF* points) const;
+
+    //! NOTE The tight bounds, by the extrema of the curve (not by the control points)
+    RectF boundingRect() const;
+
 private:
     void parameterSplitLeft(double t, Bezier* left);
 
     friend class PainterPath;
 
-    double m_x1, m_y1, m_x2, m_y2, m_x3, m_y3, m_x4, m_y4;
+    double m_x1 = 0.0, m_y1 = 0.0, m_x2 = 0.0, m_y2 = 0.0, m_x3 = 0.0, m_y3 = 0.0, m_x4 = 0.0, m_y4 = 0.0;
 };
 }
 
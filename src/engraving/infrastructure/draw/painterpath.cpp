@@ -423,7 +423,7 @@ void PainterPath::computeBoundingRect() const
                                                 e,
                                                 m_elements.at(i+1),
                                                 m_elements.at(i+2));
-                RectF r = painterpathBezierExtrema(b);
+                RectF r = b.boundingRect();
                 double right = r.right();
                 double bottom = r.bottom();
                 if (r.x() < minx) {
@@ -654,94 +654,6 @@ static double angleForArc(double angle)
     return t;
 }
 
-#define BEZIER_A(bezier, coord) 3 * (-bezier.m_##coord##1 \
-+ 3*bezier.m_##coord##2 \
-- 3*bezier.m_##coord##3 \
-+bezier.m_##coord##4)
-#define BEZIER_B(bezier, coord) 6 * (bezier.m_##coord##1 \
-- 2*bezier.m_##coord##2 \
-+ bezier.m_##coord##3)
-#define BEZIER_C(bezier, coord) 3 * (- bezier.m_##coord##1 \
-+ bezier.m_##coord##2)
-
-#define BEZIER_CHECK_T(bezier, t) \
-    if (t >= 0 && t <= 1) { \
-        PointF p(b.pointAt(t)); \
-        if (p.x() < minx) minx = p.x(); \
-        else if (p.x() > maxx) maxx = p.x(); \
-        if (p.y() < miny) miny = p.y(); \
-        else if (p.y() > maxy) maxy = p.y(); \
-    }
-
-RectF PainterPath::painterpathBezierExtrema(const Bezier &b)
-{
-    double minx, miny, maxx, maxy;
-    // initialize with end points
-    if (b.m_x1 < b.m_x4) {
-        minx = b.m_x1;
-        maxx = b.m_x4;
-    } else {
-        minx = b.m_x4;
-        maxx = b.m_x1;
-    }
-    if (b.m_y1 < b.m_y4) {
-        miny = b.m_y1;
-        maxy = b.m_y4;
-    } else {
-        miny = b.m_y4;
-        maxy = b.m_y1;
-    }
-    // Update for the X extrema
-    {
-        double ax = BEZIER_A(b, x);
-        double bx = BEZIER_B(b, x);
-        double cx = BEZIER_C(b, x);
-        // specialcase quadratic curves to avoid div by zero
-        if (qFuzzyIsNull(ax)) {
-            // linear curves are covered by initialization.
-            if (!qFuzzyIsNull(bx)) {
-                double t = -cx / bx;
-                BEZIER_CHECK_T(b, t);
-            }
-        } else {
-            const double tx = bx * bx - 4 * ax * cx;
-            if (tx >= 0) {
-                double temp = std::sqrt(tx);
-                double rcp = 1 / (2 * ax);
-                double t1 = (-bx + temp) * rcp;
-                BEZIER_CHECK_T(b, t1);
-                double t2 = (-bx - temp) * rcp;
-                BEZIER_CHECK_T(b, t2);
-            }
-        }
-    }
-    // Update for the Y extrema
-    {
-        double ay = BEZIER_A(b, y);
-        double by = BEZIER_B(b, y);
-        double cy = BEZIER_C(b, y);
-        // specialcase quadratic curves to avoid div by zero
-        if (qFuzzyIsNull(ay)) {
-            // linear curves are covered by initialization.
-            if (!qFuzzyIsNull(by)) {
-                double t = -cy / by;
-                BEZIER_CHECK_T(b, t);
-            }
-        } else {
-            const double ty = by * by - 4 * ay * cy;
-            if (ty > 0) {
-                double temp = std::sqrt(ty);
-                double rcp = 1 / (2 * ay);
-                double t1 = (-by + temp) * rcp;
-                BEZIER_CHECK_T(b, t1);
-                double t2 = (-by - temp) * rcp;
-                BEZIER_CHECK_T(b, t2);
-            }
-        }
-    }
-    return RectF(minx, miny, maxx - minx, maxy - miny);
-}
-
 void PainterPath::setDirty()
 {
     m_dirtyBounds = true;
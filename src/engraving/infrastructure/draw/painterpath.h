@@ -161,8 +161,6 @@ private:
 
     static bool hasValidCoords(RectF r);
 
-    static RectF painterpathBezierExtrema(const Bezier& b);
-
     void setDirty();
 
     int m_cStart = 0;
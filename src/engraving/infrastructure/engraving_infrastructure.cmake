@@ -39,6 +39,8 @@ set (ENGRAVING_INFRASTRUCTURE_SRC
     ${CMAKE_CURRENT_LIST_DIR}/interactive/messagebox.cpp
     ${CMAKE_CURRENT_LIST_DIR}/interactive/messagebox.h
 
+    ${CMAKE_CURRENT_LIST_DIR}/io/binaryxml.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/io/binaryxml.h
     ${CMAKE_CURRENT_LIST_DIR}/io/mscio.h
     ${CMAKE_CURRENT_LIST_DIR}/io/mscreader.cpp
     ${CMAKE_CURRENT_LIST_DIR}/io/mscreader.h
@@ -145,3 +145,12 @@ Color EngravingConfiguration::highlightSelectionColor(int voice) const
 {
     return Color::fromQColor(selectionColor(voice).toQColor().lighter(135));
 }
+
+QString EngravingConfiguration::glyphMetricsCacheDir() const
+{
+    if (!globalConfiguration()) {
+        return QString();
+    }
+
+    return (globalConfiguration()->userAppDataPath() + "/fontcache").toQString();
+}
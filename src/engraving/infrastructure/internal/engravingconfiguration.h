@@ -24,10 +24,14 @@
 
 #include "../iengravingconfiguration.h"
 #include "async/asyncable.h"
+#include "modularity/ioc.h"
+#include "iglobalconfiguration.h"
 
 namespace mu::engraving {
 class EngravingConfiguration : public IEngravingConfiguration, public async::Asyncable
 {
+    INJECT(engraving, framework::IGlobalConfiguration, globalConfiguration)
+
 public:
     EngravingConfiguration() = default;
 
@@ -54,6 +58,8 @@ public:
 
     draw::Color highlightSelectionColor(int voice = 0) const override;
 
+    QString glyphMetricsCacheDir() const override;
+
 private:
     async::Channel<int, draw::Color> m_voiceColorChanged;
 };
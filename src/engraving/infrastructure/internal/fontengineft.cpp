@@ -21,8 +21,14 @@
  */
 #include "fontengineft.h"
 
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
 #include <QFile>
-#include <QHash>
+#include <QSaveFile>
+#include <QDir>
+#include <QCryptographicHash>
 
 #include "ft2build.h"
 #include FT_FREETYPE_H
@@ -47,17 +53,43 @@ static bool _init_ft()
     return error == 0;
 }
 
+//! NOTE Moved form sym.cpp ScoreFont::load as is
+static constexpr int PIXEL_SIZE = 200;
+
+static constexpr quint32 CACHE_MAGIC = 0x4d474653; // "SFGM"
+static constexpr quint32 CACHE_FORMAT_VERSION = 1;
+
+//! NOTE The glyph metrics are stored in the cache as is, so the layout is fixed
 struct mu::draw::FTGlyphMetrics
 {
-    FT_BBox bb;
-    double linearHoriAdvance = 0.0;
+    quint32 ucs4 = 0;
+    qint32 xMin = 0;
+    qint32 yMin = 0;
+    qint32 xMax = 0;
+    qint32 yMax = 0;
+    qint32 linearHoriAdvance = 0; // 16.16
 };
 
+static_assert(sizeof(FTGlyphMetrics) == 24, "the glyph metrics are mapped from the cache file");
+
+struct FTCacheHeader
+{
+    quint32 magic = CACHE_MAGIC;
+    quint32 formatVersion = CACHE_FORMAT_VERSION;
+    quint32 pixelSize = PIXEL_SIZE;
+    quint32 glyphCount = 0;
+    char fontKey[20] = {}; // sha1 of the font data
+};
+
+static_assert(sizeof(FTCacheHeader) % alignof(FTGlyphMetrics) == 0, "the glyph metrics follow the header");
+
 struct mu::draw::FTData
 {
-    QByteArray fontData;
-    FT_Face face = nullptr;
-    QHash<uint, FTGlyphMetrics> metrics;
+    //! NOTE Sorted by ucs4, either built on load or mapped from the cache file
+    std::vector<FTGlyphMetrics> metrics;
+    QFile cacheFile;
+    const FTGlyphMetrics* table = nullptr;
+    size_t count = 0;
 };
 
 FontEngineFT::FontEngineFT()
@@ -70,51 +102,175 @@ FontEngineFT::~FontEngineFT()
     delete m_data;
 }
 
-bool FontEngineFT::load(const QString& path)
+bool FontEngineFT::load(const QString& path, const QString& cacheDir)
 {
-    if (!_init_ft()) {
-        return false;
-    }
-
     QFile f(path);
     if (!f.open(QIODevice::ReadOnly)) {
         LOGE() << "failed open font: " << path;
         return false;
     }
 
-    m_data->fontData = f.readAll();
+    QByteArray fontData = f.readAll();
+
+    QString cachePath;
+    QByteArray fontKey;
+    if (!cacheDir.isEmpty()) {
+        fontKey = QCryptographicHash::hash(fontData, QCryptographicHash::Sha1);
+        cachePath = cacheDir + "/" + QString::fromLatin1(fontKey.toHex()) + ".glyphs";
+        if (mapCache(cachePath, fontKey)) {
+            return true;
+        }
+    }
+
+    if (!buildMetrics(fontData, path)) {
+        return false;
+    }
 
-    int rval = FT_New_Memory_Face(ftlib, (FT_Byte*)m_data->fontData.data(), m_data->fontData.size(), 0, &m_data->face);
+    if (!cachePath.isEmpty()) {
+        QDir().mkpath(cacheDir);
+        if (!writeCache(cachePath, fontKey)) {
+            LOGW() << "failed write glyph metrics cache: " << cachePath;
+        }
+    }
+
+    return true;
+}
+
+bool FontEngineFT::buildMetrics(const QByteArray& fontData, const QString& path)
+{
+    if (!_init_ft()) {
+        return false;
+    }
+
+    FT_Face face = nullptr;
+    int rval = FT_New_Memory_Face(ftlib, (const FT_Byte*)fontData.constData(), fontData.size(), 0, &face);
     if (rval) {
         LOGE() << "freetype: cannot create face: " << path << ", rval: " << rval;
         return false;
     }
 
-    //! NOTE Moved form sym.cpp ScoreFont::load as is
-    qreal pixelSize = 200.0;
-    FT_Set_Pixel_Sizes(m_data->face, 0, int(pixelSize + .5));
+    FT_Set_Pixel_Sizes(face, 0, PIXEL_SIZE);
+
+    //! NOTE All the glyphs of the charmap are loaded at once (a few thousands for the SMuFL fonts),
+    //! then the face is not needed anymore
+    std::vector<FTGlyphMetrics>& metrics = m_data->metrics;
+    metrics.clear();
+    metrics.reserve(face->num_glyphs);
+
+    FT_UInt index = 0;
+    FT_ULong ucs4 = FT_Get_First_Char(face, &index);
+    while (index != 0) {
+        FT_BBox bb;
+        if (FT_Load_Glyph(face, index, FT_LOAD_DEFAULT) == 0 && FT_Outline_Get_BBox(&face->glyph->outline, &bb) == 0) {
+            FTGlyphMetrics gm;
+            gm.ucs4 = quint32(ucs4);
+            gm.xMin = qint32(bb.xMin);
+            gm.yMin = qint32(bb.yMin);
+            gm.xMax = qint32(bb.xMax);
+            gm.yMax = qint32(bb.yMax);
+            gm.linearHoriAdvance = qint32(face->glyph->linearHoriAdvance);
+            metrics.push_back(gm);
+        }
+        ucs4 = FT_Get_Next_Char(face, ucs4, &index);
+    }
+
+    FT_Done_Face(face);
+
+    std::sort(metrics.begin(), metrics.end(), [](const FTGlyphMetrics& a, const FTGlyphMetrics& b) {
+        return a.ucs4 < b.ucs4;
+    });
+
+    m_data->table = metrics.data();
+    m_data->count = metrics.size();
+
+    return true;
+}
+
+bool FontEngineFT::mapCache(const QString& cachePath, const QByteArray& fontKey)
+{
+    QFile& f = m_data->cacheFile;
+    f.setFileName(cachePath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    //! NOTE The file stays open for the lifetime of the engine, the mapping is shared between the processes
+    const uchar* mapped = f.size() >= qint64(sizeof(FTCacheHeader)) ? f.map(0, f.size()) : nullptr;
+    if (!mapped) {
+        f.close();
+        return false;
+    }
+
+    const FTCacheHeader* header = reinterpret_cast<const FTCacheHeader*>(mapped);
+    bool valid = header->magic == CACHE_MAGIC
+                 && header->formatVersion == CACHE_FORMAT_VERSION
+                 && header->pixelSize == PIXEL_SIZE
+                 && QByteArray::fromRawData(header->fontKey, sizeof(header->fontKey)) == fontKey
+                 && f.size() == qint64(sizeof(FTCacheHeader) + header->glyphCount * sizeof(FTGlyphMetrics));
+
+    if (!valid) {
+        f.close();
+        return false;
+    }
+
+    m_data->table = reinterpret_cast<const FTGlyphMetrics*>(mapped + sizeof(FTCacheHeader));
+    m_data->count = header->glyphCount;
 
     return true;
 }
 
+bool FontEngineFT::writeCache(const QString& cachePath, const QByteArray& fontKey) const
+{
+    IF_ASSERT_FAILED(size_t(fontKey.size()) == sizeof(FTCacheHeader::fontKey)) {
+        return false;
+    }
+
+    FTCacheHeader header;
+    header.glyphCount = quint32(m_data->count);
+    memcpy(header.fontKey, fontKey.constData(), sizeof(header.fontKey));
+
+    QSaveFile f(cachePath);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    const qint64 tableSize = qint64(m_data->count * sizeof(FTGlyphMetrics));
+    if (f.write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))
+        || f.write(reinterpret_cast<const char*>(m_data->table), tableSize) != tableSize) {
+        f.cancelWriting();
+        return false;
+    }
+
+    return f.commit();
+}
+
+size_t FontEngineFT::glyphCount() const
+{
+    return m_data->count;
+}
+
+bool FontEngineFT::isLoadedFromCache() const
+{
+    return m_data->cacheFile.isOpen();
+}
+
 QRectF FontEngineFT::bbox(uint ucs4, qreal dpi_f) const
 {
-    FTGlyphMetrics* gm = glyphMetrics(ucs4);
+    const FTGlyphMetrics* gm = glyphMetrics(ucs4);
     if (!gm) {
         return QRectF();
     }
 
-    const FT_BBox& bb = gm->bb;
     //! NOTE Moved form sym.cpp ScoreFont::computeMetrics as is
     double m = 640.0 / dpi_f;
     QRectF bbox;
-    bbox.setCoords(bb.xMin / m, -bb.yMax / m, bb.xMax / m, -bb.yMin / m);
+    bbox.setCoords(gm->xMin / m, -gm->yMax / m, gm->xMax / m, -gm->yMin / m);
     return bbox;
 }
 
 qreal FontEngineFT::advance(uint ucs4, qreal dpi_f) const
 {
-    FTGlyphMetrics* gm = glyphMetrics(ucs4);
+    const FTGlyphMetrics* gm = glyphMetrics(ucs4);
     if (!gm) {
         return 0.0;
     }
@@ -123,29 +279,16 @@ qreal FontEngineFT::advance(uint ucs4, qreal dpi_f) const
     return gm->linearHoriAdvance * dpi_f / 655360.0;
 }
 
-FTGlyphMetrics* FontEngineFT::glyphMetrics(uint ucs4) const
+const FTGlyphMetrics* FontEngineFT::glyphMetrics(uint ucs4) const
 {
-    if (m_data->metrics.contains(ucs4)) {
-        return &m_data->metrics[ucs4];
-    }
-
-    FT_UInt index = FT_Get_Char_Index(m_data->face, ucs4);
-    if (index == 0) {
-        return nullptr;
-    }
+    const FTGlyphMetrics* begin = m_data->table;
+    const FTGlyphMetrics* end = begin + m_data->count;
+    const FTGlyphMetrics* it = std::lower_bound(begin, end, ucs4, [](const FTGlyphMetrics& gm, uint key) {
+        return gm.ucs4 < key;
+    });
 
-    if (FT_Load_Glyph(m_data->face, index, FT_LOAD_DEFAULT) != 0) {
+    if (it == end || it->ucs4 != ucs4) {
         return nullptr;
     }
-
-    FT_BBox bb;
-    if (FT_Outline_Get_BBox(&m_data->face->glyph->outline, &bb) != 0) {
-        return nullptr;
-    }
-
-    FTGlyphMetrics& gm = m_data->metrics[ucs4];
-    gm.bb = bb;
-    gm.linearHoriAdvance = m_data->face->glyph->linearHoriAdvance;
-
-    return &gm;
+    return it;
 }
@@ -34,14 +34,24 @@ public:
     FontEngineFT();
     ~FontEngineFT();
 
-    bool load(const QString& path);
+    //! NOTE The metrics of all the glyphs of the font are built on load (or mapped from the cache in cacheDir,
+    //! if there is one for this font data) and are not changed after that,
+    //! so bbox and advance can be called from any thread without locking
+    bool load(const QString& path, const QString& cacheDir = QString());
 
     QRectF bbox(uint ucs4, qreal DPI_F) const;
     qreal advance(uint ucs4, qreal DPI_F) const;
 
+    size_t glyphCount() const;
+    bool isLoadedFromCache() const;
+
 private:
 
-    FTGlyphMetrics* glyphMetrics(uint ucs4) const;
+    const FTGlyphMetrics* glyphMetrics(uint ucs4) const;
+
+    bool buildMetrics(const QByteArray& fontData, const QString& path);
+    bool mapCache(const QString& cachePath, const QByteArray& fontKey);
+    bool writeCache(const QString& cachePath, const QByteArray& fontKey) const;
 
     FTData* m_data = nullptr;
 };
@@ -154,10 +154,13 @@ FontEngineFT* QFontProvider::symEngine(const Font& f) const
         return nullptr;
     }
 
+    std::lock_guard<std::mutex> lock(m_symEnginesMutex);
+
     FontEngineFT* engine = m_symEngines.value(path, nullptr);
     if (!engine) {
+        QString cacheDir = engravingConfiguration() ? engravingConfiguration()->glyphMetricsCacheDir() : QString();
         engine = new FontEngineFT();
-        if (!engine->load(path)) {
+        if (!engine->load(path, cacheDir)) {
             delete engine;
             return nullptr;
         }
@@ -22,13 +22,19 @@
 #ifndef MU_DRAW_QFONTPROVIDER_H
 #define MU_DRAW_QFONTPROVIDER_H
 
+#include <mutex>
 #include <QHash>
+
+#include "modularity/ioc.h"
 #include "infrastructure/draw/ifontprovider.h"
+#include "iengravingconfiguration.h"
 
 namespace mu::draw {
 class FontEngineFT;
 class QFontProvider : public IFontProvider
 {
+    INJECT(engraving, engraving::IEngravingConfiguration, engravingConfiguration)
+
 public:
     QFontProvider() = default;
 
@@ -62,7 +68,10 @@ private:
     FontEngineFT* symEngine(const Font& f) const;
 
     QHash<QString /*family*/, QString /*path*/> m_paths;
+    //! NOTE The engines are created on demand from the layout and export threads,
+    //! once created they are read only
     mutable QHash<QString /*path*/, FontEngineFT*> m_symEngines;
+    mutable std::mutex m_symEnginesMutex;
 };
 }
 
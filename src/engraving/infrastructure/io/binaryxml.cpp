@@ -0,0 +1,581 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "binaryxml.h"
+
+#include <QHash>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+#include "log.h"
+
+namespace Ms {
+static const char MAGIC[4] = { 'M', 'S', 'C', 'B' };
+
+static void putVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char(value | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+template<typename T>
+static void putFixed(QByteArray& out, T value)
+{
+    char buf[sizeof(T)];
+    qToLittleEndian(value, buf);
+    out.append(buf, sizeof(T));
+}
+
+static quint64 zigzag(qint64 v)
+{
+    return (quint64(v) << 1) ^ quint64(v >> 63);
+}
+
+static qint64 unzigzag(quint64 v)
+{
+    return qint64(v >> 1) ^ -qint64(v & 1);
+}
+
+//---------------------------------------------------------
+//   isBinary
+//---------------------------------------------------------
+
+bool BinaryXml::isBinary(const QByteArray& data)
+{
+    return data.size() >= HEADER_SIZE && std::memcmp(data.constData(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool BinaryXml::isBinary(QIODevice* device)
+{
+    if (!device || !device->isOpen() || !device->isReadable()) {
+        return false;
+    }
+    return device->peek(sizeof(MAGIC)) == QByteArray(MAGIC, sizeof(MAGIC));
+}
+
+//---------------------------------------------------------
+//   checksum
+//    FNV-1a, enough to detect that the source was changed
+//---------------------------------------------------------
+
+quint64 BinaryXml::checksum(const QByteArray& data)
+{
+    quint64 h = 0xcbf29ce484222325ull;
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    const uchar* end = p + data.size();
+    for (; p != end; ++p) {
+        h = (h ^ *p) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+//---------------------------------------------------------
+//   isSnapshotOf
+//---------------------------------------------------------
+
+bool BinaryXml::isSnapshotOf(const QByteArray& snapshot, const QByteArray& xml)
+{
+    if (!isBinary(snapshot) || xml.isEmpty()) {
+        return false;
+    }
+    const char* h = snapshot.constData();
+    if (qFromLittleEndian<quint16>(h + 4) != VERSION) {
+        return false;
+    }
+    if (qFromLittleEndian<quint64>(h + 8) != quint64(xml.size())) {
+        return false;
+    }
+    return qFromLittleEndian<quint64>(h + 16) == checksum(xml);
+}
+
+//---------------------------------------------------------
+//   encode
+//---------------------------------------------------------
+
+QByteArray BinaryXml::encode(const QByteArray& xml)
+{
+    QXmlStreamReader reader(xml);
+
+    QHash<QString, int> index;
+    std::vector<QString> strings;
+    auto intern = [&index, &strings](const QString& s) {
+        auto it = index.constFind(s);
+        if (it != index.constEnd()) {
+            return it.value();
+        }
+        int i = int(strings.size());
+        index.insert(s, i);
+        strings.push_back(s);
+        return i;
+    };
+
+    QByteArray tokens;
+    tokens.reserve(xml.size() / 3);
+
+    // the adjacent texts are joined, the texts outside of the root element are not needed
+    QString text;
+    int depth = 0;
+    auto putText = [&]() {
+        if (text.isEmpty()) {
+            return;
+        }
+        if (depth > 0) {
+            bool ok = false;
+            if (text.size() <= 11) {
+                int v = text.toInt(&ok);
+                if (ok && QString::number(v) == text) {
+                    tokens.append(char(Int));
+                    putVarint(tokens, zigzag(v));
+                    text.clear();
+                    return;
+                }
+            }
+            if (text.size() <= 24) {
+                double v = text.toDouble(&ok);
+                if (ok && std::isfinite(v) && QString::number(v) == text) {
+                    quint64 bits;
+                    std::memcpy(&bits, &v, sizeof(bits));
+                    tokens.append(char(Double));
+                    putFixed(tokens, bits);
+                    text.clear();
+                    return;
+                }
+            }
+            tokens.append(char(Text));
+            putVarint(tokens, intern(text));
+        }
+        text.clear();
+    };
+
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement: {
+            putText();
+            tokens.append(char(StartElement));
+            putVarint(tokens, intern(reader.name().toString()));
+            const QXmlStreamAttributes attributes = reader.attributes();
+            putVarint(tokens, attributes.size());
+            for (const QXmlStreamAttribute& a : attributes) {
+                putVarint(tokens, intern(a.name().toString()));
+                putVarint(tokens, intern(a.value().toString()));
+            }
+            ++depth;
+            break;
+        }
+        case QXmlStreamReader::EndElement:
+            putText();
+            tokens.append(char(EndElement));
+            --depth;
+            break;
+        case QXmlStreamReader::Characters:
+            text += reader.text();
+            break;
+        default:
+            // comments and processing instructions are not needed for reading
+            break;
+        }
+    }
+
+    if (reader.hasError()) {
+        LOGE() << "failed encode, line: " << reader.lineNumber() << ", error: " << reader.errorString();
+        return QByteArray();
+    }
+
+    tokens.append(char(EndDocument));
+
+    QByteArray out;
+    out.reserve(HEADER_SIZE + tokens.size() + xml.size() / 8);
+    out.append(MAGIC, sizeof(MAGIC));
+    putFixed<quint16>(out, VERSION);
+    putFixed<quint16>(out, 0);
+    putFixed<quint64>(out, xml.size());
+    putFixed<quint64>(out, checksum(xml));
+
+    putVarint(out, strings.size());
+    for (const QString& s : strings) {
+        QByteArray utf8 = s.toUtf8();
+        putVarint(out, utf8.size());
+        out.append(utf8);
+    }
+    out.append(tokens);
+
+    return out;
+}
+
+//---------------------------------------------------------
+//   BinaryXmlReader
+//---------------------------------------------------------
+
+BinaryXmlReader::BinaryXmlReader(const QByteArray& data)
+    : m_data(data)
+{
+    m_begin = reinterpret_cast<const uchar*>(m_data.constData());
+    m_pos = m_begin;
+    m_end = m_begin + m_data.size();
+
+    if (!readHeader()) {
+        raiseError("Not a score snapshot or the version is not supported.", QXmlStreamReader::NotWellFormedError);
+    }
+}
+
+bool BinaryXmlReader::readHeader()
+{
+    if (!BinaryXml::isBinary(m_data)) {
+        return false;
+    }
+    if (qFromLittleEndian<quint16>(m_begin + 4) != BinaryXml::VERSION) {
+        return false;
+    }
+    m_pos = m_begin + BinaryXml::HEADER_SIZE;
+
+    quint64 count = 0;
+    if (!readVarint(count) || count > quint64(m_end - m_pos)) {
+        return false;
+    }
+    m_strings.reserve(count);
+    for (quint64 i = 0; i < count; ++i) {
+        quint64 size = 0;
+        if (!readVarint(size) || size > quint64(m_end - m_pos)) {
+            return false;
+        }
+        m_strings.push_back(QString::fromUtf8(reinterpret_cast<const char*>(m_pos), int(size)));
+        m_pos += size;
+    }
+    return true;
+}
+
+bool BinaryXmlReader::readVarint(quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && m_pos != m_end; shift += 7) {
+        uchar b = *m_pos++;
+        value |= quint64(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BinaryXmlReader::readString(int& index)
+{
+    quint64 v = 0;
+    if (!readVarint(v) || v >= m_strings.size()) {
+        return false;
+    }
+    index = int(v);
+    return true;
+}
+
+//---------------------------------------------------------
+//   readNext
+//---------------------------------------------------------
+
+BinaryXmlReader::TokenType BinaryXmlReader::readNext()
+{
+    if (m_error != QXmlStreamReader::NoError || m_atEnd) {
+        m_type = QXmlStreamReader::Invalid;
+        return m_type;
+    }
+    if (m_type == QXmlStreamReader::NoToken) {
+        m_type = QXmlStreamReader::StartDocument;
+        return m_type;
+    }
+    if (m_type == QXmlStreamReader::EndDocument) {
+        m_atEnd = true;
+        m_type = QXmlStreamReader::Invalid;
+        return m_type;
+    }
+    if (m_type == QXmlStreamReader::EndElement) {
+        m_elements.pop_back();
+    }
+
+    if (m_pos == m_end) {
+        raiseError("Premature end of document.", QXmlStreamReader::PrematureEndOfDocumentError);
+        return m_type;
+    }
+
+    ++m_tokenNumber;
+    bool ok = true;
+    BinaryXml::Op op = BinaryXml::Op(*m_pos++);
+    switch (op) {
+    case BinaryXml::StartElement: {
+        quint64 count = 0;
+        ok = readString(m_name) && readVarint(count) && count <= quint64(m_end - m_pos);
+        m_attributes.clear();
+        for (quint64 i = 0; ok && i < count; ++i) {
+            int name = -1;
+            int value = -1;
+            ok = readString(name) && readString(value);
+            if (ok) {
+                m_attributes.append(m_strings[name], m_strings[value]);
+            }
+        }
+        m_elements.push_back(m_name);
+        m_type = QXmlStreamReader::StartElement;
+        break;
+    }
+    case BinaryXml::EndElement:
+        ok = !m_elements.empty();
+        if (ok) {
+            m_name = m_elements.back();
+        }
+        m_type = QXmlStreamReader::EndElement;
+        break;
+    case BinaryXml::Text:
+        m_textOp = op;
+        ok = readString(m_textIndex);
+        m_type = QXmlStreamReader::Characters;
+        break;
+    case BinaryXml::Int:
+        m_textOp = op;
+        ok = readVarint(m_number);
+        m_numberText.clear();
+        m_type = QXmlStreamReader::Characters;
+        break;
+    case BinaryXml::Double:
+        m_textOp = op;
+        ok = m_end - m_pos >= 8;
+        if (ok) {
+            m_number = qFromLittleEndian<quint64>(m_pos);
+            m_pos += 8;
+        }
+        m_numberText.clear();
+        m_type = QXmlStreamReader::Characters;
+        break;
+    case BinaryXml::EndDocument:
+        ok = m_elements.empty();
+        m_type = QXmlStreamReader::EndDocument;
+        break;
+    default:
+        ok = false;
+        break;
+    }
+
+    if (!ok) {
+        raiseError("The score snapshot is corrupted.", QXmlStreamReader::NotWellFormedError);
+    }
+    return m_type;
+}
+
+//---------------------------------------------------------
+//   readNextStartElement
+//---------------------------------------------------------
+
+bool BinaryXmlReader::readNextStartElement()
+{
+    while (readNext() != QXmlStreamReader::Invalid) {
+        if (m_type == QXmlStreamReader::EndElement) {
+            return false;
+        } else if (m_type == QXmlStreamReader::StartElement) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------
+//   skipCurrentElement
+//---------------------------------------------------------
+
+void BinaryXmlReader::skipCurrentElement()
+{
+    int depth = 1;
+    while (depth && readNext() != QXmlStreamReader::Invalid) {
+        if (m_type == QXmlStreamReader::EndElement) {
+            --depth;
+        } else if (m_type == QXmlStreamReader::StartElement) {
+            ++depth;
+        }
+    }
+}
+
+//---------------------------------------------------------
+//   readElementText
+//---------------------------------------------------------
+
+QString BinaryXmlReader::readElementText()
+{
+    if (m_type != QXmlStreamReader::StartElement) {
+        return QString();
+    }
+
+    QString result;
+    for (;;) {
+        switch (readNext()) {
+        case QXmlStreamReader::Characters:
+            if (m_textOp == BinaryXml::Text) {
+                result += m_strings[m_textIndex];
+            } else {
+                result += text();
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            return result;
+        case QXmlStreamReader::StartElement:
+            raiseError("Expected character data.", QXmlStreamReader::NotWellFormedError);
+            return result;
+        default:
+            if (m_error == QXmlStreamReader::NoError) {
+                raiseError("Unexpected element.", QXmlStreamReader::NotWellFormedError);
+            }
+            return result;
+        }
+    }
+}
+
+//---------------------------------------------------------
+//   peekNumberElement
+//    the current element contains only the number
+//---------------------------------------------------------
+
+bool BinaryXmlReader::peekNumberElement(BinaryXml::Op op, quint64& value)
+{
+    if (m_type != QXmlStreamReader::StartElement || m_pos == m_end || *m_pos != op) {
+        return false;
+    }
+
+    const uchar* pos = m_pos;
+    ++m_pos;
+    bool ok = false;
+    if (op == BinaryXml::Int) {
+        ok = readVarint(value);
+    } else if (m_end - m_pos >= 8) {
+        value = qFromLittleEndian<quint64>(m_pos);
+        m_pos += 8;
+        ok = true;
+    }
+    if (!ok || m_pos == m_end || *m_pos != BinaryXml::EndElement) {
+        m_pos = pos;
+        return false;
+    }
+
+    ++m_tokenNumber;
+    readNext();
+    return true;
+}
+
+int BinaryXmlReader::readInt()
+{
+    quint64 v = 0;
+    if (peekNumberElement(BinaryXml::Int, v)) {
+        return int(unzigzag(v));
+    }
+    return readElementText().toInt();
+}
+
+double BinaryXmlReader::readDouble()
+{
+    quint64 v = 0;
+    if (peekNumberElement(BinaryXml::Double, v)) {
+        double d;
+        std::memcpy(&d, &v, sizeof(d));
+        return d;
+    }
+    if (peekNumberElement(BinaryXml::Int, v)) {
+        return double(unzigzag(v));
+    }
+    return readElementText().toDouble();
+}
+
+//---------------------------------------------------------
+//   name
+//---------------------------------------------------------
+
+QStringRef BinaryXmlReader::name() const
+{
+    if (m_type == QXmlStreamReader::StartElement || m_type == QXmlStreamReader::EndElement) {
+        return QStringRef(&m_strings[m_name]);
+    }
+    return QStringRef();
+}
+
+//---------------------------------------------------------
+//   text
+//---------------------------------------------------------
+
+QStringRef BinaryXmlReader::text() const
+{
+    if (m_type != QXmlStreamReader::Characters) {
+        return QStringRef();
+    }
+    switch (m_textOp) {
+    case BinaryXml::Int:
+        if (m_numberText.isEmpty()) {
+            m_numberText = QString::number(unzigzag(m_number));
+        }
+        return QStringRef(&m_numberText);
+    case BinaryXml::Double:
+        if (m_numberText.isEmpty()) {
+            double d;
+            std::memcpy(&d, &m_number, sizeof(d));
+            m_numberText = QString::number(d);
+        }
+        return QStringRef(&m_numberText);
+    default:
+        break;
+    }
+    return QStringRef(&m_strings[m_textIndex]);
+}
+
+bool BinaryXmlReader::isWhitespace() const
+{
+    if (m_type != QXmlStreamReader::Characters || m_textOp != BinaryXml::Text) {
+        return false;
+    }
+    for (const QChar& c : m_strings[m_textIndex]) {
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------
+//   tokenString
+//---------------------------------------------------------
+
+QString BinaryXmlReader::tokenString() const
+{
+    static const char* const names[] = {
+        "NoToken", "Invalid", "StartDocument", "EndDocument", "StartElement", "EndElement",
+        "Characters", "Comment", "DTD", "EntityReference", "ProcessingInstruction"
+    };
+    return QString::fromLatin1(names[m_type]);
+}
+
+//---------------------------------------------------------
+//   raiseError
+//---------------------------------------------------------
+
+void BinaryXmlReader::raiseError(const QString& message, QXmlStreamReader::Error error)
+{
+    m_error = error;
+    m_errorString = message;
+    m_type = QXmlStreamReader::Invalid;
+}
+}
@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_ENGRAVING_BINARYXML_H
+#define MU_ENGRAVING_BINARYXML_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QXmlStreamReader>
+
+#include <vector>
+
+namespace Ms {
+//---------------------------------------------------------
+//   BinaryXml
+//    compact binary snapshot of a score file (.mscx)
+//---------------------------------------------------------
+
+//! NOTE The snapshot is the token stream of the xml document: the element and attribute names,
+//! the attribute values and the texts are stored once in a string table and referred by index,
+//! the texts which are integer or floating point numbers (as written by XmlWriter) are stored as numbers.
+//! XmlReader reads it transparently, so the score is read by the same code for both forms.
+//! The header keeps the size and the checksum of the source, so the snapshot can be used
+//! as a cache for the source (see MscWriter::Params::writeScoreSnapshot)
+//!
+//! Layout (integers are little endian):
+//!     "MSCB" version:u16 flags:u16 sourceSize:u64 sourceChecksum:u64
+//!     stringCount:varint { size:varint utf8 }...
+//!     tokens: StartElement name:varint attributesCount:varint { name:varint value:varint }...
+//!             EndElement
+//!             Text string:varint | Int zigzag:varint | Double ieee754:u64
+//!             EndDocument
+class BinaryXml
+{
+public:
+    static constexpr quint16 VERSION = 1;
+
+    enum Op : char {
+        EndDocument = 0,
+        StartElement,
+        EndElement,
+        Text,
+        Int,
+        Double
+    };
+
+    static bool isBinary(const QByteArray& data);
+    static bool isBinary(QIODevice* device);
+
+    //! returns an empty array if the source is not a well formed xml document
+    static QByteArray encode(const QByteArray& xml);
+
+    //! the snapshot was made from this source and can be read by this version
+    static bool isSnapshotOf(const QByteArray& snapshot, const QByteArray& xml);
+
+    static quint64 checksum(const QByteArray& data);
+
+    static const int HEADER_SIZE = 24;
+};
+
+//---------------------------------------------------------
+//   BinaryXmlReader
+//    reads the snapshot with the semantic of the QXmlStreamReader api
+//---------------------------------------------------------
+
+class BinaryXmlReader
+{
+public:
+    using TokenType = QXmlStreamReader::TokenType;
+
+    explicit BinaryXmlReader(const QByteArray& data);
+
+    TokenType readNext();
+    bool readNextStartElement();
+    void skipCurrentElement();
+    QString readElementText();
+
+    //! fast paths for the element texts stored as numbers, the same as readElementText().toInt() / toDouble()
+    int readInt();
+    double readDouble();
+
+    TokenType tokenType() const { return m_type; }
+    QString tokenString() const;
+    QStringRef name() const;
+    QXmlStreamAttributes attributes() const { return m_type == QXmlStreamReader::StartElement ? m_attributes : QXmlStreamAttributes(); }
+    QStringRef text() const;
+    bool isWhitespace() const;
+
+    bool atEnd() const { return m_atEnd || m_error != QXmlStreamReader::NoError; }
+    QXmlStreamReader::Error error() const { return m_error; }
+    QString errorString() const { return m_errorString; }
+    void raiseError(const QString& message, QXmlStreamReader::Error error = QXmlStreamReader::CustomError);
+
+    //! there are no lines in the snapshot, the number of the token is reported instead
+    qint64 lineNumber() const { return m_tokenNumber; }
+    qint64 columnNumber() const { return 0; }
+
+private:
+    bool readVarint(quint64& value);
+    bool readString(int& index);
+    bool readHeader();
+    bool peekNumberElement(BinaryXml::Op op, quint64& value);
+
+    QByteArray m_data;
+    const uchar* m_begin = nullptr;
+    const uchar* m_pos = nullptr;
+    const uchar* m_end = nullptr;
+
+    std::vector<QString> m_strings;
+    std::vector<int> m_elements;        // names of the open elements
+
+    TokenType m_type = QXmlStreamReader::NoToken;
+    int m_name = -1;
+    QXmlStreamAttributes m_attributes;
+    BinaryXml::Op m_textOp = BinaryXml::Text;
+    int m_textIndex = -1;
+    quint64 m_number = 0;
+    mutable QString m_numberText;       // the text of the number, created on demand
+
+    bool m_atEnd = false;
+    QXmlStreamReader::Error m_error = QXmlStreamReader::NoError;
+    QString m_errorString;
+    qint64 m_tokenNumber = 0;
+};
+}
+
+#endif // MU_ENGRAVING_BINARYXML_H
@@ -135,6 +135,15 @@ QByteArray MscReader::readScoreFile() const
     return fileData(mscxFileName);
 }
 
+QByteArray MscReader::readScoreSnapshotFile() const
+{
+    static const QString SNAPSHOT_FILE_NAME("score_snapshot.mscb");
+    if (!reader()->isContainer() || !reader()->fileList().contains(SNAPSHOT_FILE_NAME)) {
+        return QByteArray();
+    }
+    return fileData(SNAPSHOT_FILE_NAME);
+}
+
 std::vector<QString> MscReader::excerptNames() const
 {
     if (!reader()->isContainer()) {
@@ -56,6 +56,8 @@ public:
 
     QByteArray readStyleFile() const;
     QByteArray readScoreFile() const;
+    //! NOTE Returns empty data if there is no snapshot, it also may be out of date (see BinaryXml::isSnapshotOf)
+    QByteArray readScoreSnapshotFile() const;
 
     std::vector<QString> excerptNames() const;
     QByteArray readExcerptStyleFile(const QString& name) const;
@@ -27,9 +27,14 @@
 #include <QDir>
 #include <QBuffer>
 #include <QTextStream>
+#include <QThreadPool>
+
+#include <future>
 
 #include "thirdparty/qzip/qzipwriter_p.h"
 
+#include "binaryxml.h"
+
 #include "log.h"
 
 using namespace mu::engraving;
@@ -90,7 +95,7 @@ MscWriter::IWriter* MscWriter::writer() const
     if (!m_writer) {
         switch (m_params.mode) {
         case MscIoMode::Zip:
-            m_writer = new ZipWriter();
+            m_writer = new ZipWriter(m_params.fastCompression);
             break;
         case MscIoMode::Dir:
             m_writer = new DirWriter();
@@ -132,6 +137,14 @@ void MscWriter::writeScoreFile(const QByteArray& data)
     }
     QString fileName = completeBaseName + ".mscx";
     addFileData(fileName, data);
+
+    //! NOTE The snapshot is binary, so it is not written to the xml file
+    if (m_params.writeScoreSnapshot && m_params.mode != MscIoMode::XmlFile) {
+        QByteArray snapshot = Ms::BinaryXml::encode(data);
+        if (!snapshot.isEmpty()) {
+            addFileData("score_snapshot.mscb", snapshot);
+        }
+    }
 }
 
 void MscWriter::addExcerptStyleFile(const QString& name, const QByteArray& data)
@@ -224,6 +237,24 @@ void MscWriter::Meta::addFile(const QString& file)
 // Writers
 // =======================================================================
 
+//! NOTE Already compressed, are stored as is
+static bool isCompressedFormat(const QString& fileName)
+{
+    static const QStringList COMPRESSED_SUFFIXES = { "png", "jpg", "jpeg", "gif", "ogg", "mp3", "flac" };
+    return COMPRESSED_SUFFIXES.contains(QFileInfo(fileName).suffix().toLower());
+}
+
+struct MscWriter::ZipWriter::PendingFile
+{
+    QString fileName;
+    std::future<MQZipWriter::PreparedFile> file;
+};
+
+MscWriter::ZipWriter::ZipWriter(bool fastCompression)
+    : m_compressionLevel(fastCompression ? 1 : -1)
+{
+}
+
 MscWriter::ZipWriter::~ZipWriter()
 {
     delete m_zip;
@@ -254,7 +285,10 @@ bool MscWriter::ZipWriter::open(QIODevice* device, const QString& filePath)
 
 void MscWriter::ZipWriter::close()
 {
+    TRACEFUNC;
+
     if (m_zip) {
+        addReadyFiles(true);
         m_zip->close();
     }
 
@@ -274,12 +308,47 @@ bool MscWriter::ZipWriter::addFileData(const QString& fileName, const QByteArray
         return false;
     }
 
-    m_zip->addFile(fileName, data);
-    if (m_zip->status() != MQZipWriter::NoError) {
-        LOGE() << "failed write files to zip, status: " << m_zip->status();
-        return false;
+    MQZipWriter::CompressionPolicy policy = isCompressedFormat(fileName) ? MQZipWriter::NeverCompress : MQZipWriter::AlwaysCompress;
+    int level = m_compressionLevel;
+
+    auto promise = std::make_shared<std::promise<MQZipWriter::PreparedFile> >();
+    auto prepare = [promise, data, policy, level]() {
+        TRACEFUNC_C("MscWriter::ZipWriter prepare file");
+        promise->set_value(MQZipWriter::prepareFile(data, policy, level));
+    };
+
+    PendingFile pending;
+    pending.fileName = fileName;
+    pending.file = promise->get_future();
+    m_pendingFiles.push_back(std::move(pending));
+
+    //! NOTE If there is no free thread, the file is compressed right here, so the writer never waits for a busy pool
+    if (policy == MQZipWriter::NeverCompress || !QThreadPool::globalInstance()->tryStart(prepare)) {
+        prepare();
     }
-    return true;
+
+    return addReadyFiles(false);
+}
+
+bool MscWriter::ZipWriter::addReadyFiles(bool wait)
+{
+    bool ok = true;
+    while (!m_pendingFiles.empty()) {
+        PendingFile& pending = m_pendingFiles.front();
+        if (!wait && pending.file.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            break;
+        }
+
+        MQZipWriter::PreparedFile file = pending.file.get();
+        m_zip->addPreparedFile(pending.fileName, file);
+        if (!file.ok || m_zip->status() != MQZipWriter::NoError) {
+            LOGE() << "failed write file to zip: " << pending.fileName << ", status: " << m_zip->status();
+            ok = false;
+        }
+
+        m_pendingFiles.pop_front();
+    }
+    return ok;
 }
 
 bool MscWriter::DirWriter::open(QIODevice* device, const QString& filePath)
@@ -26,6 +26,8 @@
 #include <QByteArray>
 #include <QIODevice>
 
+#include <list>
+
 #include "mscio.h"
 
 class MQZipWriter;
@@ -41,6 +43,11 @@ public:
         QIODevice* device = nullptr;
         QString filePath;
         MscIoMode mode = MscIoMode::Zip;
+        //! NOTE Write the binary snapshot of the score file next to it, to reload the score faster (see BinaryXml).
+        //! Opt-in: no save or export path sets it yet, only the tests do
+        bool writeScoreSnapshot = false;
+        //! NOTE Faster but a bit bigger, e.g. for the autosave
+        bool fastCompression = false;
     };
 
     MscWriter() = default;
@@ -75,8 +82,11 @@ private:
         virtual bool addFileData(const QString& fileName, const QByteArray& data) = 0;
     };
 
+    //! NOTE The files are compressed in parallel (in the global thread pool)
+    //! and are added to the archive in the order of writing, as soon as they are ready
     struct ZipWriter : public IWriter
     {
+        ZipWriter(bool fastCompression);
         ~ZipWriter() override;
         bool open(QIODevice* device, const QString& filePath) override;
         void close() override;
@@ -84,9 +94,15 @@ private:
         bool addFileData(const QString& fileName, const QByteArray& data) override;
 
     private:
+        struct PendingFile;
+
+        bool addReadyFiles(bool wait);
+
         QIODevice* m_device = nullptr;
         bool m_selfDeviceOwner = false;
         MQZipWriter* m_zip = nullptr;
+        int m_compressionLevel = -1;
+        std::list<PendingFile> m_pendingFiles;
     };
 
     struct DirWriter : public IWriter
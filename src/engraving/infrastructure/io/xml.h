@@ -28,7 +28,12 @@
 #include <QTextStream>
 #include <QFile>
 
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 #include "infrastructure/draw/color.h"
+#include "binaryxml.h"
 #include "libmscore/connector.h"
 #include "libmscore/stafftype.h"
 #include "libmscore/interval.h"
@@ -119,13 +124,13 @@ class XmlReader : public QXmlStreamReader
 
     qint64 _offsetLines { 0 };
 
+    //! NOTE Set when reading a score snapshot (see BinaryXml)
+    std::unique_ptr<BinaryXmlReader> _binary;
+
 public:
-    XmlReader(QFile* f)
-        : QXmlStreamReader(f), docName(f->fileName()) {}
-    XmlReader(const QByteArray& d, const QString& st = QString())
-        : QXmlStreamReader(d), docName(st) {}
-    XmlReader(QIODevice* d, const QString& st = QString())
-        : QXmlStreamReader(d), docName(st) {}
+    XmlReader(QFile* f);
+    XmlReader(const QByteArray& d, const QString& st = QString());
+    XmlReader(QIODevice* d, const QString& st = QString());
     XmlReader(const QString& d, const QString& st = QString())
         : QXmlStreamReader(d), docName(st) {}
     XmlReader(const XmlReader&) = delete;
@@ -135,6 +140,33 @@ public:
     bool hasAccidental { false };                       // used for userAccidental backward compatibility
     void unknown();
 
+    bool isBinary() const { return _binary != nullptr; }
+
+    // the QXmlStreamReader api used by the read code, hidden to read the score snapshots too.
+    // These are not virtual: the read code only ever takes an XmlReader&, never a QXmlStreamReader&,
+    // so these are the ones called. Do not pass an XmlReader as a QXmlStreamReader: that skips the snapshot.
+    // The other base methods (clear, addData, device...) are only used on text readers, like the palette one.
+    TokenType readNext() { return _binary ? _binary->readNext() : QXmlStreamReader::readNext(); }
+    bool readNextStartElement() { return _binary ? _binary->readNextStartElement() : QXmlStreamReader::readNextStartElement(); }
+    void skipCurrentElement();
+    QString readElementText() { return _binary ? _binary->readElementText() : QXmlStreamReader::readElementText(); }
+    TokenType tokenType() const { return _binary ? _binary->tokenType() : QXmlStreamReader::tokenType(); }
+    QString tokenString() const { return _binary ? _binary->tokenString() : QXmlStreamReader::tokenString(); }
+    bool isStartElement() const { return tokenType() == StartElement; }
+    bool isEndElement() const { return tokenType() == EndElement; }
+    bool isCharacters() const { return tokenType() == Characters; }
+    bool isWhitespace() const { return _binary ? _binary->isWhitespace() : QXmlStreamReader::isWhitespace(); }
+    QStringRef name() const { return _binary ? _binary->name() : QXmlStreamReader::name(); }
+    QXmlStreamAttributes attributes() const { return _binary ? _binary->attributes() : QXmlStreamReader::attributes(); }
+    QStringRef text() const { return _binary ? _binary->text() : QXmlStreamReader::text(); }
+    bool atEnd() const { return _binary ? _binary->atEnd() : QXmlStreamReader::atEnd(); }
+    Error error() const { return _binary ? _binary->error() : QXmlStreamReader::error(); }
+    bool hasError() const { return error() != NoError; }
+    QString errorString() const { return _binary ? _binary->errorString() : QXmlStreamReader::errorString(); }
+    void raiseError(const QString& message = QString());
+    qint64 lineNumber() const { return _binary ? _binary->lineNumber() : QXmlStreamReader::lineNumber(); }
+    qint64 columnNumber() const { return _binary ? _binary->columnNumber() : QXmlStreamReader::columnNumber(); }
+
     // attribute helper routines:
     QString attribute(const char* s) const { return attributes().value(s).toString(); }
     QString attribute(const char* s, const QString&) const;
@@ -145,10 +177,10 @@ public:
     bool hasAttribute(const char* s) const;
 
     // helper routines based on readElementText():
-    int readInt() { return readElementText().toInt(); }
+    int readInt() { return _binary ? _binary->readInt() : readElementText().toInt(); }
     int readInt(bool* ok) { return readElementText().toInt(ok); }
     int readIntHex() { return readElementText().toInt(0, 16); }
-    double readDouble() { return readElementText().toDouble(); }
+    double readDouble() { return _binary ? _binary->readDouble() : readElementText().toDouble(); }
     qlonglong readLongLong() { return readElementText().toLongLong(); }
 
     double readDouble(double min, double max);
@@ -238,11 +270,16 @@ public:
 class XmlWriter : public QTextStream
 {
     static const int BS = 2048;
+    static const int FLUSH_SIZE = 64 * 1024;
 
     Score* _score;
-    QList<QString> stack;
+    std::vector<QByteArray> stack;
     SelectionFilter _filter;
 
+    //! NOTE The output is collected as UTF-8 and written to the device in big chunks,
+    //! the QTextStream is used only to write it out (and by dump())
+    QByteArray _buffer;
+
     Fraction _curTick    { 0, 1 };       // used to optimize output
     Fraction _tickDiff   { 0, 1 };
     int _curTrack        { -1 };
@@ -261,10 +298,24 @@ class XmlWriter : public QTextStream
     bool _recordElements = false;
 
     void putLevel();
+    void putName(const char* name);
+    void putEndTag(const char* name);
+    void putString(const QString& s);
+    void putXmlString(const QString& s);
+    void putInt(qint64 value);
+    void putDouble(double value);
+    void lineDone();
+
+    void intTag(const char* name, qint64 value);
+    void doubleTag(const char* name, double value);
 
 public:
     XmlWriter(Score*);
     XmlWriter(Score* s, QIODevice* dev);
+    ~XmlWriter();
+
+    //! NOTE Hides QTextStream::flush(), writes out the buffered output first
+    void flush();
 
     Fraction curTick() const { return _curTick; }
     void setCurTick(const Fraction& v) { _curTick   = v; }
@@ -298,11 +349,12 @@ public:
     const std::vector<std::pair<const ScoreElement*, QString> >& elements() const { return _elements; }
     void setRecordElements(bool record) { _recordElements = record; }
 
-    void sTag(const char* name, Spatium sp) { XmlWriter::tag(name, QVariant(sp.val())); }
+    void sTag(const char* name, Spatium sp) { doubleTag(name, sp.val()); }
     void pTag(const char* name, PlaceText);
 
     void header();
 
+    void stag(const char* name);
     void stag(const QString&);
     void etag();
 
@@ -318,8 +370,28 @@ public:
     void tag(Pid id, QVariant data, QVariant defaultData = QVariant());
     void tag(const char* name, QVariant data, QVariant defaultData = QVariant());
     void tag(const QString&, QVariant data);
-    void tag(const char* name, const char* s) { tag(name, QVariant(s)); }
-    void tag(const char* name, const QString& s) { tag(name, QVariant(s)); }
+    void tag(const char* name, const char* s);
+    void tag(const char* name, const QString& s);
+    void tag(const char* name, const Fraction& f);
+    void tag(const char* name, Spatium sp) { doubleTag(name, sp.val()); }
+
+    template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+    void tag(const char* name, T value)
+    {
+        if (std::is_floating_point<T>::value) {
+            doubleTag(name, static_cast<double>(value));
+        } else {
+            intTag(name, static_cast<qint64>(value));
+        }
+    }
+
+    template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+    void tag(const char* name, T value, T defaultValue)
+    {
+        if (value != defaultValue) {
+            tag(name, value);
+        }
+    }
 
     void comment(const QString&);
 
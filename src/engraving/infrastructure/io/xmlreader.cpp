@@ -32,6 +32,33 @@
 using namespace mu;
 
 namespace Ms {
+//---------------------------------------------------------
+//   XmlReader
+//---------------------------------------------------------
+
+XmlReader::XmlReader(QFile* f)
+    : XmlReader(static_cast<QIODevice*>(f), f->fileName())
+{
+}
+
+XmlReader::XmlReader(const QByteArray& d, const QString& st)
+    : QXmlStreamReader(BinaryXml::isBinary(d) ? QByteArray() : d), docName(st)
+{
+    if (BinaryXml::isBinary(d)) {
+        _binary = std::make_unique<BinaryXmlReader>(d);
+    }
+}
+
+XmlReader::XmlReader(QIODevice* d, const QString& st)
+    : docName(st)
+{
+    if (BinaryXml::isBinary(d)) {
+        _binary = std::make_unique<BinaryXmlReader>(d->readAll());
+    } else {
+        setDevice(d);
+    }
+}
+
 //---------------------------------------------------------
 //   ~XmlReader
 //---------------------------------------------------------
@@ -211,6 +238,32 @@ Fraction XmlReader::readFraction()
     return Fraction(z, n);
 }
 
+//---------------------------------------------------------
+//   skipCurrentElement
+//---------------------------------------------------------
+
+void XmlReader::skipCurrentElement()
+{
+    if (_binary) {
+        _binary->skipCurrentElement();
+    } else {
+        QXmlStreamReader::skipCurrentElement();
+    }
+}
+
+//---------------------------------------------------------
+//   raiseError
+//---------------------------------------------------------
+
+void XmlReader::raiseError(const QString& message)
+{
+    if (_binary) {
+        _binary->raiseError(message);
+    } else {
+        QXmlStreamReader::raiseError(message);
+    }
+}
+
 //---------------------------------------------------------
 //   unknown
 //    unknown tag read
@@ -218,7 +271,7 @@ Fraction XmlReader::readFraction()
 
 void XmlReader::unknown()
 {
-    if (QXmlStreamReader::error()) {
+    if (error()) {
         qDebug("%s ", qPrintable(errorString()));
     }
     if (!docName.isEmpty()) {
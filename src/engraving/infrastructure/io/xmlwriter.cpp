@@ -22,6 +22,10 @@
 
 #include "xml.h"
 
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
 #include "libmscore/property.h"
 #include "libmscore/scoreElement.h"
 
@@ -47,6 +51,43 @@ XmlWriter::XmlWriter(Score* s, QIODevice* device)
     setCodec("UTF-8");
 }
 
+XmlWriter::~XmlWriter()
+{
+    flush();
+}
+
+//---------------------------------------------------------
+//   flush
+//---------------------------------------------------------
+
+void XmlWriter::flush()
+{
+    if (!_buffer.isEmpty()) {
+        if (device()) {
+            // keep the order with the text written directly to the stream
+            QTextStream::flush();
+            device()->write(_buffer);
+        } else {
+            QTextStream::operator<<(QString::fromUtf8(_buffer));
+        }
+        _buffer.clear();
+    }
+    QTextStream::flush();
+}
+
+//---------------------------------------------------------
+//   lineDone
+//    the output is written out when the last tag is closed,
+//    so the callers can read the device without destroying the writer
+//---------------------------------------------------------
+
+void XmlWriter::lineDone()
+{
+    if (stack.empty() || _buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
 //---------------------------------------------------------
 //   pTag
 //---------------------------------------------------------
@@ -65,9 +106,188 @@ void XmlWriter::pTag(const char* name, PlaceText place)
 
 void XmlWriter::putLevel()
 {
-    int level = stack.size();
-    for (int i = 0; i < level * 2; ++i) {
-        *this << ' ';
+    _buffer.append(static_cast<int>(stack.size()) * 2, ' ');
+}
+
+//---------------------------------------------------------
+//   putName
+//    <name attribute="value">
+//---------------------------------------------------------
+
+void XmlWriter::putName(const char* name)
+{
+    _buffer.append('<');
+    _buffer.append(name);
+    _buffer.append('>');
+}
+
+//---------------------------------------------------------
+//   putEndTag
+//    </name> for the name with attributes
+//---------------------------------------------------------
+
+void XmlWriter::putEndTag(const char* name)
+{
+    const char* end = strchr(name, ' ');
+    _buffer.append("</", 2);
+    if (end) {
+        _buffer.append(name, static_cast<int>(end - name));
+    } else {
+        _buffer.append(name);
+    }
+    _buffer.append(">\n", 2);
+}
+
+//---------------------------------------------------------
+//   putString
+//    append UTF-8, most strings are ASCII
+//---------------------------------------------------------
+
+static void appendUtf8(QByteArray& buffer, const QChar* data, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        if (data[i].unicode() >= 0x80) {
+            buffer.append(QString::fromRawData(data, size).toUtf8());
+            return;
+        }
+    }
+    int pos = buffer.size();
+    buffer.resize(pos + size);
+    char* dst = buffer.data() + pos;
+    for (int i = 0; i < size; ++i) {
+        dst[i] = static_cast<char>(data[i].unicode());
+    }
+}
+
+void XmlWriter::putString(const QString& s)
+{
+    appendUtf8(_buffer, s.constData(), s.size());
+}
+
+//---------------------------------------------------------
+//   putXmlString
+//    same as xmlString(), without creating the escaped string
+//---------------------------------------------------------
+
+void XmlWriter::putXmlString(const QString& s)
+{
+    const QChar* data = s.constData();
+    const int size = s.size();
+
+    int runStart = 0;
+    for (int i = 0; i < size; ++i) {
+        ushort c = data[i].unicode();
+        const char* escaped = nullptr;
+        switch (c) {
+        case '<':
+            escaped = "&lt;";
+            break;
+        case '>':
+            escaped = "&gt;";
+            break;
+        case '&':
+            escaped = "&amp;";
+            break;
+        case '\"':
+            escaped = "&quot;";
+            break;
+        default:
+            // ignore invalid characters in xml 1.0
+            if (c >= 0x20 || c == 0x09 || c == 0x0A || c == 0x0D) {
+                continue;
+            }
+            escaped = "";
+            break;
+        }
+        appendUtf8(_buffer, data + runStart, i - runStart);
+        _buffer.append(escaped);
+        runStart = i + 1;
+    }
+    appendUtf8(_buffer, data + runStart, size - runStart);
+}
+
+//---------------------------------------------------------
+//   putInt
+//---------------------------------------------------------
+
+void XmlWriter::putInt(qint64 value)
+{
+    char buf[24];
+    std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value);
+    _buffer.append(buf, static_cast<int>(result.ptr - buf));
+}
+
+//---------------------------------------------------------
+//   putDouble
+//    same as QTextStream: "%g" with 6 significant digits.
+//    The plain decimal form is formatted here, the exponent form
+//    and the values very close to a rounding tie by Qt
+//---------------------------------------------------------
+
+void XmlWriter::putDouble(double value)
+{
+    static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    static const double LOWER[] = { 1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5 };
+
+    if (value == 0.0 && !std::signbit(value)) {
+        _buffer.append('0');
+        return;
+    }
+
+    const double a = std::abs(value);
+    if (!(a >= 1e-4 && a < 1e6)) {
+        _buffer.append(QByteArray::number(value, 'g', 6));
+        return;
+    }
+
+    int exponent = 5;
+    while (a < LOWER[exponent + 4]) {
+        --exponent;
+    }
+
+    // exact power of ten, so the product has the error of a single rounding
+    const double scaled = a * POW10[5 - exponent];
+    const double integral = std::floor(scaled);
+    const double fraction = scaled - integral;
+    if (std::abs(fraction - 0.5) < 1e-6) {
+        _buffer.append(QByteArray::number(value, 'g', 6));
+        return;
+    }
+
+    qint64 digits = static_cast<qint64>(integral) + (fraction > 0.5 ? 1 : 0);
+    if (digits == 1000000) {
+        digits = 100000;
+        ++exponent;
+    }
+    if (digits < 100000 || digits > 999999 || exponent > 5) {
+        _buffer.append(QByteArray::number(value, 'g', 6));
+        return;
+    }
+
+    char d[6];
+    for (int i = 5; i >= 0; --i) {
+        d[i] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+
+    int last = 5;
+    while (last > exponent && last > 0 && d[last] == '0') {
+        --last;
+    }
+
+    if (value < 0) {
+        _buffer.append('-');
+    }
+    if (exponent >= 0) {
+        _buffer.append(d, exponent + 1);
+        if (last > exponent) {
+            _buffer.append('.');
+            _buffer.append(d + exponent + 1, last - exponent);
+        }
+    } else {
+        _buffer.append("0.", 2);
+        _buffer.append(-exponent - 1, '0');
+        _buffer.append(d, last + 1);
     }
 }
 
@@ -77,7 +297,8 @@ void XmlWriter::putLevel()
 
 void XmlWriter::header()
 {
-    *this << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    _buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -85,11 +306,25 @@ void XmlWriter::header()
 //    <mops attribute="value">
 //---------------------------------------------------------
 
+void XmlWriter::stag(const char* name)
+{
+    putLevel();
+    putName(name);
+    _buffer.append('\n');
+
+    const char* end = strchr(name, ' ');
+    stack.push_back(end ? QByteArray(name, static_cast<int>(end - name)) : QByteArray(name));
+}
+
 void XmlWriter::stag(const QString& s)
 {
     putLevel();
-    *this << '<' << s << '>' << Qt::endl;
-    stack.append(s.split(' ')[0]);
+    _buffer.append('<');
+    putString(s);
+    _buffer.append(">\n", 2);
+
+    int end = s.indexOf(' ');
+    stack.push_back(end < 0 ? s.toUtf8() : s.left(end).toUtf8());
 }
 
 //---------------------------------------------------------
@@ -110,12 +345,14 @@ void XmlWriter::stag(const ScoreElement* se, const QString& attributes)
 void XmlWriter::stag(const QString& name, const ScoreElement* se, const QString& attributes)
 {
     putLevel();
-    *this << '<' << name;
+    _buffer.append('<');
+    putString(name);
     if (!attributes.isEmpty()) {
-        *this << ' ' << attributes;
+        _buffer.append(' ');
+        putString(attributes);
     }
-    *this << '>' << Qt::endl;
-    stack.append(name);
+    _buffer.append(">\n", 2);
+    stack.push_back(name.toUtf8());
 
     if (_recordElements) {
         _elements.emplace_back(se, name);
@@ -130,7 +367,11 @@ void XmlWriter::stag(const QString& name, const ScoreElement* se, const QString&
 void XmlWriter::etag()
 {
     putLevel();
-    *this << "</" << stack.takeLast() << '>' << Qt::endl;
+    _buffer.append("</", 2);
+    _buffer.append(stack.back());
+    _buffer.append(">\n", 2);
+    stack.pop_back();
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -143,12 +384,13 @@ void XmlWriter::tagE(const char* format, ...)
     va_list args;
     va_start(args, format);
     putLevel();
-    *this << '<';
+    _buffer.append('<');
     char buffer[BS];
     vsnprintf(buffer, BS, format, args);
-    *this << buffer;
+    _buffer.append(buffer);
     va_end(args);
-    *this << "/>" << Qt::endl;
+    _buffer.append("/>\n", 3);
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -158,7 +400,10 @@ void XmlWriter::tagE(const char* format, ...)
 void XmlWriter::tagE(const QString& s)
 {
     putLevel();
-    *this << '<' << s << "/>\n";
+    _buffer.append('<');
+    putString(s);
+    _buffer.append("/>\n", 3);
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -169,7 +414,7 @@ void XmlWriter::tagE(const QString& s)
 void XmlWriter::ntag(const char* name)
 {
     putLevel();
-    *this << "<" << name << ">";
+    putName(name);
 }
 
 //---------------------------------------------------------
@@ -179,7 +424,10 @@ void XmlWriter::ntag(const char* name)
 
 void XmlWriter::netag(const char* s)
 {
-    *this << "</" << s << '>' << Qt::endl;
+    _buffer.append("</", 2);
+    _buffer.append(s);
+    _buffer.append(">\n", 2);
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -200,7 +448,7 @@ void XmlWriter::tag(Pid id, QVariant data, QVariant defaultData)
     if (writableVal.isEmpty()) {
         tag(name, data);
     } else {
-        tag(name, QVariant(writableVal));
+        tag(name, writableVal);
     }
 }
 
@@ -216,9 +464,102 @@ void XmlWriter::tag(const char* name, QVariant data, QVariant defaultData)
     }
 }
 
+void XmlWriter::tag(const char* name, const char* s)
+{
+    tag(name, QString(s));
+}
+
+void XmlWriter::tag(const char* name, const QString& s)
+{
+    putLevel();
+    putName(name);
+    putXmlString(s);
+    putEndTag(name);
+    lineDone();
+}
+
+void XmlWriter::tag(const char* name, const Fraction& f)
+{
+    // the closing tag repeats the attributes, as before
+    putLevel();
+    putName(name);
+    putInt(f.numerator());
+    _buffer.append('/');
+    putInt(f.denominator());
+    _buffer.append("</", 2);
+    _buffer.append(name);
+    _buffer.append(">\n", 2);
+    lineDone();
+}
+
+void XmlWriter::intTag(const char* name, qint64 value)
+{
+    putLevel();
+    putName(name);
+    putInt(value);
+    putEndTag(name);
+    lineDone();
+}
+
+void XmlWriter::doubleTag(const char* name, double value)
+{
+    putLevel();
+    putName(name);
+    putDouble(value);
+    putEndTag(name);
+    lineDone();
+}
+
 void XmlWriter::tag(const QString& name, QVariant data)
 {
-    QString ename(name.split(' ')[0]);
+    static const int SPATIUM_TYPE = qMetaTypeId<Spatium>();
+    static const int POINTF_TYPE = qMetaTypeId<PointF>();
+    static const int SIZEF_TYPE = qMetaTypeId<SizeF>();
+    static const int RECTF_TYPE = qMetaTypeId<RectF>();
+    static const int RECT_TYPE = qMetaTypeId<mu::Rect>();
+    static const int COLOR_TYPE = qMetaTypeId<mu::draw::Color>();
+    static const int FRACTION_TYPE = qMetaTypeId<Fraction>();
+    static const int DIRECTION_TYPE = qMetaTypeId<Direction>();
+    static const int ALIGN_TYPE = qMetaTypeId<Align>();
+
+    const QByteArray nameUtf8 = name.toUtf8();
+    const char* n = nameUtf8.constData();
+
+    // QString::arg() formats the integers and doubles in the same way as putInt() and putDouble()
+    auto putNumber = [this](auto v) {
+        if constexpr (std::is_integral<decltype(v)>::value) {
+            putInt(v);
+        } else {
+            putDouble(v);
+        }
+    };
+    auto putXY = [this, putNumber](auto x, auto y) {
+        _buffer.append(" x=\"", 4);
+        putNumber(x);
+        _buffer.append("\" y=\"", 5);
+        putNumber(y);
+        _buffer.append('"');
+    };
+    auto putWH = [this, putNumber](auto w, auto h) {
+        _buffer.append(" w=\"", 4);
+        putNumber(w);
+        _buffer.append("\" h=\"", 5);
+        putNumber(h);
+        _buffer.append('"');
+    };
+    auto putEmpty = [this, n]() {
+        _buffer.append('<');
+        _buffer.append(n);
+    };
+    auto endEmpty = [this]() {
+        _buffer.append("/>\n", 3);
+    };
+    // <name>value</name> with the attributes in the closing tag, as QString("<%1>%2</%1>")
+    auto endFull = [this, n]() {
+        _buffer.append("</", 2);
+        _buffer.append(n);
+        _buffer.append(">\n", 2);
+    };
 
     putLevel();
     switch (data.type()) {
@@ -226,24 +567,24 @@ void XmlWriter::tag(const QString& name, QVariant data)
     case QVariant::Char:
     case QVariant::Int:
     case QVariant::UInt:
-        *this << "<" << name << ">";
-        *this << data.toInt();
-        *this << "</" << ename << ">\n";
+        putName(n);
+        putInt(data.toInt());
+        putEndTag(n);
         break;
     case QVariant::LongLong:
-        *this << "<" << name << ">";
-        *this << data.toLongLong();
-        *this << "</" << ename << ">\n";
+        putName(n);
+        putInt(data.toLongLong());
+        putEndTag(n);
         break;
     case QVariant::Double:
-        *this << "<" << name << ">";
-        *this << data.value<double>();
-        *this << "</" << ename << ">\n";
+        putName(n);
+        putDouble(data.value<double>());
+        putEndTag(n);
         break;
     case QVariant::String:
-        *this << "<" << name << ">";
-        *this << xmlString(data.value<QString>());
-        *this << "</" << ename << ">\n";
+        putName(n);
+        putXmlString(data.value<QString>());
+        putEndTag(n);
         break;
     case QVariant::Color:
     {
@@ -254,55 +595,90 @@ void XmlWriter::tag(const QString& name, QVariant data)
     case QVariant::Rect:
     {
         const QRect& r(data.value<QRect>());
-        *this << QString("<%1 x=\"%2\" y=\"%3\" w=\"%4\" h=\"%5\"/>\n").arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
+        putEmpty();
+        putXY(r.x(), r.y());
+        putWH(r.width(), r.height());
+        endEmpty();
     }
     break;
     case QVariant::RectF:
     {
         const QRectF& r(data.value<QRectF>());
-        *this << QString("<%1 x=\"%2\" y=\"%3\" w=\"%4\" h=\"%5\"/>\n").arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
+        putEmpty();
+        putXY(r.x(), r.y());
+        putWH(r.width(), r.height());
+        endEmpty();
     }
     break;
     case QVariant::PointF:
     {
         const QPointF& p(data.value<QPointF>());
-        *this << QString("<%1 x=\"%2\" y=\"%3\"/>\n").arg(name).arg(p.x()).arg(p.y());
+        putEmpty();
+        putXY(p.x(), p.y());
+        endEmpty();
     }
     break;
     case QVariant::SizeF:
     {
         const QSizeF& p(data.value<QSizeF>());
-        *this << QString("<%1 w=\"%2\" h=\"%3\"/>\n").arg(name).arg(p.width()).arg(p.height());
+        putEmpty();
+        putWH(p.width(), p.height());
+        endEmpty();
     }
     break;
     default: {
-        const char* type = data.typeName();
-        if (strcmp(type, "Ms::Spatium") == 0) {
-            *this << "<" << name << ">";
-            *this << data.value<Spatium>().val();
-            *this << "</" << ename << ">\n";
-        } else if (strcmp(type, "mu::PointF") == 0) {
+        const int type = data.userType();
+        if (type == SPATIUM_TYPE) {
+            putName(n);
+            putDouble(data.value<Spatium>().val());
+            putEndTag(n);
+        } else if (type == POINTF_TYPE) {
             PointF p = PointF::fromVariant(data);
-            *this << QString("<%1 x=\"%2\" y=\"%3\"/>\n").arg(name).arg(p.x()).arg(p.y());
-        } else if (strcmp(type, "mu::SizeF") == 0) {
+            putEmpty();
+            putXY(p.x(), p.y());
+            endEmpty();
+        } else if (type == SIZEF_TYPE) {
             SizeF s = SizeF::fromVariant(data);
-            *this << QString("<%1 w=\"%2\" h=\"%3\"/>\n").arg(name).arg(s.width()).arg(s.height());
-        } else if (strcmp(type, "mu::RectF") == 0) {
+            putEmpty();
+            putWH(s.width(), s.height());
+            endEmpty();
+        } else if (type == RECTF_TYPE) {
             RectF r = RectF::fromVariant(data);
-            *this << QString("<%1 x=\"%2\" y=\"%3\" w=\"%4\" h=\"%5\"/>\n").arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
-        } else if (strcmp(type, "mu::Rect") == 0) {
+            putEmpty();
+            putXY(r.x(), r.y());
+            putWH(r.width(), r.height());
+            endEmpty();
+        } else if (type == RECT_TYPE) {
             Rect r = data.value<mu::Rect>();
-            *this << QString("<%1 x=\"%2\" y=\"%3\" w=\"%4\" h=\"%5\"/>\n").arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
-        } else if (strcmp(type, "mu::draw::Color") == 0) {
+            putEmpty();
+            putXY(r.x(), r.y());
+            putWH(r.width(), r.height());
+            endEmpty();
+        } else if (type == COLOR_TYPE) {
             mu::draw::Color color(data.value<mu::draw::Color>());
-            *this << QString("<%1 r=\"%2\" g=\"%3\" b=\"%4\" a=\"%5\"/>\n")
-                .arg(name).arg(color.red()).arg(color.green()).arg(color.blue()).arg(color.alpha());
-        } else if (strcmp(type, "Ms::Fraction") == 0) {
+            putEmpty();
+            _buffer.append(" r=\"", 4);
+            putInt(color.red());
+            _buffer.append("\" g=\"", 5);
+            putInt(color.green());
+            _buffer.append("\" b=\"", 5);
+            putInt(color.blue());
+            _buffer.append("\" a=\"", 5);
+            putInt(color.alpha());
+            _buffer.append('"');
+            endEmpty();
+        } else if (type == FRACTION_TYPE) {
             const Fraction& f = data.value<Fraction>();
-            *this << QString("<%1>%2/%3</%1>\n").arg(name).arg(f.numerator()).arg(f.denominator());
-        } else if (strcmp(type, "Ms::Direction") == 0) {
-            *this << QString("<%1>%2</%1>\n").arg(name, toString(data.value<Direction>()));
-        } else if (strcmp(type, "Ms::Align") == 0) {
+            putName(n);
+            putInt(f.numerator());
+            _buffer.append('/');
+            putInt(f.denominator());
+            endFull();
+        } else if (type == DIRECTION_TYPE) {
+            putName(n);
+            _buffer.append(toString(data.value<Direction>()));
+            endFull();
+        } else if (type == ALIGN_TYPE) {
             // TODO: remove from here? (handled in Ms::propertyWritableValue())
             Align a = Align(data.toInt());
             const char* h;
@@ -323,14 +699,18 @@ void XmlWriter::tag(const QString& name, QVariant data)
             } else {
                 v = "top";
             }
-            *this << QString("<%1>%2,%3</%1>\n").arg(name)
-                .arg(h, v);
+            putName(n);
+            _buffer.append(h);
+            _buffer.append(',');
+            _buffer.append(v);
+            endFull();
         } else {
-            qFatal("XmlWriter::tag: unsupported type %d %s", data.type(), type);
+            qFatal("XmlWriter::tag: unsupported type %d %s", data.type(), data.typeName());
         }
     }
     break;
     }
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -340,7 +720,10 @@ void XmlWriter::tag(const QString& name, QVariant data)
 void XmlWriter::comment(const QString& text)
 {
     putLevel();
-    *this << "<!-- " << text << " -->" << Qt::endl;
+    _buffer.append("<!-- ", 5);
+    putString(text);
+    _buffer.append(" -->\n", 5);
+    lineDone();
 }
 
 //---------------------------------------------------------
@@ -389,6 +772,8 @@ QString XmlWriter::xmlString(const QString& s)
 void XmlWriter::dump(int len, const unsigned char* p)
 {
     putLevel();
+    // the formatting is done by the stream
+    flush();
     int col = 0;
     setFieldWidth(5);
     setNumberFlags(numberFlags() | QTextStream::ShowBase);
@@ -399,6 +784,7 @@ void XmlWriter::dump(int len, const unsigned char* p)
             *this << Qt::endl;
             col = 0;
             putLevel();
+            flush();
             setFieldWidth(5);
         }
         *this << (p[i] & 0xff);
@@ -417,17 +803,18 @@ void XmlWriter::dump(int len, const unsigned char* p)
 
 void XmlWriter::writeXml(const QString& name, QString s)
 {
-    QString ename(name.split(' ')[0]);
-    putLevel();
     for (int i = 0; i < s.size(); ++i) {
         ushort c = s.at(i).unicode();
         if (c < 0x20 && c != 0x09 && c != 0x0A && c != 0x0D) {
             s[i] = '?';
         }
     }
-    *this << "<" << name << ">";
-    *this << s;
-    *this << "</" << ename << ">\n";
+    const QByteArray nameUtf8 = name.toUtf8();
+    putLevel();
+    putName(nameUtf8.constData());
+    putString(s);
+    putEndTag(nameUtf8.constData());
+    lineDone();
 }
 
 //---------------------------------------------------------
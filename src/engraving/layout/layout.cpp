@@ -72,13 +72,22 @@ Layout::Layout(Ms::Score* score)
 {
 }
 
-void Layout::doLayoutRange(const LayoutOptions& options, const Fraction& st, const Fraction& et)
+Layout::~Layout() = default;
+
+void Layout::doLayoutRange(const LayoutOptions& options, const Fraction& st, const Fraction& et, size_t maxPages)
 {
     CmdStateLocker cmdStateLocker(m_score);
-    LayoutContext lc(m_score);
 
-    Fraction stick(st);
-    Fraction etick(et);
+    //! NOTE The pages after the pending (or canceled) layout are missing, so only a complete layout makes sense
+    bool wasComplete = m_isComplete;
+    m_pendingContext.reset();
+    m_isComplete = true;
+
+    std::unique_ptr<LayoutContext> context = std::make_unique<LayoutContext>(m_score);
+    LayoutContext& lc = *context;
+
+    Fraction stick(wasComplete ? st : Fraction(0, 1));
+    Fraction etick(wasComplete ? et : Fraction(-1, 1));
     Q_ASSERT(!(stick == Fraction(-1, 1) && etick == Fraction(-1, 1)));
 
     if (!m_score->last() || (options.isMode(LayoutMode::LINE) && !m_score->firstMeasure())) {
@@ -213,15 +222,56 @@ void Layout::doLayoutRange(const LayoutOptions& options, const Fraction& st, con
     LayoutMeasure::getNextMeasure(options, m_score, lc);
     lc.curSystem = LayoutSystem::collectSystem(options, lc, m_score);
 
-    doLayout(options, lc);
+    if (doLayout(options, lc, layoutAll ? maxPages : 0)) {
+        m_pendingContext = std::move(context);
+        m_pendingOptions = options;
+        m_isComplete = false;
+    }
+}
+
+void Layout::layoutNextPages(size_t maxPages)
+{
+    if (!m_pendingContext) {
+        return;
+    }
+
+    CmdStateLocker cmdStateLocker(m_score);
+
+    if (!doLayout(m_pendingOptions, *m_pendingContext, maxPages)) {
+        m_pendingContext.reset();
+        m_isComplete = true;
+    }
+}
+
+bool Layout::isLayoutPending() const
+{
+    return m_pendingContext != nullptr;
+}
+
+bool Layout::isLayoutComplete() const
+{
+    return m_isComplete;
+}
+
+void Layout::cancelLayout()
+{
+    m_pendingContext.reset();
 }
 
-void Layout::doLayout(const LayoutOptions& options, LayoutContext& lc)
+bool Layout::doLayout(const LayoutOptions& options, LayoutContext& lc, size_t maxPages)
 {
     MeasureBase* lmb;
+    std::vector<Page*> collectedPages;
+    bool isPending = false;
     do {
+        if (maxPages > 0 && collectedPages.size() == maxPages) {
+            isPending = true;
+            break;
+        }
+
         LayoutPage::getNextPage(options, lc);
         LayoutPage::collectPage(options, lc);
+        collectedPages.push_back(lc.page);
 
         if (lc.page && !lc.page->systems().isEmpty()) {
             lmb = lc.page->systems().back()->measures().back();
@@ -241,6 +291,12 @@ void Layout::doLayout(const LayoutOptions& options, LayoutContext& lc)
     } while (lc.curSystem && !(lc.rangeDone && lmb == lc.pageOldMeasure));
     // && page->system(0)->measures().back()->tick() > endTick // FIXME: perhaps the first measure was meant? Or last system?
 
+    LayoutPage::finishPages(options, collectedPages);
+
+    if (isPending) {
+        return true;
+    }
+
     if (!lc.curSystem) {
         // The end of the score. The remaining systems are not needed...
         qDeleteAll(lc.systemList);
@@ -256,6 +312,8 @@ void Layout::doLayout(const LayoutOptions& options, LayoutContext& lc)
         }
     }
     lc.score->systems().append(lc.systemList);
+
+    return false;
 }
 
 //---------------------------------------------------------
@@ -22,6 +22,8 @@
 #ifndef MU_ENGRAVING_LAYOUT_H
 #define MU_ENGRAVING_LAYOUT_H
 
+#include <memory>
+
 #include "layoutoptions.h"
 
 namespace Ms {
@@ -37,8 +39,19 @@ class Layout
 {
 public:
     Layout(Ms::Score* score);
+    ~Layout();
+
+    //! NOTE If maxPages is not 0, a complete layout stops after maxPages pages and stays pending,
+    //! the rest of the pages are laid out by layoutNextPages. Any layout started meanwhile is a complete one
+    void doLayoutRange(const LayoutOptions& options, const Ms::Fraction&, const Ms::Fraction&, size_t maxPages = 0);
+    void layoutNextPages(size_t maxPages);
 
-    void doLayoutRange(const LayoutOptions& options, const Ms::Fraction&, const Ms::Fraction&);
+    bool isLayoutPending() const;
+    bool isLayoutComplete() const;
+
+    //! NOTE Drops the pending layout (the score is going to be changed),
+    //! the laid out pages are kept until the next layout
+    void cancelLayout();
 
 private:
 
@@ -47,9 +60,14 @@ private:
     void resetSystems(bool layoutAll, const LayoutOptions& options, LayoutContext& lc);
     void collectLinearSystem(const LayoutOptions& options, LayoutContext& lc);
 
-    void doLayout(const LayoutOptions& options, LayoutContext& lc);
+    //! NOTE Returns true if it stopped after maxPages pages before the end of the score
+    bool doLayout(const LayoutOptions& options, LayoutContext& lc, size_t maxPages = 0);
 
     Ms::Score* m_score = nullptr;
+
+    std::unique_ptr<LayoutContext> m_pendingContext;
+    LayoutOptions m_pendingOptions;
+    bool m_isComplete = true;
 };
 }
 
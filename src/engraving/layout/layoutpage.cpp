@@ -21,7 +21,13 @@
  */
 #include "layoutpage.h"
 
+#include <future>
+#include <memory>
+
+#include <QThreadPool>
+
 #include "realfn.h"
+#include "log.h"
 
 #include "libmscore/score.h"
 #include "libmscore/page.h"
@@ -219,9 +225,71 @@ void LayoutPage::collectPage(const LayoutOptions& options, LayoutContext& lc)
             break;
         }
     }
+}
+
+//---------------------------------------------------------
+//   finishPages
+//---------------------------------------------------------
+
+void LayoutPage::finishPages(const LayoutOptions& options, const std::vector<Page*>& pages)
+{
+    TRACEFUNC;
+
+    std::vector<std::vector<System*> > distributedSystems(pages.size());
+    const bool distribute = !pages.empty() && isStavesDistributed(pages.front()->score());
+
+    if (distribute) {
+        //! NOTE The last page is justified by this thread, the others by the free threads of the pool
+        std::vector<std::future<void> > jobs;
+        for (size_t i = 0; i < pages.size(); ++i) {
+            Page* page = pages[i];
+            if (page->systems().empty()) {
+                continue;
+            }
+
+            std::vector<System*>* systems = &distributedSystems[i];
+            auto job = std::make_shared<std::packaged_task<void()> >([page, systems]() {
+                *systems = distributeStaves(page);
+            });
+            jobs.push_back(job->get_future());
+
+            if (i + 1 == pages.size() || !QThreadPool::globalInstance()->tryStart([job]() { (*job)(); })) {
+                (*job)();
+            }
+        }
+
+        for (std::future<void>& job : jobs) {
+            job.wait();
+        }
+    }
+
+    // the rest creates and lays out elements, so it is done in the page order
+    for (size_t i = 0; i < pages.size(); ++i) {
+        Page* page = pages[i];
+        for (System* system : distributedSystems[i]) {
+            system->setMeasureHeight(system->height());
+            system->layoutBracketsVertical();
+            system->layoutInstrumentNames();
+        }
+
+        if (distribute && !page->systems().empty()) {
+            layoutSystemDividers(page);
+        }
 
+        finishPage(options, page);
+    }
+}
+
+//---------------------------------------------------------
+//   finishPage
+//    layout of the page elements which depend on the final
+//    position of the staves
+//---------------------------------------------------------
+
+void LayoutPage::finishPage(const LayoutOptions& options, Page* page)
+{
     Fraction stick = Fraction(-1, 1);
-    for (System* s : lc.page->systems()) {
+    for (System* s : page->systems()) {
         Score* currentScore = s->score();
         for (MeasureBase* mb : s->measures()) {
             if (!mb->isMeasure()) {
@@ -290,12 +358,12 @@ void LayoutPage::collectPage(const LayoutOptions& options, LayoutContext& lc)
     }
 
     if (options.isMode(LayoutMode::SYSTEM)) {
-        System* s = lc.page->systems().last();
-        qreal height = s ? s->pos().y() + s->height() + s->minBottom() : lc.page->tm();
-        lc.page->bbox().setRect(0.0, 0.0, options.loWidth, height + lc.page->bm());
+        System* s = page->systems().last();
+        qreal height = s ? s->pos().y() + s->height() + s->minBottom() : page->tm();
+        page->bbox().setRect(0.0, 0.0, options.loWidth, height + page->bm());
     }
 
-    lc.page->invalidateBspTree();
+    page->invalidateBspTree();
 }
 
 //---------------------------------------------------------
@@ -347,20 +415,12 @@ void LayoutPage::layoutPage(Page* page, qreal restHeight)
             for (System* system : page->systems()) {
                 system->move(PointF(0.0, y));
             }
-        } else if ((score->layoutMode() != LayoutMode::SYSTEM) && score->enableVerticalSpread()) {
-            distributeStaves(page);
+        } else if (isStavesDistributed(score)) {
+            // the staves are distributed and the dividers are laid out by finishPages
+            return;
         }
 
-        // system dividers
-        for (int i = 0; i < gaps; ++i) {
-            System* s1 = page->systems().at(i);
-            System* s2 = page->systems().at(i + 1);
-            if (!(s1->vbox() || s2->vbox())) {
-                qreal yOffset = s1->height() + (s1->distance() - s1->height()) * .5;
-                checkDivider(true,  s1, yOffset);
-                checkDivider(false, s1, yOffset);
-            }
-        }
+        layoutSystemDividers(page);
         return;
     }
 
@@ -423,6 +483,24 @@ void LayoutPage::layoutPage(Page* page, qreal restHeight)
     page->systems().back()->rypos() = y;
 }
 
+//---------------------------------------------------------
+//   layoutSystemDividers
+//---------------------------------------------------------
+
+void LayoutPage::layoutSystemDividers(Page* page)
+{
+    int gaps = page->systems().size() - 1;
+    for (int i = 0; i < gaps; ++i) {
+        System* s1 = page->systems().at(i);
+        System* s2 = page->systems().at(i + 1);
+        if (!(s1->vbox() || s2->vbox())) {
+            qreal yOffset = s1->height() + (s1->distance() - s1->height()) * .5;
+            checkDivider(true,  s1, yOffset);
+            checkDivider(false, s1, yOffset);
+        }
+    }
+}
+
 void LayoutPage::checkDivider(bool left, System* s, qreal yOffset, bool remove)
 {
     SystemDivider* divider = left ? s->systemDividerLeft() : s->systemDividerRight();
@@ -453,7 +531,22 @@ void LayoutPage::checkDivider(bool left, System* s, qreal yOffset, bool remove)
     }
 }
 
-void LayoutPage::distributeStaves(Page* page)
+//---------------------------------------------------------
+//   isStavesDistributed
+//---------------------------------------------------------
+
+bool LayoutPage::isStavesDistributed(const Score* score)
+{
+    return score->layoutMode() != LayoutMode::FLOAT && score->layoutMode() != LayoutMode::SYSTEM && score->enableVerticalSpread();
+}
+
+//---------------------------------------------------------
+//   distributeStaves
+//    moves the systems and staves of the page only,
+//    returns the systems with moved staves
+//---------------------------------------------------------
+
+std::vector<System*> LayoutPage::distributeStaves(Page* page)
 {
     Score* score { page->score() };
     VerticalGapDataList vgdl;
@@ -469,12 +562,11 @@ void LayoutPage::distributeStaves(Page* page)
     bool transferCurlyBracket  { false };
     for (System* system : page->systems()) {
         if (system->vbox()) {
-            VerticalGapData* vgd = new VerticalGapData(!ngaps++, system, nullptr, nullptr, nullptr, prevYBottom);
-            vgd->addSpaceAroundVBox(true);
+            vgdl.emplace_back(!ngaps++, system, nullptr, nullptr, nullptr, prevYBottom);
+            vgdl.back().addSpaceAroundVBox(true);
             prevYBottom = system->y();
             yBottom     = system->y() + system->height();
             vbox        = true;
-            vgdl.append(vgd);
             transferNormalBracket = false;
             transferCurlyBracket  = false;
         } else {
@@ -502,7 +594,8 @@ void LayoutPage::distributeStaves(Page* page)
                     continue;
                 }
 
-                VerticalGapData* vgd = new VerticalGapData(!ngaps++, system, staff, sysStaff, nextSpacer, prevYBottom);
+                vgdl.emplace_back(!ngaps++, system, staff, sysStaff, nextSpacer, prevYBottom);
+                VerticalGapData* vgd = &vgdl.back();
                 nextSpacer = system->downSpacer(staff->idx());
 
                 if (newSystem) {
@@ -530,7 +623,6 @@ void LayoutPage::distributeStaves(Page* page)
                 prevYBottom  = system->y() + sysStaff->y() + sysStaff->bbox().height();
                 yBottom      = system->y() + sysStaff->y() + sysStaff->skyline().south().max();
                 spacerOffset = sysStaff->skyline().south().max() - sysStaff->bbox().height();
-                vgdl.append(vgd);
             }
             transferNormalBracket = endNormalBracket >= 0;
             transferCurlyBracket  = endCurlyBracket >= 0;
@@ -543,12 +635,13 @@ void LayoutPage::distributeStaves(Page* page)
         spaceLeft -= qMax(0.0, nextSpacer->gap() - spacerOffset - score->styleP(Sid::staffLowerBorder));
     }
     if (spaceLeft <= 0.0) {
-        return;
+        return {};
     }
 
     // Try to make the gaps equal, taking the spread factors and maximum spacing into account.
     static const int maxPasses { 20 };     // Saveguard to prevent endless loops.
     int pass { 0 };
+    std::vector<VerticalGapData*> modified;
     while (!RealIsNull(spaceLeft) && (ngaps > 0) && (++pass < maxPasses)) {
         ngaps = 0;
         qreal smallest     { vgdl.smallest() };
@@ -562,19 +655,19 @@ void LayoutPage::distributeStaves(Page* page)
         }
 
         qreal addedSpace { 0.0 };
-        VerticalGapDataList modified;
-        for (VerticalGapData* vgd : vgdl) {
-            if (!RealIsNull(vgd->spacing() - smallest)) {
+        modified.clear();
+        for (VerticalGapData& vgd : vgdl) {
+            if (!RealIsNull(vgd.spacing() - smallest)) {
                 continue;
             }
-            qreal step { nextSmallest - vgd->spacing() };
+            qreal step { nextSmallest - vgd.spacing() };
             if (step < 0.0) {
                 continue;
             }
-            step = vgd->addSpacing(step);
+            step = vgd.addSpacing(step);
             if (!RealIsNull(step)) {
-                addedSpace += step * vgd->factor();
-                modified.append(vgd);
+                addedSpace += step * vgd.factor();
+                modified.push_back(&vgd);
                 ++ngaps;
             }
             if ((spaceLeft - addedSpace) <= 0.0) {
@@ -594,30 +687,31 @@ void LayoutPage::distributeStaves(Page* page)
     // If there is still space left, distribute the space of the staves.
     // However, there is a limit on how much space is added per gap.
     const qreal maxPageFill { score->styleP(Sid::maxPageFillSpread) };
-    spaceLeft = qMin(maxPageFill * vgdl.length(), spaceLeft);
+    spaceLeft = qMin(maxPageFill * vgdl.size(), spaceLeft);
     pass = 0;
     ngaps = 1;
     while (!RealIsNull(spaceLeft) && !RealIsNull(maxPageFill) && (ngaps > 0) && (++pass < maxPasses)) {
         ngaps = 0;
         qreal addedSpace { 0.0 };
         qreal step { spaceLeft / vgdl.sumStretchFactor() };
-        for (VerticalGapData* vgd : vgdl) {
-            qreal res { vgd->addFillSpacing(step, maxPageFill) };
+        for (VerticalGapData& vgd : vgdl) {
+            qreal res { vgd.addFillSpacing(step, maxPageFill) };
             if (!RealIsNull(res)) {
-                addedSpace += res * vgd->factor();
+                addedSpace += res * vgd.factor();
                 ++ngaps;
             }
         }
         spaceLeft -= addedSpace;
     }
 
-    QSet<System*> systems;
+    std::vector<System*> systems;
     qreal systemShift { 0.0 };
     qreal staffShift  { 0.0 };
     System* prvSystem { nullptr };
-    for (VerticalGapData* vgd : vgdl) {
-        if (vgd->sysStaff) {
-            systems.insert(vgd->system);
+    for (VerticalGapData& gap : vgdl) {
+        VerticalGapData* vgd = &gap;
+        if (vgd->sysStaff && (systems.empty() || systems.back() != vgd->system)) {
+            systems.push_back(vgd->system);
         }
         systemShift += vgd->actualAddedSpace();
         if (prvSystem == vgd->system) {
@@ -641,10 +735,5 @@ void LayoutPage::distributeStaves(Page* page)
         prvSystem->setHeight(prvSystem->height() + staffShift);
     }
 
-    for (System* system : systems) {
-        system->setMeasureHeight(system->height());
-        system->layoutBracketsVertical();
-        system->layoutInstrumentNames();
-    }
-    vgdl.deleteAll();
+    return systems;
 }
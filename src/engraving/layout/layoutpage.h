@@ -22,6 +22,8 @@
 #ifndef MU_ENGRAVING_LAYOUTPAGE_H
 #define MU_ENGRAVING_LAYOUTPAGE_H
 
+#include <vector>
+
 #include "layoutoptions.h"
 #include "layoutcontext.h"
 
@@ -38,10 +40,17 @@ public:
     static void getNextPage(const LayoutOptions& options, LayoutContext& lc);
     static void collectPage(const LayoutOptions& options, LayoutContext& lc);
 
+    //! NOTE The collected pages are justified after all of them are filled with systems,
+    //! the vertical justification is page local, so it runs in parallel for the pages
+    static void finishPages(const LayoutOptions& options, const std::vector<Ms::Page*>& pages);
+
 private:
     static void layoutPage(Ms::Page* page, qreal restHeight);
+    static void finishPage(const LayoutOptions& options, Ms::Page* page);
+    static void layoutSystemDividers(Ms::Page* page);
     static void checkDivider(bool left, Ms::System* s, qreal yOffset, bool remove = false);
-    static void distributeStaves(Ms::Page* page);
+    static bool isStavesDistributed(const Ms::Score* score);
+    static std::vector<Ms::System*> distributeStaves(Ms::Page* page);
 };
 }
 
@@ -206,17 +206,6 @@ qreal VerticalGapData::addFillSpacing(qreal step, qreal maxFill)
     return res;
 }
 
-//---------------------------------------------------------
-//   deleteAll
-//---------------------------------------------------------
-
-void VerticalGapDataList::deleteAll()
-{
-    for (auto vsd : *this) {
-        delete vsd;
-    }
-}
-
 //---------------------------------------------------------
 //   sumStretchFactor
 //---------------------------------------------------------
@@ -224,9 +213,9 @@ void VerticalGapDataList::deleteAll()
 qreal VerticalGapDataList::sumStretchFactor() const
 {
     qreal sum { 0.0 };
-    for (VerticalGapData* vsd : *this) {
-        if (!vsd->isFixedHeight()) {
-            sum += vsd->factor();
+    for (const VerticalGapData& vsd : *this) {
+        if (!vsd.isFixedHeight()) {
+            sum += vsd.factor();
         }
     }
     return sum;
@@ -238,16 +227,16 @@ qreal VerticalGapDataList::sumStretchFactor() const
 
 qreal VerticalGapDataList::smallest(qreal limit) const
 {
-    VerticalGapData* vdp { nullptr };
-    for (VerticalGapData* vgd : *this) {
-        if (vgd->isFixedHeight()) {
+    const VerticalGapData* vdp { nullptr };
+    for (const VerticalGapData& vgd : *this) {
+        if (vgd.isFixedHeight()) {
             continue;
         }
-        if ((qCeil(limit) == qCeil(vgd->spacing()))) {
+        if ((qCeil(limit) == qCeil(vgd.spacing()))) {
             continue;
         }
-        if (!vdp || (vgd->spacing() < vdp->spacing())) {
-            vdp = vgd;
+        if (!vdp || (vgd.spacing() < vdp->spacing())) {
+            vdp = &vgd;
         }
     }
     return vdp ? vdp->spacing() : 0.0;
@@ -22,7 +22,8 @@
 #ifndef MU_ENGRAVING_VERTICALGAPDATALIST_H
 #define MU_ENGRAVING_VERTICALGAPDATALIST_H
 
-#include <QList>
+#include <vector>
+#include <QtGlobal>
 
 namespace Ms {
 class System;
@@ -78,10 +79,10 @@ public:
 //    helper class for spreading staves over a page
 //---------------------------------------------------------
 
-class VerticalGapDataList : public QList<VerticalGapData*>
+//! NOTE The gaps are stored by value, one contiguous block per page
+class VerticalGapDataList : public std::vector<VerticalGapData>
 {
 public:
-    void deleteAll();
     qreal sumStretchFactor() const;
     qreal smallest(qreal limit=-1.0) const;
 };
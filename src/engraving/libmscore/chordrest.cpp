@@ -199,10 +199,9 @@ void ChordRest::writeProperties(XmlWriter& xml) const
         xml.incCurTick(t);
     }
 
-    for (auto i : score()->spannerMap().findOverlapping(curTick - 1, curTick + 1)) {
-        Spanner* s = i.value;
+    score()->spannerMap().forEachOverlapping(curTick - 1, curTick + 1, [this, &xml](Spanner* s) {
         if (s->generated() || !s->isSlur() || toSlur(s)->broken() || !xml.canWrite(s)) {
-            continue;
+            return;
         }
 
         if (s->startElement() == this) {
@@ -210,7 +209,7 @@ void ChordRest::writeProperties(XmlWriter& xml) const
         } else if (s->endElement() == this) {
             s->writeSpannerEnd(xml, this, track());
         }
-    }
+    });
 }
 
 //---------------------------------------------------------
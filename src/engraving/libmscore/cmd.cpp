@@ -244,6 +244,12 @@ void Score::startCmd()
 
     cmdState().reset();
 
+    // The command can remove the elements the pending
+    // layout refers to, see update()
+    for (Score* s : masterScore()->scoreList()) {
+        s->cancelLayout();
+    }
+
     // Start collecting low-level undo operations for a
     // user-visible undo action.
     if (undoStack()->active()) {
@@ -263,6 +269,9 @@ void Score::undoRedo(bool undo, EditData* ed)
         return;
     }
     cmdState().reset();
+    for (Score* s : masterScore()->scoreList()) {
+        s->cancelLayout();
+    }
     if (undo) {
         undoStack()->undo(ed);
     } else {
@@ -336,12 +345,25 @@ void Score::update(bool resetCmdState)
         MasterScore* ms = masterScore();
         CmdState& cs = ms->cmdState();
         ms->deletePostponed();
+        // restart the layout canceled by startCmd() or undoRedo()
+        for (Score* s : ms->scoreList()) {
+            if (!s->isLayoutComplete() && !s->isLayoutPending()) {
+                ms->setLayoutAll();
+                break;
+            }
+        }
         if (cs.layoutRange()) {
             for (Score* s : ms->scoreList()) {
-                s->doLayoutRange(cs.startTick(), cs.endTick());
+                s->doLayoutRange(cs.startTick(), cs.endTick(), ms->layoutStepPages());
             }
+            ms->addPlaybackChanges(cs.startTick(), cs.endTick());
             updateAll = true;
         }
+        if (cs._instrumentsChanged
+            || (cs.layoutFlags & LayoutFlag::FIX_PITCH_VELO)
+            || (cs.layoutFlags & LayoutFlag::REBUILD_MIDI_MAPPING)) {
+            ms->setAllPlaybackChanged();
+        }
     }
 
     {
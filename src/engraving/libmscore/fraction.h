@@ -25,6 +25,8 @@
 #ifndef __FRACTION_H__
 #define __FRACTION_H__
 
+#include <climits>
+
 #include "config.h"
 #include "mscore.h"
 
@@ -36,21 +38,20 @@ namespace Ms {
 //    return int to avoid accidental implicit unsigned cast
 //---------------------------------------------------------
 
-static int_least64_t gcd(int_least64_t a, int_least64_t b)
+static constexpr int_least64_t gcd(int_least64_t a, int_least64_t b)
 {
-    int bp;
-    if (b > a) {
-        bp = b;
-        b = a;
-        a = bp;
-    }                                       // Saves one % if true
+    if (a < 0) {
+        a = -a;
+    }
+    if (b < 0) {
+        b = -b;
+    }
     while (b != 0) {
-        bp = b;
-        b = a % b;
-        a = bp;
+        const int_least64_t t = a % b;
+        a = b;
+        b = t;
     }
-
-    return a >= 0 ? a : -a;
+    return a;
 }
 
 //---------------------------------------------------------
@@ -63,19 +64,53 @@ class Fraction
     int_least64_t _numerator   { 0 };
     int_least64_t _denominator { 1 };
 
+    // numerator() and denominator() return int, so the slow paths reduce
+    // as soon as an unreduced value would not fit anymore
+    constexpr void reduceIfOverflows()
+    {
+        if (_denominator > INT_MAX || _numerator > INT_MAX || _numerator < INT_MIN) {
+            reduce();
+        }
+    }
+
+    // adds n1/d1 and n2/d2 scaled to the common denominator;
+    // tick based denominators usually divide each other, which needs no gcd
+    constexpr void addScaled(int_least64_t n2, int_least64_t d2)
+    {
+        if (_denominator == d2) {
+            _numerator += n2;         // Common enough use case to be handled separately for efficiency
+        } else if (_denominator != 0 && d2 % _denominator == 0) {
+            _numerator = _numerator * (d2 / _denominator) + n2;
+            _denominator = d2;
+        } else if (d2 != 0 && _denominator % d2 == 0) {
+            _numerator += n2 * (_denominator / d2);
+        } else {
+            const int_least64_t g = gcd(_denominator, d2);
+            const int_least64_t m1 = d2 / g;       // This saves one division over straight lcm
+            _numerator = _numerator * m1 + n2 * (_denominator / g);
+            _denominator = m1 * _denominator;
+            reduceIfOverflows();
+        }
+    }
+
+    // constructs from already normalized 64 bit values, without narrowing them to int
+    struct RawTag {};
+    constexpr Fraction(int_least64_t z, int_least64_t n, RawTag)
+        : _numerator{z}, _denominator{n} { }
+
 public:
 
     // no implicit conversion from int to Fraction:
     constexpr Fraction() {}
     constexpr Fraction(int z, int n)
         : _numerator{n < 0 ? -z : z}, _denominator{n < 0 ? -n : n} { }
-    int numerator() const { return _numerator; }
-    int denominator() const { return _denominator; }
+    constexpr int numerator() const { return static_cast<int>(_numerator); }
+    constexpr int denominator() const { return static_cast<int>(_denominator); }
     int_least64_t& rnumerator() { return _numerator; }
     int_least64_t& rdenominator() { return _denominator; }
 
-    void setNumerator(int v) { _numerator = v; }
-    void setDenominator(int v)
+    constexpr void setNumerator(int v) { _numerator = v; }
+    constexpr void setDenominator(int v)
     {
         if (v < 0) {
             _numerator = -_numerator;
@@ -85,7 +120,7 @@ public:
         }
     }
 
-    void set(int z, int n)
+    constexpr void set(int z, int n)
     {
         if (n < 0) {
             _numerator = -z;
@@ -96,106 +131,101 @@ public:
         }
     }
 
-    bool isZero() const { return _numerator == 0; }
-    bool isNotZero() const { return _numerator != 0; }
-    bool negative() const { return _numerator < 0; }
+    constexpr bool isZero() const { return _numerator == 0; }
+    constexpr bool isNotZero() const { return _numerator != 0; }
+    constexpr bool negative() const { return _numerator < 0; }
 
-    bool isValid() const { return _denominator != 0; }
+    constexpr bool isValid() const { return _denominator != 0; }
 
     // check if two fractions are identical (numerator & denominator)
     // == operator checks for equal value:
-    bool identical(const Fraction& v) const
+    constexpr bool identical(const Fraction& v) const
     {
         return (_numerator == v._numerator)
                && (_denominator == v._denominator);
     }
 
-    Fraction absValue() const
+    constexpr Fraction absValue() const
     {
-        return Fraction(qAbs(_numerator), _denominator);
+        return Fraction(_numerator < 0 ? -_numerator : _numerator, _denominator, RawTag());
     }
 
-    Fraction inverse() const
+    constexpr Fraction inverse() const
     {
-        return Fraction(_denominator, _numerator);
+        return _numerator < 0 ? Fraction(-_denominator, -_numerator, RawTag()) : Fraction(_denominator, _numerator, RawTag());
     }
 
     // --- reduction --- //
 
-    void reduce()
+    constexpr void reduce()
     {
-        const int g = gcd(_numerator, _denominator);
+        const int_least64_t g = gcd(_numerator, _denominator);
         _numerator /= g;
         _denominator /= g;
     }
 
-    Fraction reduced() const
+    constexpr Fraction reduced() const
     {
-        const int g = gcd(_numerator, _denominator);
-        return Fraction(_numerator / g, _denominator / g);
+        const int_least64_t g = gcd(_numerator, _denominator);
+        return Fraction(_numerator / g, _denominator / g, RawTag());
     }
 
     // --- comparison --- //
 
-    bool operator<(const Fraction& val) const
+    constexpr bool operator<(const Fraction& val) const
     {
+        if (_denominator == val._denominator) {
+            return _numerator < val._numerator;
+        }
         return _numerator * val._denominator < val._numerator * _denominator;
     }
 
-    bool operator<=(const Fraction& val) const
+    constexpr bool operator<=(const Fraction& val) const
     {
+        if (_denominator == val._denominator) {
+            return _numerator <= val._numerator;
+        }
         return _numerator * val._denominator <= val._numerator * _denominator;
     }
 
-    bool operator>=(const Fraction& val) const
+    constexpr bool operator>=(const Fraction& val) const
     {
-        return _numerator * val._denominator >= val._numerator * _denominator;
+        return val <= *this;
     }
 
-    bool operator>(const Fraction& val) const
+    constexpr bool operator>(const Fraction& val) const
     {
-        return _numerator * val._denominator > val._numerator * _denominator;
+        return val < *this;
     }
 
-    bool operator==(const Fraction& val) const
+    constexpr bool operator==(const Fraction& val) const
     {
+        if (_denominator == val._denominator) {
+            return _numerator == val._numerator;
+        }
         return _numerator * val._denominator == val._numerator * _denominator;
     }
 
-    bool operator!=(const Fraction& val) const
+    constexpr bool operator!=(const Fraction& val) const
     {
-        return _numerator * val._denominator != val._numerator * _denominator;
+        return !(*this == val);
     }
 
     // --- arithmetic --- //
 
-    Fraction& operator+=(const Fraction& val)
+    constexpr Fraction& operator+=(const Fraction& val)
     {
-        if (_denominator == val._denominator) {
-            _numerator += val._numerator;        // Common enough use case to be handled separately for efficiency
-        } else {
-            const int g = gcd(_denominator, val._denominator);
-            const int m1 = val._denominator / g;       // This saves one division over straight lcm
-            _numerator = _numerator * m1 + val._numerator * (_denominator / g);
-            _denominator = m1 * _denominator;
-        }
+        addScaled(val._numerator, val._denominator);
         return *this;
     }
 
-    Fraction& operator-=(const Fraction& val)
+    constexpr Fraction& operator-=(const Fraction& val)
     {
-        if (_denominator == val._denominator) {
-            _numerator -= val._numerator;       // Common enough use case to be handled separately for efficiency
-        } else {
-            const int g = gcd(_denominator, val._denominator);
-            const int m1 = val._denominator / g;       // This saves one division over straight lcm
-            _numerator = _numerator * m1 - val._numerator * (_denominator / g);
-            _denominator = m1 * _denominator;
-        }
+        addScaled(-val._numerator, val._denominator);
         return *this;
     }
 
-    Fraction& operator*=(const Fraction& val)
+    constexpr Fraction& operator*=(const Fraction& val)
     {
         _numerator *= val._numerator;
         _denominator *= val._denominator;
@@ -205,13 +235,14 @@ public:
         return *this;
     }
 
-    Fraction& operator*=(int val)
+    constexpr Fraction& operator*=(int val)
     {
         _numerator *= val;
+        reduceIfOverflows();
         return *this;
     }
 
-    Fraction& operator/=(const Fraction& val)
+    constexpr Fraction& operator/=(const Fraction& val)
     {
         const int sign = (val._numerator >= 0 ? 1 : -1);
         _numerator   *= (sign * val._denominator);
@@ -222,7 +253,7 @@ public:
         return *this;
     }
 
-    Fraction& operator/=(int val)
+    constexpr Fraction& operator/=(int val)
     {
         _denominator *= val;
         if (_denominator < 0) {
@@ -233,12 +264,12 @@ public:
         return *this;
     }
 
-    Fraction operator+(const Fraction& v) const { return Fraction(*this) += v; }
-    Fraction operator-(const Fraction& v) const { return Fraction(*this) -= v; }
-    Fraction operator-() const { return Fraction(-_numerator, _denominator); }
-    Fraction operator*(const Fraction& v) const { return Fraction(*this) *= v; }
-    Fraction operator/(const Fraction& v) const { return Fraction(*this) /= v; }
-    Fraction operator/(int v)             const { return Fraction(*this) /= v; }
+    constexpr Fraction operator+(const Fraction& v) const { return Fraction(*this) += v; }
+    constexpr Fraction operator-(const Fraction& v) const { return Fraction(*this) -= v; }
+    constexpr Fraction operator-() const { return Fraction(-_numerator, _denominator, RawTag()); }
+    constexpr Fraction operator*(const Fraction& v) const { return Fraction(*this) *= v; }
+    constexpr Fraction operator/(const Fraction& v) const { return Fraction(*this) /= v; }
+    constexpr Fraction operator/(int v)             const { return Fraction(*this) /= v; }
 
     //---------------------------------------------------------
     //   fromTicks
@@ -299,8 +330,8 @@ public:
     }
 };
 
-inline Fraction operator*(const Fraction& f, int v) { return Fraction(f) *= v; }
-inline Fraction operator*(int v, const Fraction& f) { return Fraction(f) *= v; }
+constexpr Fraction operator*(const Fraction& f, int v) { return Fraction(f) *= v; }
+constexpr Fraction operator*(int v, const Fraction& f) { return Fraction(f) *= v; }
 }     // namespace Ms
 
 Q_DECLARE_METATYPE(Ms::Fraction)
@@ -0,0 +1,629 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "instrtemplatecache.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include "instrtemplate.h"
+#include "drumset.h"
+#include "scoreorder.h"
+#include "stafftype.h"
+#include "stringdata.h"
+
+namespace Ms {
+//! NOTE Increase on any change of the layout below, old caches are rebuilt then
+static constexpr quint32 CACHE_MAGIC = 0x4d534954;   // "MSIT"
+static constexpr quint32 CACHE_FORMAT_VERSION = 1;
+static constexpr int CACHE_STREAM_VERSION = QDataStream::Qt_5_9;
+
+//---------------------------------------------------------
+//   Writer
+//---------------------------------------------------------
+
+static void writeEvents(QDataStream& s, const std::vector<MidiCoreEvent>& events)
+{
+    s << quint32(events.size());
+    for (const MidiCoreEvent& e : events) {
+        s << quint8(e.type()) << quint8(e.channel()) << quint8(e.dataA()) << quint8(e.dataB());
+    }
+}
+
+static void writeArticulations(QDataStream& s, const QList<MidiArticulation>& list)
+{
+    s << quint32(list.size());
+    for (const MidiArticulation& a : list) {
+        s << a.name << a.descr << qint32(a.velocity) << qint32(a.gateTime);
+    }
+}
+
+static void writeMidiActions(QDataStream& s, const QList<NamedEventList>& list)
+{
+    s << quint32(list.size());
+    for (const NamedEventList& a : list) {
+        s << a.name << a.descr;
+        writeEvents(s, a.events);
+    }
+}
+
+static void writeStaffNames(QDataStream& s, const StaffNameList& list)
+{
+    s << quint32(list.size());
+    for (const StaffName& n : list) {
+        s << n.name() << qint32(n.pos());
+    }
+}
+
+static void writeChannel(QDataStream& s, const Channel& c)
+{
+    s << c.name() << c.descr() << c.synti() << qint32(c.color())
+      << qint8(c.volume()) << qint8(c.pan()) << qint8(c.chorus()) << qint8(c.reverb())
+      << qint32(c.program()) << qint32(c.bank()) << qint32(c.channel())
+      << c.mute() << c.solo() << c.userBankController();
+
+    // controllers without a dedicated property, see Channel::read()
+    const std::vector<MidiCoreEvent>& initList = c.initList();
+    std::vector<MidiCoreEvent> extraControllers(initList.begin() + int(Channel::A::INIT_COUNT), initList.end());
+    writeEvents(s, extraControllers);
+
+    writeArticulations(s, c.articulation);
+    writeMidiActions(s, c.midiActions);
+}
+
+static void writeDrumset(QDataStream& s, const Drumset* ds)
+{
+    s << bool(ds);
+    if (!ds) {
+        return;
+    }
+
+    for (int pitch = 0; pitch < DRUM_INSTRUMENTS; ++pitch) {
+        const DrumInstrument& d = ds->drum(pitch);
+        s << d.name << qint32(d.notehead);
+        for (SymId sym : d.noteheads) {
+            s << qint32(sym);
+        }
+        s << qint32(d.line) << qint32(d.stemDirection) << qint32(d.voice) << qint8(d.shortcut);
+
+        s << quint32(d.variants.size());
+        for (const DrumInstrumentVariant& v : d.variants) {
+            s << qint32(v.pitch) << v.articulationName << qint32(v.tremolo);
+        }
+    }
+}
+
+static void writeTemplate(QDataStream& s, const InstrumentTemplate* t)
+{
+    s << t->id << t->trackName;
+    writeStaffNames(s, t->longNames);
+    writeStaffNames(s, t->shortNames);
+    s << t->musicXMLid << t->description << qint32(t->staffCount) << qint32(t->sequenceOrder);
+
+    s << t->trait.name << qint32(t->trait.type) << t->trait.isDefault << t->trait.isHiddenOnScore;
+
+    s << qint8(t->minPitchA) << qint8(t->maxPitchA) << qint8(t->minPitchP) << qint8(t->maxPitchP)
+      << qint8(t->transpose.diatonic) << qint8(t->transpose.chromatic);
+
+    qint32 presetIdx = -1;
+    const std::vector<StaffType>& presets = StaffType::presets();
+    for (size_t i = 0; i < presets.size(); ++i) {
+        if (&presets[i] == t->staffTypePreset) {
+            presetIdx = qint32(i);
+            break;
+        }
+    }
+    s << qint32(t->staffGroup) << presetIdx << t->useDrumset;
+    writeDrumset(s, t->drumset);
+
+    s << qint32(t->stringData.frets()) << quint32(t->stringData.stringList().size());
+    for (const instrString& str : t->stringData.stringList()) {
+        s << qint32(str.pitch) << str.open << qint32(str.startFret);
+    }
+
+    writeMidiActions(s, t->midiActions);
+    writeArticulations(s, t->articulation);
+
+    s << quint32(t->channel.size());
+    for (const Channel& c : t->channel) {
+        writeChannel(s, c);
+    }
+
+    s << quint32(t->genres.size());
+    for (InstrumentGenre* g : t->genres) {
+        s << qint32(instrumentGenres.indexOf(g));
+    }
+    s << qint32(instrumentFamilies.indexOf(t->family));
+
+    for (int i = 0; i < MAX_STAVES; ++i) {
+        s << qint8(t->clefTypes[i]._concertClef) << qint8(t->clefTypes[i]._transposingClef)
+          << qint32(t->staffLines[i]) << qint8(t->bracket[i]) << qint32(t->bracketSpan[i])
+          << qint32(t->barlineSpan[i]) << t->smallStaff[i];
+    }
+
+    s << t->extended << t->singleNoteDynamics << t->groupId;
+}
+
+static void writeOrder(QDataStream& s, const ScoreOrder& order)
+{
+    s << order.id << order.name;
+
+    s << quint32(order.instrumentMap.size());
+    for (auto it = order.instrumentMap.cbegin(); it != order.instrumentMap.cend(); ++it) {
+        s << it.key() << it.value().id << it.value().name;
+    }
+
+    s << quint32(order.groups.size());
+    for (const ScoreGroup& g : order.groups) {
+        // QDataStream keeps null and empty strings apart, as ScoreGroup::unsorted needs
+        s << g.family << g.section << g.unsorted
+          << g.bracket << g.showSystemMarkings << g.barLineSpan << g.thinBracket;
+    }
+}
+
+//---------------------------------------------------------
+//   writeInstrumentTemplatesCache
+//---------------------------------------------------------
+
+bool writeInstrumentTemplatesCache(const QString& cachePath, const QByteArray& sourcesKey)
+{
+    QSaveFile f(cachePath);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qDebug("cannot write instrument templates cache <%s>", qPrintable(cachePath));
+        return false;
+    }
+
+    QDataStream s(&f);
+    s.setVersion(CACHE_STREAM_VERSION);
+    s << CACHE_MAGIC << CACHE_FORMAT_VERSION << sourcesKey;
+
+    s << quint32(instrumentGenres.size());
+    for (const InstrumentGenre* g : qAsConst(instrumentGenres)) {
+        s << g->id << g->name;
+    }
+
+    s << quint32(instrumentFamilies.size());
+    for (const InstrumentFamily* fam : qAsConst(instrumentFamilies)) {
+        s << fam->id << fam->name;
+    }
+
+    writeArticulations(s, articulation);
+
+    s << quint32(instrumentGroups.size());
+    for (const InstrumentGroup* g : qAsConst(instrumentGroups)) {
+        s << g->id << g->name << g->extended << quint32(g->instrumentTemplates.size());
+        for (const InstrumentTemplate* t : g->instrumentTemplates) {
+            writeTemplate(s, t);
+        }
+    }
+
+    s << quint32(instrumentOrders.size());
+    for (const ScoreOrder& order : qAsConst(instrumentOrders)) {
+        writeOrder(s, order);
+    }
+
+    if (s.status() != QDataStream::Ok) {
+        f.cancelWriting();
+        return false;
+    }
+
+    return f.commit();
+}
+
+//---------------------------------------------------------
+//   Reader
+//---------------------------------------------------------
+
+namespace {
+struct CacheReader {
+    QDataStream& s;
+    QList<InstrumentGenre*> genres;
+    QList<InstrumentFamily*> families;
+
+    CacheReader(QDataStream& stream)
+        : s(stream) {}
+
+    //! NOTE Guards the list reservations against a damaged file
+    bool readSize(quint32& size)
+    {
+        s >> size;
+        return s.status() == QDataStream::Ok && size <= quint32(s.device() ? s.device()->size() : 0);
+    }
+
+    template<typename T>
+    T readInt()
+    {
+        T v = 0;
+        s >> v;
+        return v;
+    }
+
+    bool readEvents(std::vector<MidiCoreEvent>& events)
+    {
+        quint32 size = 0;
+        if (!readSize(size)) {
+            return false;
+        }
+        events.reserve(size);
+        for (quint32 i = 0; i < size; ++i) {
+            quint8 type = 0, channel = 0, a = 0, b = 0;
+            s >> type >> channel >> a >> b;
+            events.emplace_back(type, channel, a, b);
+        }
+        return s.status() == QDataStream::Ok;
+    }
+
+    bool readArticulations(QList<MidiArticulation>& list)
+    {
+        quint32 size = 0;
+        if (!readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            MidiArticulation a;
+            s >> a.name >> a.descr;
+            a.velocity = readInt<qint32>();
+            a.gateTime = readInt<qint32>();
+            list.append(a);
+        }
+        return s.status() == QDataStream::Ok;
+    }
+
+    bool readMidiActions(QList<NamedEventList>& list)
+    {
+        quint32 size = 0;
+        if (!readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            NamedEventList a;
+            s >> a.name >> a.descr;
+            if (!readEvents(a.events)) {
+                return false;
+            }
+            list.append(a);
+        }
+        return true;
+    }
+
+    bool readStaffNames(StaffNameList& list)
+    {
+        quint32 size = 0;
+        if (!readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            QString name;
+            s >> name;
+            int pos = readInt<qint32>();
+            list.append(StaffName(name, pos));
+        }
+        return s.status() == QDataStream::Ok;
+    }
+
+    bool readChannel(Channel& c)
+    {
+        QString name, descr, synti;
+        s >> name >> descr >> synti;
+        c.setName(name);
+        c.setDescr(descr);
+        c.setSynti(synti);
+        c.setColor(readInt<qint32>());
+        c.setVolume(readInt<qint8>());
+        c.setPan(readInt<qint8>());
+        c.setChorus(readInt<qint8>());
+        c.setReverb(readInt<qint8>());
+        c.setProgram(readInt<qint32>());
+        c.setBank(readInt<qint32>());
+        c.setChannel(readInt<qint32>());
+
+        bool mute = false, solo = false, userBankController = false;
+        s >> mute >> solo >> userBankController;
+        c.setMute(mute);
+        c.setSolo(solo);
+        c.setUserBankController(userBankController);
+
+        std::vector<MidiCoreEvent> extraControllers;
+        if (!readEvents(extraControllers)) {
+            return false;
+        }
+        std::vector<MidiCoreEvent>& initList = c.initList();
+        initList.insert(initList.end(), extraControllers.begin(), extraControllers.end());
+
+        return readArticulations(c.articulation) && readMidiActions(c.midiActions);
+    }
+
+    bool readDrumset(Drumset*& ds)
+    {
+        bool hasDrumset = false;
+        s >> hasDrumset;
+        if (!hasDrumset) {
+            return s.status() == QDataStream::Ok;
+        }
+
+        ds = new Drumset(*smDrumset);
+        ds->clear();
+
+        for (int pitch = 0; pitch < DRUM_INSTRUMENTS; ++pitch) {
+            DrumInstrument& d = ds->drum(pitch);
+            s >> d.name;
+            d.notehead = NoteHead::Group(readInt<qint32>());
+            for (SymId& sym : d.noteheads) {
+                sym = SymId(readInt<qint32>());
+            }
+            d.line = readInt<qint32>();
+            d.stemDirection = Direction(readInt<qint32>());
+            d.voice = readInt<qint32>();
+            d.shortcut = readInt<qint8>();
+
+            quint32 variantsCount = 0;
+            if (!readSize(variantsCount)) {
+                return false;
+            }
+            d.variants.clear();
+            for (quint32 i = 0; i < variantsCount; ++i) {
+                DrumInstrumentVariant v;
+                v.pitch = readInt<qint32>();
+                s >> v.articulationName;
+                v.tremolo = TremoloType(readInt<qint32>());
+                d.variants.append(v);
+            }
+        }
+        return s.status() == QDataStream::Ok;
+    }
+
+    bool readTemplate(InstrumentTemplate* t)
+    {
+        s >> t->id >> t->trackName;
+        if (!readStaffNames(t->longNames) || !readStaffNames(t->shortNames)) {
+            return false;
+        }
+        s >> t->musicXMLid >> t->description;
+        t->staffCount = readInt<qint32>();
+        t->sequenceOrder = readInt<qint32>();
+
+        s >> t->trait.name;
+        t->trait.type = TraitType(readInt<qint32>());
+        s >> t->trait.isDefault >> t->trait.isHiddenOnScore;
+
+        t->minPitchA = readInt<qint8>();
+        t->maxPitchA = readInt<qint8>();
+        t->minPitchP = readInt<qint8>();
+        t->maxPitchP = readInt<qint8>();
+        t->transpose.diatonic = readInt<qint8>();
+        t->transpose.chromatic = readInt<qint8>();
+
+        t->staffGroup = StaffGroup(readInt<qint32>());
+        qint32 presetIdx = readInt<qint32>();
+        const std::vector<StaffType>& presets = StaffType::presets();
+        t->staffTypePreset = (presetIdx >= 0 && size_t(presetIdx) < presets.size()) ? &presets[presetIdx] : nullptr;
+        s >> t->useDrumset;
+        if (!readDrumset(t->drumset)) {
+            return false;
+        }
+
+        t->stringData.setFrets(readInt<qint32>());
+        quint32 stringsCount = 0;
+        if (!readSize(stringsCount)) {
+            return false;
+        }
+        for (quint32 i = 0; i < stringsCount; ++i) {
+            instrString str;
+            str.pitch = readInt<qint32>();
+            s >> str.open;
+            str.startFret = readInt<qint32>();
+            t->stringData.stringList().append(str);
+        }
+
+        if (!readMidiActions(t->midiActions) || !readArticulations(t->articulation)) {
+            return false;
+        }
+
+        quint32 channelsCount = 0;
+        if (!readSize(channelsCount)) {
+            return false;
+        }
+        for (quint32 i = 0; i < channelsCount; ++i) {
+            Channel c;
+            if (!readChannel(c)) {
+                return false;
+            }
+            t->channel.append(c);
+        }
+
+        quint32 genresCount = 0;
+        if (!readSize(genresCount)) {
+            return false;
+        }
+        for (quint32 i = 0; i < genresCount; ++i) {
+            qint32 idx = readInt<qint32>();
+            if (idx >= 0 && idx < genres.size()) {
+                t->genres.append(genres[idx]);
+            }
+        }
+        qint32 familyIdx = readInt<qint32>();
+        t->family = (familyIdx >= 0 && familyIdx < families.size()) ? families[familyIdx] : nullptr;
+
+        for (int i = 0; i < MAX_STAVES; ++i) {
+            t->clefTypes[i]._concertClef = ClefType(readInt<qint8>());
+            t->clefTypes[i]._transposingClef = ClefType(readInt<qint8>());
+            t->staffLines[i] = readInt<qint32>();
+            t->bracket[i] = BracketType(readInt<qint8>());
+            t->bracketSpan[i] = readInt<qint32>();
+            t->barlineSpan[i] = readInt<qint32>();
+            s >> t->smallStaff[i];
+        }
+
+        s >> t->extended >> t->singleNoteDynamics >> t->groupId;
+
+        return s.status() == QDataStream::Ok;
+    }
+
+    bool readOrder(ScoreOrder& order)
+    {
+        s >> order.id >> order.name;
+
+        quint32 size = 0;
+        if (!readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            QString key;
+            InstrumentOverwrite overwrite;
+            s >> key >> overwrite.id >> overwrite.name;
+            order.instrumentMap.insert(key, overwrite);
+        }
+
+        if (!readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            ScoreGroup g;
+            s >> g.family >> g.section >> g.unsorted
+            >> g.bracket >> g.showSystemMarkings >> g.barLineSpan >> g.thinBracket;
+            order.groups.append(g);
+        }
+
+        return s.status() == QDataStream::Ok;
+    }
+};
+}
+
+//---------------------------------------------------------
+//   loadInstrumentTemplatesCache
+//    replaces the loaded instrument templates on success,
+//    leaves them untouched otherwise
+//---------------------------------------------------------
+
+bool loadInstrumentTemplatesCache(const QString& cachePath, const QByteArray& sourcesKey)
+{
+    QFile f(cachePath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    //! NOTE The file is mapped rather than copied into memory
+    QByteArray data;
+    const uchar* mapped = f.map(0, f.size());
+    if (mapped) {
+        data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), int(f.size()));
+    } else {
+        data = f.readAll();
+    }
+
+    QDataStream s(data);
+    s.setVersion(CACHE_STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    QByteArray key;
+    s >> magic >> formatVersion;
+    if (magic != CACHE_MAGIC || formatVersion != CACHE_FORMAT_VERSION) {
+        return false;
+    }
+    s >> key;
+    if (key != sourcesKey) {
+        return false;
+    }
+
+    CacheReader r(s);
+    QList<MidiArticulation> globalArticulation;
+    QList<InstrumentGroup*> groups;
+    QList<ScoreOrder> orders;
+
+    auto readAll = [&]() {
+        quint32 size = 0;
+        if (!r.readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            InstrumentGenre* g = new InstrumentGenre;
+            s >> g->id >> g->name;
+            r.genres.append(g);
+        }
+
+        if (!r.readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            InstrumentFamily* fam = new InstrumentFamily;
+            s >> fam->id >> fam->name;
+            r.families.append(fam);
+        }
+
+        if (!r.readArticulations(globalArticulation) || !r.readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            InstrumentGroup* g = new InstrumentGroup;
+            groups.append(g);
+
+            quint32 templatesCount = 0;
+            s >> g->id >> g->name >> g->extended;
+            if (!r.readSize(templatesCount)) {
+                return false;
+            }
+            for (quint32 j = 0; j < templatesCount; ++j) {
+                InstrumentTemplate* t = new InstrumentTemplate;
+                g->instrumentTemplates.append(t);
+                if (!r.readTemplate(t)) {
+                    return false;
+                }
+            }
+        }
+
+        if (!r.readSize(size)) {
+            return false;
+        }
+        for (quint32 i = 0; i < size; ++i) {
+            ScoreOrder order;
+            if (!r.readOrder(order)) {
+                return false;
+            }
+            orders.append(order);
+        }
+
+        return s.status() == QDataStream::Ok && s.atEnd();
+    };
+
+    if (!readAll()) {
+        qDebug("damaged instrument templates cache <%s>", qPrintable(cachePath));
+        for (InstrumentGroup* g : qAsConst(groups)) {
+            g->clear();
+        }
+        qDeleteAll(groups);
+        qDeleteAll(r.genres);
+        qDeleteAll(r.families);
+        return false;
+    }
+
+    clearInstrumentTemplates();
+    instrumentGenres = r.genres;
+    instrumentFamilies = r.families;
+    articulation = globalArticulation;
+    instrumentGroups = groups;
+    instrumentOrders = orders;
+
+    return true;
+}
+}
@@ -0,0 +1,43 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __INSTRTEMPLATECACHE_H__
+#define __INSTRTEMPLATECACHE_H__
+
+#include <QString>
+#include <QByteArray>
+
+namespace Ms {
+//---------------------------------------------------------
+//   Instrument templates cache
+//    binary form of the instrument templates, genres,
+//    families, global articulations and score orders
+//    loaded by loadInstrumentTemplates().
+//    sourcesKey identifies the xml files (and the language)
+//    the cache was made from: a cache with another key
+//    is not loaded.
+//---------------------------------------------------------
+
+extern bool writeInstrumentTemplatesCache(const QString& cachePath, const QByteArray& sourcesKey);
+extern bool loadInstrumentTemplatesCache(const QString& cachePath, const QByteArray& sourcesKey);
+}     // namespace Ms
+#endif
@@ -123,6 +123,8 @@ set(LIBMSCORE_SRC
     ${CMAKE_CURRENT_LIST_DIR}/instrchange.h
     ${CMAKE_CURRENT_LIST_DIR}/instrtemplate.cpp
     ${CMAKE_CURRENT_LIST_DIR}/instrtemplate.h
+    ${CMAKE_CURRENT_LIST_DIR}/instrtemplatecache.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/instrtemplatecache.h
     ${CMAKE_CURRENT_LIST_DIR}/instrument.cpp
     ${CMAKE_CURRENT_LIST_DIR}/instrument.h
     ${CMAKE_CURRENT_LIST_DIR}/interval.cpp
@@ -170,6 +170,31 @@ void MasterScore::setPlaylistDirty()
     _repeatList2->setScoreChanged();
 }
 
+//---------------------------------------------------------
+//   addPlaybackChanges
+//---------------------------------------------------------
+
+void MasterScore::addPlaybackChanges(const Fraction& tickFrom, const Fraction& tickTo)
+{
+    if (_playbackChanges.tickFrom < 0 || tickFrom.ticks() < _playbackChanges.tickFrom) {
+        _playbackChanges.tickFrom = tickFrom.ticks();
+    }
+    if (tickTo.ticks() > _playbackChanges.tickTo) {
+        _playbackChanges.tickTo = tickTo.ticks();
+    }
+}
+
+//---------------------------------------------------------
+//   takePlaybackChanges
+//---------------------------------------------------------
+
+PlaybackChanges MasterScore::takePlaybackChanges()
+{
+    PlaybackChanges changes = _playbackChanges;
+    _playbackChanges = PlaybackChanges();
+    return changes;
+}
+
 //---------------------------------------------------------
 //   setExpandRepeats
 //---------------------------------------------------------
@@ -241,7 +266,13 @@ Score::FileError MasterScore::loadMscz(const mu::engraving::MscReader& mscReader
 
         compat::ReadStyleHook styleHook(this, scoreData, completeBaseName);
 
-        XmlReader xml(scoreData);
+        //! NOTE The snapshot is used only if it was made from this score file.
+        //! The score file is still read (for the style defaults and this check), so only its parsing is saved.
+        //! Files without a snapshot are not checksummed
+        QByteArray snapshotData = mscReader.readScoreSnapshotFile();
+        bool useSnapshot = BinaryXml::isSnapshotOf(snapshotData, scoreData);
+
+        XmlReader xml(useSnapshot ? snapshotData : scoreData);
         xml.setDocName(completeBaseName);
         retval = read(xml, ignoreVersionError, &styleHook);
     }
@@ -307,6 +338,8 @@ Score::FileError MasterScore::loadMscz(const mu::engraving::MscReader& mscReader
 
 bool MasterScore::writeMscz(MscWriter& mscWriter, bool onlySelection, bool doCreateThumbnail)
 {
+    TRACEFUNC;
+
     IF_ASSERT_FAILED(mscWriter.isOpened()) {
         return false;
     }
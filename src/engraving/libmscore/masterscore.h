@@ -32,6 +32,20 @@ class ReadStyleHook;
 }
 
 namespace Ms {
+//---------------------------------------------------------
+//   PlaybackChanges
+//    tick range changed by the commands since the playback
+//    has taken the changes last time
+//---------------------------------------------------------
+
+struct PlaybackChanges {
+    int tickFrom = -1;
+    int tickTo = -1;
+    bool all = false;
+
+    bool isEmpty() const { return !all && tickFrom < 0; }
+};
+
 //---------------------------------------------------------
 //   MasterScore
 //---------------------------------------------------------
@@ -46,6 +60,7 @@ class MasterScore : public Score
     RepeatList* _repeatList2;
     bool _expandRepeats     { MScore::playRepeats };
     bool _playlistDirty     { true };
+    PlaybackChanges _playbackChanges;
     QList<Excerpt*> _excerpts;
     std::vector<PartChannelSettingsLink> _playbackSettingsLinks;
     Score* _playbackScore = nullptr;
@@ -53,6 +68,8 @@ class MasterScore : public Score
 
     bool _readOnly          { false };
 
+    size_t _layoutStepPages { 0 };
+
     CmdState _cmdState;       // modified during cmd processing
 
     Fraction _pos[3];                      ///< 0 - current, 1 - left loop, 2 - right loop
@@ -104,6 +121,12 @@ public:
     virtual bool isMaster() const override { return true; }
     virtual bool readOnly() const override { return _readOnly; }
     void setReadOnly(bool ro) { _readOnly = ro; }
+
+    //! NOTE If not 0, a complete layout in update() stops after this count of pages,
+    //! the rest of the pages are laid out by Score::layoutNextPages
+    size_t layoutStepPages() const { return _layoutStepPages; }
+    void setLayoutStepPages(size_t pages) { _layoutStepPages = pages; }
+
     virtual UndoStack* undoStack() const override { return _undoStack; }
     virtual TimeSigMap* sigmap() const override { return _sigmap; }
     virtual TempoMap* tempomap() const override { return _tempomap; }
@@ -112,6 +135,11 @@ public:
     virtual void setPlaylistDirty() override;
     void setPlaylistClean() { _playlistDirty = false; }
 
+    void addPlaybackChanges(const Fraction& tickFrom, const Fraction& tickTo);
+    void setAllPlaybackChanged() { _playbackChanges.all = true; }
+    PlaybackChanges takePlaybackChanges();
+
+    bool expandRepeats() const { return _expandRepeats; }
     void setExpandRepeats(bool expandRepeats);
     void updateRepeatListTempo();
     virtual const RepeatList& repeatList() const override;
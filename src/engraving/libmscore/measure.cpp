@@ -26,6 +26,7 @@
 */
 
 #include <cmath>
+#include <functional>
 
 #include "style/style.h"
 #include "io/xml.h"
@@ -4634,6 +4635,128 @@ static bool hasAccidental(Segment* s)
     return false;
 }
 
+//---------------------------------------------------------
+//   minWidthFingerprint
+//    hash of everything computeMinWidth() depends on:
+//    the segments (shapes are relative to the segment),
+//    the position in the system and the spacing style
+//---------------------------------------------------------
+
+template<typename T>
+static inline void hashCombine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static const Sid MIN_WIDTH_STYLES[] = {
+    Sid::barAccidentalDistance, Sid::barNoteDistance, Sid::noteBarDistance, Sid::minNoteDistance,
+    Sid::clefLeftMargin, Sid::keysigLeftMargin, Sid::timesigLeftMargin, Sid::midClefKeyRightMargin,
+    Sid::clefKeyDistance, Sid::clefTimesigDistance, Sid::clefBarlineDistance, Sid::keyTimesigDistance,
+    Sid::keyBarlineDistance, Sid::timesigBarlineDistance, Sid::systemHeaderDistance, Sid::systemHeaderTimeSigDistance,
+    Sid::ambitusMargin, Sid::endBarWidth, Sid::minMeasureWidth,
+};
+
+size_t Measure::minWidthFingerprint() const
+{
+    size_t seed = 0;
+
+    for (Sid sid : MIN_WIDTH_STYLES) {
+        hashCombine(seed, score()->styleP(sid));
+    }
+    hashCombine(seed, score()->styleD(Sid::measureSpacing));
+    hashCombine(seed, score()->noteHeadWidth());
+    hashCombine(seed, spatium());
+
+    hashCombine(seed, m_userStretch);
+    hashCombine(seed, ticks().ticks());
+    hashCombine(seed, header());
+    hashCombine(seed, isFirstInSystem());
+
+    const MeasureBase* pmb = prev();
+    hashCombine(seed, pmb && pmb->isMeasure() && pmb->system() == system() && toMeasure(pmb)->repeatEnd());
+
+    for (const Staff* staff : score()->staves()) {
+        hashCombine(seed, staff->show());
+    }
+
+    const int tracks = score()->ntracks();
+    for (const Segment* s = first(); s; s = s->next()) {
+        hashCombine(seed, static_cast<int>(s->segmentType()));
+        hashCombine(seed, s->enabled());
+        if (!s->enabled()) {
+            continue;
+        }
+
+        hashCombine(seed, s->visible());
+        hashCombine(seed, s->header());
+        hashCombine(seed, s->rtick().isZero());
+        hashCombine(seed, s->allElementsInvisible());
+        hashCombine(seed, s->extraLeadingSpace().val());
+
+        for (const Shape& shape : s->shapes()) {
+            hashCombine(seed, shape.size());
+            for (const ShapeElement& r : shape) {
+                hashCombine(seed, r.x());
+                hashCombine(seed, r.y());
+                hashCombine(seed, r.width());
+                hashCombine(seed, r.height());
+            }
+        }
+
+        if (s->isChordRestType()) {
+            for (int track = 0; track < tracks; ++track) {
+                const Element* e = s->element(track);
+                hashCombine(seed, e ? (e->isRest() && toRest(e)->isGap() ? 2 : 1) : 0);
+            }
+        } else if (s->isStartRepeatBarLineType()) {
+            const Element* barLine = s->element(0);
+            hashCombine(seed, barLine ? barLine->width() : 0.0);
+        }
+    }
+
+    return seed;
+}
+
+//---------------------------------------------------------
+//   restoreMinWidth
+//---------------------------------------------------------
+
+bool Measure::restoreMinWidth(size_t fingerprint)
+{
+    if (!m_minWidthCache.valid || m_minWidthCache.fingerprint != fingerprint) {
+        return false;
+    }
+
+    size_t i = 0;
+    for (Segment* s = first(); s; s = s->next()) {
+        if (i == m_minWidthCache.segments.size()) {
+            return false;
+        }
+        const std::pair<qreal, qreal>& seg = m_minWidthCache.segments[i++];
+        s->rxpos() = seg.first;
+        s->setWidth(seg.second);
+    }
+
+    setWidth(m_minWidthCache.width);
+    return true;
+}
+
+//---------------------------------------------------------
+//   storeMinWidth
+//---------------------------------------------------------
+
+void Measure::storeMinWidth(size_t fingerprint)
+{
+    m_minWidthCache.segments.clear();
+    for (const Segment* s = first(); s; s = s->next()) {
+        m_minWidthCache.segments.emplace_back(s->rxpos(), s->width());
+    }
+
+    m_minWidthCache.width = width();
+    m_minWidthCache.fingerprint = fingerprint;
+    m_minWidthCache.valid = true;
+}
+
 //---------------------------------------------------------
 //   computeMinWidth
 //    sets the minimum stretched width of segment list s
@@ -4759,6 +4882,16 @@ void Measure::computeMinWidth(Segment* s, qreal x, bool isSystemHeader)
 
 void Measure::computeMinWidth()
 {
+    //! NOTE MM rests are resized by computeMinWidth(Segment*, ...), they are not cached
+    const bool cached = !isMMRest();
+    size_t fingerprint = 0;
+    if (cached) {
+        fingerprint = minWidthFingerprint();
+        if (restoreMinWidth(fingerprint)) {
+            return;
+        }
+    }
+
     Segment* s;
 
     //
@@ -4810,5 +4943,9 @@ void Measure::computeMinWidth()
     bool isSystemHeader = s->header();
 
     computeMinWidth(s, x, isSystemHeader);
+
+    if (cached) {
+        storeMinWidth(fingerprint);
+    }
 }
 }
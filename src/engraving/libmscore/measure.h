@@ -347,6 +347,9 @@ private:
 
     void fillGap(const Fraction& pos, const Fraction& len, int track, const Fraction& stretch, bool useGapRests = true);
     void computeMinWidth(Segment* s, qreal x, bool isSystemHeader);
+    size_t minWidthFingerprint() const;
+    bool restoreMinWidth(size_t fingerprint);
+    void storeMinWidth(size_t fingerprint);
 
     void readVoice(XmlReader& e, int staffIdx, bool irregular);
 
@@ -371,6 +374,16 @@ private:
 
     MeasureNumberMode m_noMode;
     bool m_breakMultiMeasureRest;
+
+    //! NOTE Result of computeMinWidth() for the fingerprint of its input,
+    //! reused by the relayouts which don't change the measure content, position in the system or spacing style
+    struct MinWidthCache {
+        bool valid = false;
+        size_t fingerprint = 0;
+        qreal width = 0.0;
+        std::vector<std::pair<qreal, qreal> > segments;   // x and width of each segment
+    };
+    MinWidthCache m_minWidthCache;
 };
 }     // namespace Ms
 #endif
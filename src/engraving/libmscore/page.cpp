@@ -22,6 +22,9 @@
 
 #include "page.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include <QDateTime>
 
 #include "style/style.h"
@@ -53,6 +56,27 @@ namespace Ms {
 //extern QString revision;
 static QString revision;
 
+//! NOTE Revisions are unique across all pages, so a page allocated
+//! in place of a deleted one never reuses a stale revision
+static uint64_t nextLayoutRevision()
+{
+    static std::atomic<uint64_t> lastRevision { 0 };
+    return ++lastRevision;
+}
+
+//! NOTE The order of elementLessThan without the selection: it changes without
+//! a relayout, so Paint::paintSortedElements paints the selected elements last
+static bool paintOrderLessThan(const Element* e1, const Element* e2)
+{
+    if (e1->z() != e2->z()) {
+        return e1->z() < e2->z();
+    }
+    if (e1->visible() != e2->visible()) {
+        return !e1->visible();
+    }
+    return e1->track() > e2->track();
+}
+
 //---------------------------------------------------------
 //   Page
 //---------------------------------------------------------
@@ -61,6 +85,7 @@ Page::Page(Score* s)
     : Element(s, ElementFlag::NOT_SELECTABLE), _no(0)
 {
     bspTreeValid = false;
+    _layoutRevision = nextLayoutRevision();
 }
 
 Page::~Page()
@@ -98,6 +123,53 @@ QList<Element*> Page::items(const mu::PointF& p)
 #endif
 }
 
+//---------------------------------------------------------
+//   paintItems
+//    all items of the page sorted in paint order;
+//    the list is retained until the next layout of the page
+//---------------------------------------------------------
+
+const std::vector<Element*>& Page::paintItems()
+{
+#ifdef USE_BSP
+    if (!bspTreeValid) {
+        doRebuildBspTree();
+    }
+#endif
+    return _paintItems;
+}
+
+//---------------------------------------------------------
+//   paintItems
+//    the items intersecting r, sorted in paint order
+//---------------------------------------------------------
+
+std::vector<Element*> Page::paintItems(const RectF& r)
+{
+#ifdef USE_BSP
+    if (!bspTreeValid) {
+        doRebuildBspTree();
+    }
+    QList<Element*> el = bspTree.items(r);
+    std::vector<Element*> items(el.begin(), el.end());
+    std::sort(items.begin(), items.end(), paintOrderLessThan);
+    return items;
+#else
+    Q_UNUSED(r)
+    return std::vector<Element*>();
+#endif
+}
+
+//---------------------------------------------------------
+//   invalidateBspTree
+//---------------------------------------------------------
+
+void Page::invalidateBspTree()
+{
+    bspTreeValid = false;
+    _layoutRevision = nextLayoutRevision();
+}
+
 //---------------------------------------------------------
 //   appendSystem
 //---------------------------------------------------------
@@ -233,27 +305,24 @@ void Page::scanElements(void* data, void (* func)(void*, Element*), bool all)
 
 #ifdef USE_BSP
 //---------------------------------------------------------
-//   bspInsert
+//   collectPaintItems
 //---------------------------------------------------------
 
-static void bspInsert(void* bspTree, Element* e)
+static void collectPaintItems(void* data, Element* e)
 {
-    ((BspTree*)bspTree)->insert(e);
-}
-
-static void countElements(void* data, Element* /*e*/)
-{
-    ++(*(int*)data);
+    static_cast<std::vector<Element*>*>(data)->push_back(e);
 }
 
 //---------------------------------------------------------
 //   doRebuildBspTree
+//    rebuilds the bsp tree and the paint ordered item list,
+//    both are invalidated together by layout
 //---------------------------------------------------------
 
 void Page::doRebuildBspTree()
 {
-    int n = 0;
-    scanElements(&n, countElements, false);
+    _paintItems.clear();
+    scanElements(&_paintItems, collectPaintItems, false);
 
     RectF r;
     if (score()->isLayoutMode(LayoutMode::LINE)) {
@@ -271,8 +340,13 @@ void Page::doRebuildBspTree()
         r = abbox();
     }
 
-    bspTree.initialize(r, n);
-    scanElements(&bspTree, &bspInsert, false);
+    bspTree.initialize(r, static_cast<int>(_paintItems.size()));
+    for (Element* e : _paintItems) {
+        bspTree.insert(e);
+    }
+
+    std::stable_sort(_paintItems.begin(), _paintItems.end(), paintOrderLessThan);
+
     bspTreeValid = true;
 }
 
@@ -542,8 +616,7 @@ RectF Page::tbbox()
     qreal x2 = 0.0;
     qreal y1 = height();
     qreal y2 = 0.0;
-    const QList<Element*> el = elements();
-    for (Element* e : el) {
+    for (const Element* e : paintItems()) {
         if (e == this || !e->isPrintable()) {
             continue;
         }
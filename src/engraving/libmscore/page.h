@@ -23,6 +23,8 @@
 #ifndef __PAGE_H__
 #define __PAGE_H__
 
+#include <vector>
+
 #include "config.h"
 #include "element.h"
 #include "bsp.h"
@@ -48,7 +50,9 @@ class Page final : public Element
     BspTree bspTree;
     void doRebuildBspTree();
 #endif
+    std::vector<Element*> _paintItems;    // sorted by z, rebuilt together with bspTree
     bool bspTreeValid;
+    uint64_t _layoutRevision;       // changes whenever layout invalidates the page
 
     QString replaceTextMacros(const QString&) const;
     void drawHeaderFooter(mu::draw::Painter*, int area, const QString&) const;
@@ -86,7 +90,10 @@ public:
 
     QList<Element*> items(const mu::RectF& r);
     QList<Element*> items(const mu::PointF& p);
-    void invalidateBspTree() { bspTreeValid = false; }
+    const std::vector<Element*>& paintItems();
+    std::vector<Element*> paintItems(const mu::RectF& r);
+    void invalidateBspTree();
+    uint64_t layoutRevision() const { return _layoutRevision; }
     mu::PointF pagePos() const override { return mu::PointF(); }       ///< position in page coordinates
     QList<Element*> elements() const;           ///< list of visible elements
     mu::RectF tbbox();                             // tight bounding box, excluding white space
@@ -389,6 +389,9 @@ Score::~Score()
 {
     Score::validScores.erase(this);
 
+    //! NOTE The pending layout refers to the elements which are deleted below
+    cancelLayout();
+
     foreach (MuseScoreView* v, viewer) {
         v->removeScore();
     }
@@ -5196,13 +5199,52 @@ void Score::doLayout()
     doLayoutRange(Fraction(0, 1), Fraction(-1, 1));
 }
 
-void Score::doLayoutRange(const Fraction& st, const Fraction& et)
+void Score::doLayoutRange(const Fraction& st, const Fraction& et, size_t maxPages)
 {
     _scoreFont = ScoreFont::fontByName(style().value(Sid::MusicalSymbolFont).toString());
     _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / SPATIUM20);
 
     m_layoutOptions.updateFromStyle(style());
-    m_layout.doLayoutRange(m_layoutOptions, st, et);
+    m_layout.doLayoutRange(m_layoutOptions, st, et, maxPages);
+}
+
+bool Score::isLayoutPending() const
+{
+    return m_layout.isLayoutPending();
+}
+
+bool Score::isLayoutComplete() const
+{
+    return m_layout.isLayoutComplete();
+}
+
+//---------------------------------------------------------
+//   layoutNextPages
+//    continue the pending layout, see MasterScore::setLayoutStepPages
+//---------------------------------------------------------
+
+void Score::layoutNextPages(size_t pagesCount)
+{
+    m_layout.layoutNextPages(pagesCount);
+}
+
+//---------------------------------------------------------
+//   finishLayout
+//    lay out all the pages which are still missing
+//---------------------------------------------------------
+
+void Score::finishLayout()
+{
+    if (isLayoutPending()) {
+        m_layout.layoutNextPages(0);
+    } else if (!isLayoutComplete()) {
+        doLayout();
+    }
+}
+
+void Score::cancelLayout()
+{
+    m_layout.cancelLayout();
 }
 
 UndoStack* Score::undoStack() const { return _masterScore->undoStack(); }
@@ -1092,7 +1092,13 @@ public:
     void removeAudio();
 
     void doLayout();
-    void doLayoutRange(const Fraction& st, const Fraction& et);
+    void doLayoutRange(const Fraction& st, const Fraction& et, size_t maxPages = 0);
+
+    bool isLayoutPending() const;
+    bool isLayoutComplete() const;
+    void layoutNextPages(size_t pagesCount);
+    void finishLayout();
+    void cancelLayout();
 
     SynthesizerState& synthesizerState() { return _synthesizerState; }
     void setSynthesizerState(const SynthesizerState& s);
@@ -515,11 +515,8 @@ void Score::print(mu::draw::Painter* painter, int pageNo)
     _printing  = true;
     MScore::pdfPrinting = true;
     Page* page = pages().at(pageNo);
-    RectF fr  = page->abbox();
 
-    QList<Element*> ell = page->items(fr);
-    std::stable_sort(ell.begin(), ell.end(), elementLessThan);
-    for (const Element* e : qAsConst(ell)) {
+    for (const Element* e : page->paintItems()) {
         if (!e->visible()) {
             continue;
         }
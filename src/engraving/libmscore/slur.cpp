@@ -377,21 +377,9 @@ void SlurSegment::computeBezier(mu::PointF p6o)
     ups(Grip::DRAG).p     = t.map(p5);
     ups(Grip::SHOULDER).p = t.map(p6);
 
-    _shape.clear();
-    PointF start = pp1;
     int nbShapes  = 32;    // (pp2.x() - pp1.x()) / _spatium;
     qreal minH    = qAbs(3 * w);
-    const CubicBezier b(pp1, ups(Grip::BEZIER1).pos(), ups(Grip::BEZIER2).pos(), ups(Grip::END).pos());
-    for (int i = 1; i <= nbShapes; i++) {
-        const PointF point = b.pointAtPercent(i / float(nbShapes));
-        RectF re     = RectF(start, point).normalized();
-        if (re.height() < minH) {
-            qreal d1 = (minH - re.height()) * .5;
-            re.adjust(0.0, -d1, 0.0, d1);
-        }
-        _shape.add(re);
-        start = point;
-    }
+    updateShape(pp1, Bezier::fromPoints(pp1, ups(Grip::BEZIER1).pos(), ups(Grip::BEZIER2).pos(), ups(Grip::END).pos()), nbShapes, minH);
 }
 
 //---------------------------------------------------------
@@ -21,6 +21,8 @@
  */
 #include "slurtie.h"
 
+#include <QVarLengthArray>
+
 #include "draw/pen.h"
 #include "io/xml.h"
 
@@ -57,6 +59,40 @@ SlurTieSegment::SlurTieSegment(const SlurTieSegment& b)
     path = b.path;
 }
 
+//---------------------------------------------------------
+//   updateShape
+//    approximate the bezier by rectsCount rects at least minH high,
+//    the first one from start to the first flattened point,
+//    the shape is kept while the bezier doesn't change
+//---------------------------------------------------------
+
+void SlurTieSegment::updateShape(const PointF& start, const Bezier& bezier, size_t rectsCount, qreal minH)
+{
+    if (m_shapeRectsCount == rectsCount && m_shapeMinH == minH && m_shapeStart == start && m_shapeBezier == bezier) {
+        return;
+    }
+
+    m_shapeStart = start;
+    m_shapeBezier = bezier;
+    m_shapeRectsCount = rectsCount;
+    m_shapeMinH = minH;
+
+    QVarLengthArray<PointF, 32> points(static_cast<int>(rectsCount));
+    bezier.flatten(rectsCount, points.data());
+
+    _shape.clear();
+    PointF rectStart = start;
+    for (const PointF& point : points) {
+        RectF re = RectF(rectStart, point).normalized();
+        if (re.height() < minH) {
+            qreal d = (minH - re.height()) * .5;
+            re.adjust(0.0, -d, 0.0, d);
+        }
+        _shape.add(re);
+        rectStart = point;
+    }
+}
+
 //---------------------------------------------------------
 //   gripAnchorLines
 //---------------------------------------------------------
@@ -55,33 +55,6 @@ struct UP {
     bool operator!=(const UP& up) const { return p != up.p || off != up.off; }
 };
 
-//---------------------------------------------------------
-//   CubicBezier
-//    Helper class to optimize cubic Bezier curve points
-//    calculation.
-//---------------------------------------------------------
-
-class CubicBezier
-{
-    mu::PointF p1;
-    mu::PointF p2;
-    mu::PointF p3;
-    mu::PointF p4;
-
-public:
-    CubicBezier(mu::PointF _p1, mu::PointF _p2, mu::PointF _p3, mu::PointF _p4)
-        : p1(_p1), p2(_p2), p3(_p3), p4(_p4) {}
-
-    mu::PointF pointAtPercent(qreal t) const
-    {
-        Q_ASSERT(t >= 0.0 && t <= 1.0);
-        const qreal r = 1.0 - t;
-        const mu::PointF B123 = r * (r * p1 + t * p2) + t * (r * p2 + t * p3);
-        const mu::PointF B234 = r * (r * p2 + t * p3) + t * (r * p3 + t * p4);
-        return r * B123 + t * B234;
-    }
-};
-
 class SlurTie;
 
 //---------------------------------------------------------
@@ -100,6 +73,15 @@ protected:
     virtual void changeAnchor(EditData&, Element*) = 0;
     QVector<mu::LineF> gripAnchorLines(Grip grip) const override;
 
+    void updateShape(const mu::PointF& start, const mu::Bezier& bezier, size_t rectsCount, qreal minH);
+    void invalidateShape() { m_shapeRectsCount = 0; }
+
+private:
+    mu::PointF m_shapeStart;            // the first rect starts here
+    mu::Bezier m_shapeBezier;           // the _shape approximates this bezier
+    size_t m_shapeRectsCount = 0;
+    qreal m_shapeMinH = 0.0;
+
 public:
     SlurTieSegment(Score*);
     SlurTieSegment(const SlurTieSegment&);
@@ -1189,7 +1189,7 @@ void Spanner::setTick(const Fraction& v)
 {
     _tick = v;
     if (score()) {
-        score()->spannerMap().setDirty();
+        score()->spannerMap().updateSpanner(this);
     }
 }
 
@@ -1210,7 +1210,7 @@ void Spanner::setTicks(const Fraction& f)
 {
     _ticks = f;
     if (score()) {
-        score()->spannerMap().setDirty();
+        score()->spannerMap().updateSpanner(this);
     }
 }
 
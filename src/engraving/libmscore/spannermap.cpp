@@ -26,6 +26,23 @@
 using namespace mu;
 
 namespace Ms {
+//---------------------------------------------------------
+//   nodePriority
+//    deterministic pseudo-random treap priority, so that
+//    the tree shape does not depend on the run
+//---------------------------------------------------------
+
+static unsigned nodePriority(unsigned seq)
+{
+    unsigned x = seq * 0x9E3779B9u;
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
 //---------------------------------------------------------
 //   SpannerMap
 //---------------------------------------------------------
@@ -33,21 +50,157 @@ namespace Ms {
 SpannerMap::SpannerMap()
     : std::multimap<int, Spanner*>()
 {
-    dirty = true;
+    dirty = false;
+    root = -1;
+    nextSeq = 0;
+}
+
+//---------------------------------------------------------
+//   lessThan
+//---------------------------------------------------------
+
+bool SpannerMap::lessThan(const Node& a, const Node& b)
+{
+    return a.start < b.start || (a.start == b.start && a.seq < b.seq);
+}
+
+//---------------------------------------------------------
+//   pull
+//    recompute the subtree maximum of node n
+//---------------------------------------------------------
+
+void SpannerMap::pull(int n) const
+{
+    Node& node = nodes[n];
+    node.maxStop = node.stop;
+    if (node.left >= 0) {
+        node.maxStop = std::max(node.maxStop, nodes[node.left].maxStop);
+    }
+    if (node.right >= 0) {
+        node.maxStop = std::max(node.maxStop, nodes[node.right].maxStop);
+    }
+}
+
+//---------------------------------------------------------
+//   split
+//    l receives the nodes ordered before key, r the rest
+//---------------------------------------------------------
+
+void SpannerMap::split(int t, const Node& key, int& l, int& r) const
+{
+    if (t < 0) {
+        l = r = -1;
+        return;
+    }
+    if (lessThan(nodes[t], key)) {
+        split(nodes[t].right, key, nodes[t].right, r);
+        l = t;
+    } else {
+        split(nodes[t].left, key, l, nodes[t].left);
+        r = t;
+    }
+    pull(t);
+}
+
+//---------------------------------------------------------
+//   merge
+//    all nodes of l are ordered before the nodes of r
+//---------------------------------------------------------
+
+int SpannerMap::merge(int l, int r) const
+{
+    if (l < 0) {
+        return r;
+    }
+    if (r < 0) {
+        return l;
+    }
+    if (nodes[l].priority > nodes[r].priority) {
+        nodes[l].right = merge(nodes[l].right, r);
+        pull(l);
+        return l;
+    }
+    nodes[r].left = merge(l, nodes[r].left);
+    pull(r);
+    return r;
+}
+
+//---------------------------------------------------------
+//   insertNode
+//    insert the detached node n into subtree t
+//---------------------------------------------------------
+
+int SpannerMap::insertNode(int t, int n) const
+{
+    if (t < 0) {
+        return n;
+    }
+    if (nodes[n].priority > nodes[t].priority) {
+        split(t, nodes[n], nodes[n].left, nodes[n].right);
+        pull(n);
+        return n;
+    }
+    if (lessThan(nodes[n], nodes[t])) {
+        nodes[t].left = insertNode(nodes[t].left, n);
+    } else {
+        nodes[t].right = insertNode(nodes[t].right, n);
+    }
+    pull(t);
+    return t;
+}
+
+//---------------------------------------------------------
+//   eraseNode
+//    detach the node with the given key from subtree t
+//---------------------------------------------------------
+
+int SpannerMap::eraseNode(int t, const Node& key) const
+{
+    if (t < 0) {
+        return -1;
+    }
+    if (nodes[t].seq == key.seq && nodes[t].start == key.start) {
+        return merge(nodes[t].left, nodes[t].right);
+    }
+    if (lessThan(key, nodes[t])) {
+        nodes[t].left = eraseNode(nodes[t].left, key);
+    } else {
+        nodes[t].right = eraseNode(nodes[t].right, key);
+    }
+    pull(t);
+    return t;
+}
+
+//---------------------------------------------------------
+//   rekey
+//    move node n to the current ticks of its spanner
+//---------------------------------------------------------
+
+void SpannerMap::rekey(int n) const
+{
+    root = eraseNode(root, nodes[n]);
+    Node& node = nodes[n];
+    node.start = node.spanner->tick().ticks();
+    node.stop = node.spanner->tick2().ticks();
+    node.maxStop = node.stop;
+    node.left = -1;
+    node.right = -1;
+    root = insertNode(root, n);
 }
 
 //---------------------------------------------------------
 //   update
-//   updates the internal lookup tree, not the map itself
+//    updates the internal lookup tree, not the map itself
 //---------------------------------------------------------
 
 void SpannerMap::update() const
 {
-    std::vector<interval_tree::Interval<Spanner*> > intervals;
-    for (auto i : *this) {
-        intervals.push_back(interval_tree::Interval<Spanner*>(i.second->tick().ticks(), i.second->tick2().ticks(), i.second));
+    for (const auto& i : entries) {
+        const Node& node = nodes[i.second.node];
+        if (node.start != i.first->tick().ticks() || node.stop != i.first->tick2().ticks()) {
+            rekey(i.second.node);
+        }
     }
-    tree = interval_tree::IntervalTree<Spanner*>(intervals);
     dirty = false;
 }
 
@@ -61,7 +214,10 @@ const std::vector<interval_tree::Interval<Spanner*> >& SpannerMap::findContained
         update();
     }
     results.clear();
-    tree.findContained(start, stop, results);
+    auto collect = [this](const Node& n) {
+        results.push_back(interval_tree::Interval<Spanner*>(n.start, n.stop, n.spanner));
+    };
+    visitContained(root, start, stop, collect);
     return results;
 }
 
@@ -75,7 +231,10 @@ const std::vector<interval_tree::Interval<Spanner*> >& SpannerMap::findOverlappi
         update();
     }
     results.clear();
-    tree.findOverlapping(start, stop, results);
+    auto collect = [this](const Node& n) {
+        results.push_back(interval_tree::Interval<Spanner*>(n.start, n.stop, n.spanner));
+    };
+    visitOverlapping(root, start, stop, collect);
     return results;
 }
 
@@ -85,8 +244,33 @@ const std::vector<interval_tree::Interval<Spanner*> >& SpannerMap::findOverlappi
 
 void SpannerMap::addSpanner(Spanner* s)
 {
-    insert(std::pair<int, Spanner*>(s->tick().ticks(), s));
-    dirty = true;
+    if (entries.find(s) != entries.end()) {
+        qDebug("%s (%p) already added", s->name(), s);
+        return;
+    }
+
+    int n;
+    if (freeNodes.empty()) {
+        n = int(nodes.size());
+        nodes.emplace_back();
+    } else {
+        n = freeNodes.back();
+        freeNodes.pop_back();
+    }
+
+    Node& node = nodes[n];
+    node.start = s->tick().ticks();
+    node.stop = s->tick2().ticks();
+    node.maxStop = node.stop;
+    node.seq = nextSeq++;
+    node.priority = nodePriority(node.seq);
+    node.left = -1;
+    node.right = -1;
+    node.spanner = s;
+    root = insertNode(root, n);
+
+    auto it = insert(std::pair<int, Spanner*>(node.start, s));
+    entries.emplace(s, Entry { it, n });
 }
 
 //---------------------------------------------------------
@@ -95,15 +279,49 @@ void SpannerMap::addSpanner(Spanner* s)
 
 bool SpannerMap::removeSpanner(Spanner* s)
 {
-    for (auto i = begin(); i != end(); ++i) {
-        if (i->second == s) {
-            erase(i);
-            dirty = true;
-            return true;
-        }
+    auto i = entries.find(s);
+    if (i == entries.end()) {
+        qDebug("%s (%p) not found", s->name(), s);
+        return false;
     }
-    qDebug("%s (%p) not found", s->name(), s);
-    return false;
+    const Entry& e = i->second;
+    root = eraseNode(root, nodes[e.node]);
+    nodes[e.node].spanner = nullptr;
+    freeNodes.push_back(e.node);
+    erase(e.it);
+    entries.erase(i);
+    return true;
+}
+
+//---------------------------------------------------------
+//   updateSpanner
+//---------------------------------------------------------
+
+void SpannerMap::updateSpanner(Spanner* s)
+{
+    auto i = entries.find(s);
+    if (i == entries.end()) {
+        return;
+    }
+    const Node& node = nodes[i->second.node];
+    if (node.start != s->tick().ticks() || node.stop != s->tick2().ticks()) {
+        rekey(i->second.node);
+    }
+}
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void SpannerMap::clear()
+{
+    std::multimap<int, Spanner*>::clear();
+    nodes.clear();
+    freeNodes.clear();
+    entries.clear();
+    root = -1;
+    nextSeq = 0;
+    dirty = false;
 }
 
 #ifndef NDEBUG
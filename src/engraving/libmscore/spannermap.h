@@ -24,6 +24,8 @@
 #define __SPANNERMAP_H__
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include "thirdparty/intervaltree/IntervalTree.h"
 
 namespace Ms {
@@ -31,18 +33,112 @@ class Spanner;
 
 //---------------------------------------------------------
 //   SpannerMap
+//    The lookup tree is a treap ordered by (start tick,
+//    insertion sequence) and augmented with the maximum
+//    end tick of each subtree. Spanners are inserted,
+//    removed and re-keyed individually in O(log n); queries
+//    visit the matching spanners in start tick order.
 //---------------------------------------------------------
 
 class SpannerMap : std::multimap<int, Spanner*>
 {
+    struct Node {
+        int start;
+        int stop;
+        int maxStop;
+        unsigned seq;
+        unsigned priority;
+        int left;
+        int right;
+        Spanner* spanner;
+    };
+
+    struct Entry {
+        std::multimap<int, Spanner*>::iterator it;
+        int node;
+    };
+
     mutable bool dirty;
-    mutable interval_tree::IntervalTree<Spanner*> tree;
+    mutable std::vector<Node> nodes;
+    mutable int root;
+    std::vector<int> freeNodes;
+    std::unordered_map<Spanner*, Entry> entries;
+    unsigned nextSeq;
     std::vector<interval_tree::Interval<Spanner*> > results;
 
+    static bool lessThan(const Node& a, const Node& b);
+    void pull(int n) const;
+    void split(int t, const Node& key, int& l, int& r) const;
+    int merge(int l, int r) const;
+    int insertNode(int t, int n) const;
+    int eraseNode(int t, const Node& key) const;
+    void rekey(int n) const;
+
+    template<typename F>
+    void visitOverlapping(int t, int start, int stop, F& f) const
+    {
+        if (t < 0 || nodes[t].maxStop < start) {
+            return;
+        }
+        const Node& n = nodes[t];
+        visitOverlapping(n.left, start, stop, f);
+        if (n.start > stop) {
+            return;
+        }
+        if (n.stop >= start) {
+            f(n);
+        }
+        visitOverlapping(n.right, start, stop, f);
+    }
+
+    template<typename F>
+    void visitContained(int t, int start, int stop, F& f) const
+    {
+        if (t < 0) {
+            return;
+        }
+        const Node& n = nodes[t];
+        if (n.start >= start) {
+            visitContained(n.left, start, stop, f);
+        }
+        if (n.start > stop) {
+            return;
+        }
+        if (n.start >= start && n.stop <= stop) {
+            f(n);
+        }
+        visitContained(n.right, start, stop, f);
+    }
+
 public:
     SpannerMap();
+    SpannerMap(const SpannerMap&) = delete;
+    SpannerMap& operator=(const SpannerMap&) = delete;
     const std::vector<interval_tree::Interval<Spanner*> >& findContained(int start, int stop);
     const std::vector<interval_tree::Interval<Spanner*> >& findOverlapping(int start, int stop);
+
+    //! NOTE The visitors below do not copy the results and can be nested,
+    //! but the callback must not add or remove spanners of this map.
+    template<typename F>
+    void forEachOverlapping(int start, int stop, F f) const
+    {
+        if (dirty) {
+            update();
+        }
+        auto visit = [&f](const Node& n) { f(n.spanner); };
+        visitOverlapping(root, start, stop, visit);
+    }
+
+    template<typename F>
+    void forEachContained(int start, int stop, F f) const
+    {
+        if (dirty) {
+            update();
+        }
+        auto visit = [&f](const Node& n) { f(n.spanner); };
+        visitContained(root, start, stop, visit);
+    }
+
     const std::multimap<int, Spanner*>& map() const { return *this; }
     std::multimap<int, Spanner*>::const_reverse_iterator crbegin() const { return std::multimap<int, Spanner*>::crbegin(); }
     std::multimap<int, Spanner*>::const_reverse_iterator crend() const { return std::multimap<int, Spanner*>::crend(); }
@@ -50,9 +146,10 @@ public:
     std::multimap<int, Spanner*>::const_iterator cend() const { return std::multimap<int, Spanner*>::cend(); }
     void addSpanner(Spanner* s);
     bool removeSpanner(Spanner* s);
-    void clear() { std::multimap<int, Spanner*>::clear(); dirty = true; }
+    void updateSpanner(Spanner* s);     // must be called if a spanner changes start/length
+    void clear();
     void update() const;
-    void setDirty() const { dirty = true; }     // must be called if a spanner changes start/length
+    void setDirty() const { dirty = true; }     // re-checks the ticks of all spanners on the next query
 #ifndef NDEBUG
     void dump() const;
 #endif
@@ -326,23 +326,10 @@ void TieSegment::computeBezier(PointF p6o)
 //      path.translate(staffOffset);
 //      shapePath.translate(staffOffset);
 
-    _shape.clear();
-    PointF start;
-    start = t.map(start);
-
+    //! NOTE The first rect starts at the translated origin, which includes the tab staff offset
     qreal minH = qAbs(3.0 * w);
     int nbShapes = 15;
-    const CubicBezier b(pp1, ups(Grip::BEZIER1).pos(), ups(Grip::BEZIER2).pos(), ups(Grip::END).pos());
-    for (int i = 1; i <= nbShapes; i++) {
-        const PointF point = b.pointAtPercent(i / float(nbShapes));
-        RectF re = RectF(start, point).normalized();
-        if (re.height() < minH) {
-            d = (minH - re.height()) * .5;
-            re.adjust(0.0, -d, 0.0, d);
-        }
-        _shape.add(re);
-        start = point;
-    }
+    updateShape(t.map(PointF()), Bezier::fromPoints(pp1, ups(Grip::BEZIER1).pos(), ups(Grip::BEZIER2).pos(), ups(Grip::END).pos()), nbShapes, minH);
 }
 
 //---------------------------------------------------------
@@ -430,6 +417,7 @@ void TieSegment::setAutoAdjust(const PointF& offset)
         path.translate(diff);
         shapePath.translate(diff);
         _shape.translate(diff);
+        invalidateShape();
         for (int i = 0; i < int(Grip::GRIPS); ++i) {
             _ups[i].p += diff;
         }
@@ -106,3 +106,28 @@ void Paint::paintElements(mu::draw::Painter& painter, const QList<Element*>& ele
         paintElement(painter, element);
     }
 }
+
+void Paint::paintSortedElements(mu::draw::Painter& painter, const std::vector<Element*>& elements)
+{
+    //! NOTE The selection is not part of the retained order, it changes without a relayout
+    std::vector<const Element*> selected;
+
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const Element* element = elements[i];
+        if (element->isInteractionAvailable()) {
+            if (element->selected()) {
+                selected.push_back(element);
+            } else {
+                paintElement(painter, element);
+            }
+        }
+
+        bool zLevelEnd = i + 1 == elements.size() || elements[i + 1]->z() != element->z();
+        if (zLevelEnd && !selected.empty()) {
+            for (const Element* selectedElement : selected) {
+                paintElement(painter, selectedElement);
+            }
+            selected.clear();
+        }
+    }
+}
@@ -22,8 +22,10 @@
 #ifndef MU_ENGRAVING_PAINT_H
 #define MU_ENGRAVING_PAINT_H
 
+#include <vector>
 #include <QList>
 #include "infrastructure/draw/painter.h"
+#include "infrastructure/draw/geometry.h"
 
 namespace Ms {
 class Element;
@@ -37,6 +39,10 @@ public:
     static void paintElement(mu::draw::Painter& painter, const Ms::Element* element);
     static void paintElements(mu::draw::Painter& painter, const QList<Ms::Element*>& elements);
 
+    //! NOTE Elements must already be in paint order (see Page::paintItems),
+    //! the selected ones are painted last within their z level, like elementLessThan does
+    static void paintSortedElements(mu::draw::Painter& painter, const std::vector<Ms::Element*>& elements);
+
 private:
 
     static void initDebugger(mu::draw::Painter& painter, const Ms::Element* element);
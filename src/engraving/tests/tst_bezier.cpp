@@ -0,0 +1,210 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+ */
+
+#include <random>
+
+#include "testing/qtestsuite.h"
+#include "testbase.h"
+#include "infrastructure/draw/bezier.h"
+#include "infrastructure/draw/painterpath.h"
+#include "libmscore/masterscore.h"
+
+static const QString BEZIER_DATA_DIR("measure_data/");
+
+using namespace mu;
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestBezier
+//---------------------------------------------------------
+
+class TestBezier : public QObject, public MTest
+{
+    Q_OBJECT
+
+    std::vector<Bezier> m_beziers;
+
+private slots:
+    void initTestCase();
+    void flatten();
+    void boundingRect();
+    void pathBoundingRect();
+    void benchmarkPointAt();
+    void benchmarkFlatten();
+    void benchmarkBoundingRect();
+    void benchmarkSlursLayout();
+};
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBezier::initTestCase()
+{
+    initMTest();
+
+    std::mt19937 generator(2022);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    for (int i = 0; i < 1000; ++i) {
+        m_beziers.emplace_back(coord(generator), coord(generator), coord(generator), coord(generator),
+                               coord(generator), coord(generator), coord(generator), coord(generator));
+    }
+
+    // the quadratic and linear cases of the extrema
+    m_beziers.emplace_back(0.0, 0.0, 10.0, 5.0, 20.0, 5.0, 30.0, 0.0);
+    m_beziers.emplace_back(0.0, 0.0, 10.0, 0.0, 20.0, 0.0, 30.0, 0.0);
+    m_beziers.emplace_back(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+}
+
+//---------------------------------------------------------
+//   flatten
+//    the same points as pointAt
+//---------------------------------------------------------
+
+void TestBezier::flatten()
+{
+    const size_t count = 32;
+    PointF points[count];
+
+    for (const Bezier& b : m_beziers) {
+        b.flatten(count, points);
+        for (size_t i = 0; i < count; ++i) {
+            const PointF expected = b.pointAt(static_cast<double>(i + 1) / count);
+            QVERIFY(std::abs(points[i].x() - expected.x()) < 1e-9);
+            QVERIFY(std::abs(points[i].y() - expected.y()) < 1e-9);
+        }
+        QCOMPARE(points[count - 1], b.pt4());
+    }
+}
+
+//---------------------------------------------------------
+//   boundingRect
+//    contains all the points of the curve, and not more
+//---------------------------------------------------------
+
+void TestBezier::boundingRect()
+{
+    const int samples = 2000;
+
+    for (const Bezier& b : m_beziers) {
+        const RectF rect = b.boundingRect();
+
+        double minx = b.pt1().x();
+        double maxx = minx;
+        double miny = b.pt1().y();
+        double maxy = miny;
+        for (int i = 1; i <= samples; ++i) {
+            const PointF p = b.pointAt(static_cast<double>(i) / samples);
+            minx = std::min(minx, p.x());
+            maxx = std::max(maxx, p.x());
+            miny = std::min(miny, p.y());
+            maxy = std::max(maxy, p.y());
+        }
+
+        const double eps = 1e-9;
+        QVERIFY(rect.left() <= minx + eps && rect.right() >= maxx - eps);
+        QVERIFY(rect.top() <= miny + eps && rect.bottom() >= maxy - eps);
+
+        // the sampling misses the extrema by less than this
+        const double tightness = 1e-2;
+        QVERIFY(minx - rect.left() < tightness && rect.right() - maxx < tightness);
+        QVERIFY(miny - rect.top() < tightness && rect.bottom() - maxy < tightness);
+    }
+}
+
+//---------------------------------------------------------
+//   pathBoundingRect
+//---------------------------------------------------------
+
+void TestBezier::pathBoundingRect()
+{
+    const Bezier& b = m_beziers.front();
+
+    PainterPath path;
+    path.moveTo(b.pt1());
+    path.cubicTo(b.pt2(), b.pt3(), b.pt4());
+    path.lineTo(PointF(200.0, 200.0));
+
+    const RectF curve = b.boundingRect();
+    const RectF expected(curve.left(), curve.top(), 200.0 - curve.left(), 200.0 - curve.top());
+    QCOMPARE(path.boundingRect(), expected);
+}
+
+//---------------------------------------------------------
+//   benchmarks
+//---------------------------------------------------------
+
+void TestBezier::benchmarkPointAt()
+{
+    const size_t count = 32;
+    PointF points[count];
+
+    QBENCHMARK {
+        for (const Bezier& b : m_beziers) {
+            for (size_t i = 0; i < count; ++i) {
+                points[i] = b.pointAt(static_cast<double>(i + 1) / count);
+            }
+        }
+    }
+}
+
+void TestBezier::benchmarkFlatten()
+{
+    const size_t count = 32;
+    PointF points[count];
+
+    QBENCHMARK {
+        for (const Bezier& b : m_beziers) {
+            b.flatten(count, points);
+        }
+    }
+}
+
+void TestBezier::benchmarkBoundingRect()
+{
+    double area = 0.0;
+
+    QBENCHMARK {
+        for (const Bezier& b : m_beziers) {
+            const RectF r = b.boundingRect();
+            area += r.width() * r.height();
+        }
+    }
+
+    QVERIFY(area > 0.0);
+}
+
+void TestBezier::benchmarkSlursLayout()
+{
+    MasterScore* score = readScore(BEZIER_DATA_DIR + "measure-2.mscx");
+    QVERIFY(score);
+
+    QBENCHMARK {
+        score->doLayout();
+    }
+
+    delete score;
+}
+
+QTEST_MAIN(TestBezier)
+#include "tst_bezier.moc"
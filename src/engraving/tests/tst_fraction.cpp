@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "testing/qtestsuite.h"
+
+#include "libmscore/fraction.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestFraction
+//---------------------------------------------------------
+
+class TestFraction : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addition();
+    void subtraction();
+    void comparison();
+    void multiplication();
+    void largeDenominators();
+    void ticks();
+    void benchmarkLayoutMix();
+};
+
+//---------------------------------------------------------
+//   addition
+//---------------------------------------------------------
+
+void TestFraction::addition()
+{
+    // equal denominators keep the denominator unreduced
+    QVERIFY((Fraction(1, 8) + Fraction(3, 8)).identical(Fraction(4, 8)));
+
+    // one denominator divides the other
+    QVERIFY((Fraction(1, 4) + Fraction(1, 8)).identical(Fraction(3, 8)));
+    QVERIFY((Fraction(1, 8) + Fraction(1, 4)).identical(Fraction(3, 8)));
+    QVERIFY((Fraction(1, 3) + Fraction(1, 12)).identical(Fraction(5, 12)));
+
+    // general case uses the lcm
+    QVERIFY((Fraction(1, 6) + Fraction(1, 4)).identical(Fraction(5, 12)));
+    QVERIFY((Fraction(1, 3) + Fraction(1, 5)).identical(Fraction(8, 15)));
+}
+
+//---------------------------------------------------------
+//   subtraction
+//---------------------------------------------------------
+
+void TestFraction::subtraction()
+{
+    QCOMPARE(Fraction(1, 4) - Fraction(1, 2), Fraction(-1, 4));
+    QCOMPARE(Fraction(3, 8) - Fraction(1, 8), Fraction(1, 4));
+    QCOMPARE(Fraction(1, 3) - Fraction(1, 5), Fraction(2, 15));
+    QVERIFY((Fraction(3, 4) - Fraction(3, 4)).isZero());
+}
+
+//---------------------------------------------------------
+//   comparison
+//---------------------------------------------------------
+
+void TestFraction::comparison()
+{
+    QVERIFY(Fraction(2, 4) == Fraction(1, 2));
+    QVERIFY(!Fraction(2, 4).identical(Fraction(1, 2)));
+    QVERIFY(Fraction(1, 3) != Fraction(1, 4));
+    QVERIFY(Fraction(3, 8) < Fraction(4, 8));
+    QVERIFY(Fraction(3, 4) > Fraction(2, 3));
+    QVERIFY(Fraction(2, 4) <= Fraction(1, 2));
+    QVERIFY(Fraction(-1, 4) < Fraction(0, 1));
+}
+
+//---------------------------------------------------------
+//   multiplication
+//---------------------------------------------------------
+
+void TestFraction::multiplication()
+{
+    QVERIFY((Fraction(3, 4) * Fraction(2, 3)).identical(Fraction(1, 2)));
+    QVERIFY((Fraction(3, 8) / Fraction(3, 4)).identical(Fraction(1, 2)));
+    QVERIFY((Fraction(1, 8) * 3).identical(Fraction(3, 8)));
+    QVERIFY((Fraction(6, 8) / 2).identical(Fraction(3, 8)));
+    QVERIFY(Fraction(-2, 3).inverse().identical(Fraction(-3, 2)));
+}
+
+//---------------------------------------------------------
+//   largeDenominators
+//    sums of many tuplet durations must stay exact
+//---------------------------------------------------------
+
+void TestFraction::largeDenominators()
+{
+    Fraction sum(0, 1);
+    for (int i = 0; i < 1000; ++i) {
+        sum += Fraction(1, 7 * 11 * 13);
+    }
+    QCOMPARE(sum, Fraction(1000, 7 * 11 * 13));
+
+    Fraction mixed(0, 1);
+    for (int i = 0; i < 1000; ++i) {
+        mixed += Fraction(1, 3);
+        mixed += Fraction(1, 5);
+        mixed -= Fraction(8, 15);
+    }
+    QVERIFY(mixed.isZero());
+    QVERIFY(mixed.denominator() > 0);
+}
+
+//---------------------------------------------------------
+//   ticks
+//---------------------------------------------------------
+
+void TestFraction::ticks()
+{
+    QCOMPARE(Fraction(1, 4).ticks(), MScore::division);
+    QCOMPARE(Fraction::fromTicks(MScore::division * 3), Fraction(3, 4));
+    QCOMPARE(Fraction::fromTicks(Fraction(5, 12).ticks()), Fraction(5, 12));
+    QCOMPARE(Fraction(-1, 1).ticks(), -1);
+}
+
+//---------------------------------------------------------
+//   benchmarkLayoutMix
+//    the operator mix of walking segments and spanners:
+//    tick sums, comparisons against a range and duration scaling
+//---------------------------------------------------------
+
+void TestFraction::benchmarkLayoutMix()
+{
+    const Fraction durations[] = {
+        Fraction(1, 4), Fraction(1, 8), Fraction(1, 16), Fraction(3, 8), Fraction(1, 12), Fraction(1, 6), Fraction(1, 2)
+    };
+    const Fraction endTick(4000, 1);
+
+    int found = 0;
+    QBENCHMARK {
+        Fraction tick(0, 1);
+        int i = 0;
+        while (tick < endTick) {
+            const Fraction& d = durations[i++ % 7];
+            Fraction actual = d * Fraction(2, 3);
+            if (tick + actual >= Fraction(1, 2) && tick != endTick) {
+                ++found;
+            }
+            tick += d;
+            tick.reduce();
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_MAIN(TestFraction)
+#include "tst_fraction.moc"
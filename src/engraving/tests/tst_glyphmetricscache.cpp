@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "testing/qtestsuite.h"
+#include "infrastructure/internal/fontengineft.h"
+
+using namespace mu::draw;
+
+static const QString FONT_PATH(":/fonts/bravura/Bravura.otf");
+static const qreal DPI_F = 5.0;
+
+//---------------------------------------------------------
+//   TestGlyphMetricsCache
+//---------------------------------------------------------
+
+class TestGlyphMetricsCache : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir tempDir;
+
+    QString cacheDir() const { return tempDir.filePath("fontcache"); }
+    QStringList cacheFiles() const { return QDir(cacheDir()).entryList(QDir::Files); }
+
+private slots:
+    void initTestCase();
+    void sameMetrics();
+    void damagedCache();
+    void concurrentLookup();
+    void benchmarkLoadFont();
+    void benchmarkLoadCache();
+};
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestGlyphMetricsCache::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+}
+
+//---------------------------------------------------------
+//   sameMetrics
+//    the metrics mapped from the cache are the ones built from the font
+//---------------------------------------------------------
+
+void TestGlyphMetricsCache::sameMetrics()
+{
+    FontEngineFT font;
+    QVERIFY(font.load(FONT_PATH));
+    QVERIFY(!font.isLoadedFromCache());
+    QVERIFY(font.glyphCount() > 0);
+
+    FontEngineFT written;
+    QVERIFY(written.load(FONT_PATH, cacheDir()));
+    QVERIFY(!written.isLoadedFromCache());
+    QCOMPARE(cacheFiles().size(), 1);
+
+    FontEngineFT mapped;
+    QVERIFY(mapped.load(FONT_PATH, cacheDir()));
+    QVERIFY(mapped.isLoadedFromCache());
+    QCOMPARE(mapped.glyphCount(), font.glyphCount());
+
+    // the SMuFL range and a char that is not in the font
+    for (uint ucs4 = 0xE000; ucs4 < 0xF400; ++ucs4) {
+        QCOMPARE(mapped.bbox(ucs4, DPI_F), font.bbox(ucs4, DPI_F));
+        QCOMPARE(mapped.advance(ucs4, DPI_F), font.advance(ucs4, DPI_F));
+    }
+    QVERIFY(mapped.bbox(0x10FFFF, DPI_F).isNull());
+    QCOMPARE(mapped.advance(0x10FFFF, DPI_F), 0.0);
+}
+
+//---------------------------------------------------------
+//   damagedCache
+//    is ignored and rewritten
+//---------------------------------------------------------
+
+void TestGlyphMetricsCache::damagedCache()
+{
+    FontEngineFT written;
+    QVERIFY(written.load(FONT_PATH, cacheDir()));
+    QCOMPARE(cacheFiles().size(), 1);
+
+    QString cachePath = cacheDir() + "/" + cacheFiles().first();
+    {
+        QFile f(cachePath);
+        QVERIFY(f.open(QIODevice::ReadWrite));
+        QVERIFY(f.resize(f.size() / 2));
+    }
+
+    FontEngineFT rebuilt;
+    QVERIFY(rebuilt.load(FONT_PATH, cacheDir()));
+    QVERIFY(!rebuilt.isLoadedFromCache());
+    QCOMPARE(rebuilt.glyphCount(), written.glyphCount());
+
+    FontEngineFT mapped;
+    QVERIFY(mapped.load(FONT_PATH, cacheDir()));
+    QVERIFY(mapped.isLoadedFromCache());
+}
+
+//---------------------------------------------------------
+//   concurrentLookup
+//---------------------------------------------------------
+
+void TestGlyphMetricsCache::concurrentLookup()
+{
+    FontEngineFT font;
+    QVERIFY(font.load(FONT_PATH, cacheDir()));
+
+    QVector<uint> chars;
+    for (uint ucs4 = 0xE000; ucs4 < 0xF400; ++ucs4) {
+        chars << ucs4;
+    }
+
+    qreal expected = 0.0;
+    for (uint ucs4 : chars) {
+        expected += font.advance(ucs4, DPI_F) + font.bbox(ucs4, DPI_F).width();
+    }
+
+    std::vector<qreal> results(8, 0.0);
+    std::vector<std::thread> threads;
+    for (qreal& sum : results) {
+        threads.emplace_back([&font, &chars, &sum]() {
+            for (uint ucs4 : chars) {
+                sum += font.advance(ucs4, DPI_F) + font.bbox(ucs4, DPI_F).width();
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (qreal sum : results) {
+        QCOMPARE(sum, expected);
+    }
+}
+
+//---------------------------------------------------------
+//   benchmarkLoadFont
+//---------------------------------------------------------
+
+void TestGlyphMetricsCache::benchmarkLoadFont()
+{
+    QBENCHMARK {
+        FontEngineFT font;
+        font.load(FONT_PATH);
+    }
+}
+
+//---------------------------------------------------------
+//   benchmarkLoadCache
+//---------------------------------------------------------
+
+void TestGlyphMetricsCache::benchmarkLoadCache()
+{
+    FontEngineFT written;
+    QVERIFY(written.load(FONT_PATH, cacheDir()));
+
+    QBENCHMARK {
+        FontEngineFT font;
+        font.load(FONT_PATH, cacheDir());
+    }
+}
+
+QTEST_MAIN(TestGlyphMetricsCache)
+#include "tst_glyphmetricscache.moc"
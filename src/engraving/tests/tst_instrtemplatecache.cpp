@@ -0,0 +1,191 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QBuffer>
+#include <QTemporaryDir>
+
+#include "testing/qtestsuite.h"
+#include "testbase.h"
+#include "io/xml.h"
+#include "libmscore/instrtemplate.h"
+#include "libmscore/instrtemplatecache.h"
+#include "libmscore/scoreorder.h"
+
+using namespace Ms;
+
+static const QByteArray SOURCES_KEY("test");
+
+//---------------------------------------------------------
+//   TestInstrTemplateCache
+//---------------------------------------------------------
+
+class TestInstrTemplateCache : public QObject, public MTest
+{
+    Q_OBJECT
+
+    QTemporaryDir tempDir;
+
+    QString cachePath() const { return tempDir.filePath("instruments.cache"); }
+    QByteArray templatesToXml() const;
+
+private slots:
+    void initTestCase();
+    void roundTrip();
+    void otherSourcesKey();
+    void damagedCache();
+    void benchmarkLoadXml();
+    void benchmarkLoadCache();
+};
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestInstrTemplateCache::initTestCase()
+{
+    initMTest();
+    QVERIFY(tempDir.isValid());
+}
+
+//---------------------------------------------------------
+//   templatesToXml
+//    everything the cache holds, written the xml way
+//---------------------------------------------------------
+
+QByteArray TestInstrTemplateCache::templatesToXml() const
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    XmlWriter xml(score, &buffer);
+    xml.header();
+
+    for (const InstrumentGenre* genre : qAsConst(instrumentGenres)) {
+        genre->write(xml);
+    }
+    for (const InstrumentFamily* family : qAsConst(instrumentFamilies)) {
+        family->write(xml);
+    }
+    for (const MidiArticulation& a : qAsConst(articulation)) {
+        a.write(xml);
+    }
+    for (const InstrumentGroup* group : qAsConst(instrumentGroups)) {
+        xml.stag(QString("InstrumentGroup id=\"%1\" name=\"%2\" extended=\"%3\"").arg(group->id, group->name).arg(group->extended));
+        for (const InstrumentTemplate* t : group->instrumentTemplates) {
+            t->write(xml);
+            xml.tag("sequenceOrder", t->sequenceOrder);
+        }
+        xml.etag();
+    }
+    for (const ScoreOrder& order : qAsConst(instrumentOrders)) {
+        order.write(xml);
+    }
+
+    buffer.close();
+    return buffer.buffer();
+}
+
+//---------------------------------------------------------
+//   roundTrip
+//---------------------------------------------------------
+
+void TestInstrTemplateCache::roundTrip()
+{
+    QVERIFY(!instrumentGroups.isEmpty());
+
+    QByteArray fromXml = templatesToXml();
+    int templatesCount = 0;
+    for (const InstrumentGroup* group : qAsConst(instrumentGroups)) {
+        templatesCount += group->instrumentTemplates.size();
+    }
+
+    QVERIFY(writeInstrumentTemplatesCache(cachePath(), SOURCES_KEY));
+    QVERIFY(loadInstrumentTemplatesCache(cachePath(), SOURCES_KEY));
+
+    int loadedTemplatesCount = 0;
+    for (const InstrumentGroup* group : qAsConst(instrumentGroups)) {
+        loadedTemplatesCount += group->instrumentTemplates.size();
+    }
+
+    QCOMPARE(loadedTemplatesCount, templatesCount);
+    QCOMPARE(templatesToXml(), fromXml);
+    QVERIFY(searchTemplate("piano"));
+}
+
+//---------------------------------------------------------
+//   otherSourcesKey
+//    a cache made from other files is not used
+//---------------------------------------------------------
+
+void TestInstrTemplateCache::otherSourcesKey()
+{
+    QVERIFY(writeInstrumentTemplatesCache(cachePath(), SOURCES_KEY));
+
+    InstrumentGroup* firstGroup = instrumentGroups.first();
+    QVERIFY(!loadInstrumentTemplatesCache(cachePath(), "other"));
+    QCOMPARE(instrumentGroups.first(), firstGroup);
+}
+
+//---------------------------------------------------------
+//   damagedCache
+//---------------------------------------------------------
+
+void TestInstrTemplateCache::damagedCache()
+{
+    QVERIFY(writeInstrumentTemplatesCache(cachePath(), SOURCES_KEY));
+
+    QFile f(cachePath());
+    QVERIFY(f.open(QIODevice::ReadWrite));
+    QVERIFY(f.resize(f.size() / 2));
+    f.close();
+
+    InstrumentGroup* firstGroup = instrumentGroups.first();
+    QVERIFY(!loadInstrumentTemplatesCache(cachePath(), SOURCES_KEY));
+    QCOMPARE(instrumentGroups.first(), firstGroup);
+}
+
+//---------------------------------------------------------
+//   benchmarkLoadXml
+//---------------------------------------------------------
+
+void TestInstrTemplateCache::benchmarkLoadXml()
+{
+    QBENCHMARK {
+        clearInstrumentTemplates();
+        loadInstrumentTemplates(":/data/instruments.xml");
+    }
+}
+
+//---------------------------------------------------------
+//   benchmarkLoadCache
+//---------------------------------------------------------
+
+void TestInstrTemplateCache::benchmarkLoadCache()
+{
+    QVERIFY(writeInstrumentTemplatesCache(cachePath(), SOURCES_KEY));
+
+    QBENCHMARK {
+        loadInstrumentTemplatesCache(cachePath(), SOURCES_KEY);
+    }
+}
+
+QTEST_MAIN(TestInstrTemplateCache)
+#include "tst_instrtemplatecache.moc"
@@ -54,6 +54,8 @@ private slots:
     void benchmark1();
     void benchmark2();
     void benchmark4();              // incremental layout (one page)
+    void benchmark5();              // relayout after page size change
+    void benchmark6();              // relayout after staff spacing change
 };
 
 //---------------------------------------------------------
@@ -105,5 +107,32 @@ void TestLayoutBenchmark::benchmark4()
     }
 }
 
+void TestLayoutBenchmark::benchmark5()
+{
+    // measures content is unchanged, their minimum widths are reused
+    const qreal printableWidth = score->styleD(Sid::pagePrintableWidth);
+    bool narrow = false;
+    QBENCHMARK {
+        narrow = !narrow;
+        score->style().set(Sid::pagePrintableWidth, narrow ? printableWidth * 0.8 : printableWidth);
+        score->doLayout();
+    }
+    score->style().set(Sid::pagePrintableWidth, printableWidth);
+    score->doLayout();
+}
+
+void TestLayoutBenchmark::benchmark6()
+{
+    const Spatium staffDistance = score->styleS(Sid::staffDistance);
+    bool wide = false;
+    QBENCHMARK {
+        wide = !wide;
+        score->style().set(Sid::staffDistance, QVariant::fromValue(wide ? staffDistance * 1.5 : staffDistance));
+        score->doLayout();
+    }
+    score->style().set(Sid::staffDistance, QVariant::fromValue(staffDistance));
+    score->doLayout();
+}
+
 QTEST_MAIN(TestLayoutBenchmark)
 #include "tst_layout_benchmark.moc"
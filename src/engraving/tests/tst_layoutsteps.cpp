@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+ */
+
+#include "testing/qtestsuite.h"
+#include "testbase.h"
+#include "libmscore/masterscore.h"
+#include "libmscore/page.h"
+#include "libmscore/system.h"
+#include "libmscore/measurebase.h"
+
+static const QString LAYOUTSTEPS_DATA_DIR("concertpitch_data/");
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestLayoutSteps
+//---------------------------------------------------------
+
+class TestLayoutSteps : public QObject, public MTest
+{
+    Q_OBJECT
+
+    //! the first tick of every system, page by page
+    QList<QList<int> > pagesLayout(Score* score) const;
+
+private slots:
+    void initTestCase();
+    void steppedLayout();
+    void editRestartsLayout();
+    void undoRestartsLayout();
+    void benchmarkFirstPage();
+};
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestLayoutSteps::initTestCase()
+{
+    initMTest();
+}
+
+QList<QList<int> > TestLayoutSteps::pagesLayout(Score* score) const
+{
+    QList<QList<int> > layout;
+    for (const Page* page : score->pages()) {
+        QList<int> systems;
+        for (const System* system : page->systems()) {
+            systems.push_back(system->measures().empty() ? -1 : system->measures().front()->tick().ticks());
+        }
+        layout.push_back(systems);
+    }
+    return layout;
+}
+
+//---------------------------------------------------------
+//   steppedLayout
+//    the pages laid out in steps are the same as the pages of a complete layout
+//---------------------------------------------------------
+
+void TestLayoutSteps::steppedLayout()
+{
+    MasterScore* score = readScore(LAYOUTSTEPS_DATA_DIR + "concertpitchbenchmark.mscx");
+    QVERIFY(score);
+
+    score->doLayout();
+    const QList<QList<int> > expected = pagesLayout(score);
+    QVERIFY(expected.size() > 2);
+
+    score->setLayoutStepPages(1);
+    score->setLayoutAll();
+    score->update();
+
+    QVERIFY(score->isLayoutPending());
+    QVERIFY(!score->isLayoutComplete());
+    QCOMPARE(score->npages(), 1);
+
+    int steps = 1;
+    while (score->isLayoutPending()) {
+        score->layoutNextPages(1);
+        ++steps;
+        QCOMPARE(score->npages(), steps);
+    }
+
+    QVERIFY(score->isLayoutComplete());
+    QCOMPARE(pagesLayout(score), expected);
+
+    delete score;
+}
+
+//---------------------------------------------------------
+//   editRestartsLayout
+//    a command cancels the pending layout, its update lays out the pages again from the start
+//---------------------------------------------------------
+
+void TestLayoutSteps::editRestartsLayout()
+{
+    MasterScore* score = readScore(LAYOUTSTEPS_DATA_DIR + "concertpitchbenchmark.mscx");
+    QVERIFY(score);
+
+    score->doLayout();
+    const QList<QList<int> > expected = pagesLayout(score);
+
+    score->setLayoutStepPages(2);
+    score->setLayoutAll();
+    score->update();
+    score->layoutNextPages(1);
+    QVERIFY(score->isLayoutPending());
+
+    score->startCmd();
+    QVERIFY(!score->isLayoutPending());
+    QVERIFY(!score->isLayoutComplete());
+
+    score->setLayout(Fraction(1, 4), -1);
+    score->endCmd();
+
+    QVERIFY(score->isLayoutPending());
+    QCOMPARE(score->npages(), 2);
+
+    score->finishLayout();
+    QVERIFY(!score->isLayoutPending());
+    QVERIFY(score->isLayoutComplete());
+    QCOMPARE(pagesLayout(score), expected);
+
+    delete score;
+}
+
+//---------------------------------------------------------
+//   undoRestartsLayout
+//---------------------------------------------------------
+
+void TestLayoutSteps::undoRestartsLayout()
+{
+    MasterScore* score = readScore(LAYOUTSTEPS_DATA_DIR + "concertpitchbenchmark.mscx");
+    QVERIFY(score);
+
+    score->doLayout();
+    const QList<QList<int> > expected = pagesLayout(score);
+
+    score->startCmd();
+    score->cmdConcertPitchChanged(true);
+    score->endCmd();
+
+    score->setLayoutStepPages(1);
+    score->setLayoutAll();
+    score->update();
+    QVERIFY(score->isLayoutPending());
+
+    score->undoRedo(true, nullptr);
+    QVERIFY(score->isLayoutPending());
+    QCOMPARE(score->npages(), 1);
+
+    score->finishLayout();
+    QVERIFY(score->isLayoutComplete());
+    QCOMPARE(pagesLayout(score), expected);
+
+    delete score;
+}
+
+//---------------------------------------------------------
+//   benchmarkFirstPage
+//    the time until the first page can be shown
+//---------------------------------------------------------
+
+void TestLayoutSteps::benchmarkFirstPage()
+{
+    MasterScore* score = readScore(LAYOUTSTEPS_DATA_DIR + "concertpitchbenchmark.mscx");
+    QVERIFY(score);
+
+    QBENCHMARK {
+        score->doLayoutRange(Fraction(0, 1), Fraction(-1, 1), 1);
+    }
+
+    score->finishLayout();
+    QVERIFY(score->isLayoutComplete());
+
+    delete score;
+}
+
+QTEST_MAIN(TestLayoutSteps)
+#include "tst_layoutsteps.moc"
@@ -0,0 +1,322 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "testing/qtestsuite.h"
+#include "testbase.h"
+
+#include <QBuffer>
+#include <QFile>
+
+#include "libmscore/masterscore.h"
+
+#include "engraving/compat/scoreaccess.h"
+#include "engraving/compat/writescorehook.h"
+#include "engraving/infrastructure/io/mscreader.h"
+#include "engraving/infrastructure/io/mscwriter.h"
+#include "engraving/infrastructure/io/xml.h"
+
+static const QString SNAPSHOT_DATA_DIR("all_elements_data/");
+
+using namespace mu::engraving;
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestScoreSnapshot
+//    the score read from the snapshot must be the same as read from the score file
+//---------------------------------------------------------
+
+class TestScoreSnapshot : public QObject, public MTest
+{
+    Q_OBJECT
+
+    QByteArray readFile(const QString& name) const;
+    MasterScore* load(const QByteArray& mscx, bool withSnapshot, bool* snapshotUsed = nullptr);
+    QByteArray write(Score* score) const;
+
+private slots:
+    void initTestCase();
+    void tokens_data();
+    void tokens();
+    void roundTrip_data();
+    void roundTrip();
+    void outOfDate();
+    void corrupted();
+    void benchmarkReadXml();
+    void benchmarkReadSnapshot();
+};
+
+void TestScoreSnapshot::initTestCase()
+{
+    initMTest();
+}
+
+QByteArray TestScoreSnapshot::readFile(const QString& name) const
+{
+    QFile file(root + "/" + SNAPSHOT_DATA_DIR + name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+//---------------------------------------------------------
+//   load
+//    the same way as a score file is loaded, from the mscz in memory
+//---------------------------------------------------------
+
+MasterScore* TestScoreSnapshot::load(const QByteArray& mscx, bool withSnapshot, bool* snapshotUsed)
+{
+    QByteArray msczData;
+    {
+        QBuffer buf(&msczData);
+        MscWriter::Params params;
+        params.device = &buf;
+        params.filePath = "snapshot.mscz";
+        params.mode = MscIoMode::Zip;
+        params.writeScoreSnapshot = withSnapshot;
+        MscWriter writer(params);
+        writer.open();
+        writer.writeScoreFile(mscx);
+    }
+
+    QBuffer buf(&msczData);
+    MscReader::Params params;
+    params.device = &buf;
+    params.filePath = "snapshot.mscz";
+    params.mode = MscIoMode::Zip;
+    MscReader reader(params);
+    reader.open();
+
+    if (snapshotUsed) {
+        *snapshotUsed = BinaryXml::isSnapshotOf(reader.readScoreSnapshotFile(), reader.readScoreFile());
+    }
+
+    MasterScore* score = compat::ScoreAccess::createMasterScoreWithBaseStyle();
+    score->setName("snapshot");
+
+    ScoreLoad sl;
+    if (compat::ScoreAccess::loadMscz(score, reader, false) != Score::FileError::FILE_NO_ERROR) {
+        delete score;
+        return nullptr;
+    }
+    for (Score* s : score->scoreList()) {
+        s->doLayout();
+    }
+    return score;
+}
+
+QByteArray TestScoreSnapshot::write(Score* score) const
+{
+    QBuffer buf;
+    buf.open(QIODevice::ReadWrite);
+    compat::WriteScoreHook hook;
+    score->writeScore(&buf, false, false, hook);
+    return buf.buffer();
+}
+
+//---------------------------------------------------------
+//   tokens
+//    XmlReader reports the same tokens for both forms,
+//    the adjacent texts are compared joined
+//---------------------------------------------------------
+
+void TestScoreSnapshot::tokens_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::newRow("layout_elements") << "layout_elements.mscx";
+    QTest::newRow("layout_elements_tab") << "layout_elements_tab.mscx";
+    QTest::newRow("moonlight") << "moonlight.mscx";
+}
+
+void TestScoreSnapshot::tokens()
+{
+    QFETCH(QString, file);
+
+    QByteArray mscx = readFile(file);
+    QVERIFY(!mscx.isEmpty());
+    QByteArray snapshot = BinaryXml::encode(mscx);
+    QVERIFY(BinaryXml::isSnapshotOf(snapshot, mscx));
+    QVERIFY(snapshot.size() < mscx.size());
+
+    XmlReader xml(mscx);
+    XmlReader bin(snapshot);
+    QVERIFY(!xml.isBinary());
+    QVERIFY(bin.isBinary());
+
+    auto next = [](XmlReader& e, QString& text) {
+        text.clear();
+        for (;;) {
+            QXmlStreamReader::TokenType t = e.readNext();
+            if (t == QXmlStreamReader::Characters) {
+                text += e.text();
+            } else if (t != QXmlStreamReader::Comment && t != QXmlStreamReader::ProcessingInstruction
+                       && t != QXmlStreamReader::DTD) {
+                return t;
+            }
+        }
+    };
+
+    int depth = 0;
+    for (;;) {
+        QString xmlText;
+        QString binText;
+        QXmlStreamReader::TokenType t = next(xml, xmlText);
+        QCOMPARE(next(bin, binText), t);
+        if (depth > 0) {
+            QCOMPARE(binText, xmlText);
+        }
+        if (t == QXmlStreamReader::EndDocument || t == QXmlStreamReader::Invalid) {
+            break;
+        }
+        QCOMPARE(bin.name(), xml.name());
+        if (t == QXmlStreamReader::StartElement) {
+            ++depth;
+            QCOMPARE(bin.attributes(), xml.attributes());
+        } else if (t == QXmlStreamReader::EndElement) {
+            --depth;
+        }
+    }
+    QVERIFY(!xml.hasError());
+    QVERIFY(!bin.hasError());
+}
+
+//---------------------------------------------------------
+//   roundTrip
+//    read from the mscx and from the snapshot, both written back must be the same
+//---------------------------------------------------------
+
+void TestScoreSnapshot::roundTrip_data()
+{
+    tokens_data();
+}
+
+void TestScoreSnapshot::roundTrip()
+{
+    QFETCH(QString, file);
+
+    QByteArray mscx = readFile(file);
+    QVERIFY(!mscx.isEmpty());
+
+    // the test files are of the older versions, the written ones are read by the current read code
+    QByteArray written;
+    for (int pass = 0; pass < 2; ++pass) {
+        MasterScore* fromXml = load(mscx, false);
+        QVERIFY(fromXml);
+        QByteArray expected = write(fromXml);
+        delete fromXml;
+
+        bool snapshotUsed = false;
+        MasterScore* fromSnapshot = load(mscx, true, &snapshotUsed);
+        QVERIFY(fromSnapshot);
+        QVERIFY(snapshotUsed);
+        QByteArray actual = write(fromSnapshot);
+        delete fromSnapshot;
+
+        QCOMPARE(actual, expected);
+        mscx = expected;
+    }
+}
+
+//---------------------------------------------------------
+//   outOfDate
+//    the snapshot of the other version of the file is not used
+//---------------------------------------------------------
+
+void TestScoreSnapshot::outOfDate()
+{
+    QByteArray mscx = readFile("layout_elements.mscx");
+    QByteArray snapshot = BinaryXml::encode(mscx);
+    QVERIFY(BinaryXml::isSnapshotOf(snapshot, mscx));
+
+    QByteArray changed = mscx;
+    changed.replace("<Chord>", "<Chord >");
+    QVERIFY(!BinaryXml::isSnapshotOf(snapshot, changed));
+
+    QByteArray sameSize = mscx;
+    int i = sameSize.indexOf("<pitch>") + 7;
+    sameSize[i] = sameSize[i] == '6' ? '7' : '6';
+    QVERIFY(!BinaryXml::isSnapshotOf(snapshot, sameSize));
+
+    QVERIFY(!BinaryXml::isSnapshotOf(mscx, mscx));
+    QVERIFY(BinaryXml::encode("<museScore><Score>").isEmpty());
+}
+
+//---------------------------------------------------------
+//   corrupted
+//    the truncated snapshot is read with an error, not out of bounds
+//---------------------------------------------------------
+
+void TestScoreSnapshot::corrupted()
+{
+    QByteArray snapshot = BinaryXml::encode(readFile("layout_elements.mscx"));
+    for (int size : { BinaryXml::HEADER_SIZE, BinaryXml::HEADER_SIZE + 100, snapshot.size() / 2, snapshot.size() - 1 }) {
+        XmlReader e(snapshot.left(size));
+        QVERIFY(e.isBinary());
+        while (!e.atEnd()) {
+            e.readNext();
+        }
+        QVERIFY(e.hasError());
+    }
+}
+
+//---------------------------------------------------------
+//   benchmarks
+//    read as the read code does: test the names, read the attributes and the leaf texts
+//---------------------------------------------------------
+
+static int readTokens(XmlReader& e)
+{
+    int count = 0;
+    while (!e.atEnd()) {
+        if (e.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        ++count;
+        if (e.name() == "Chord" || e.name() == "Rest") {
+            count += e.attributes().size();
+        } else if (e.name() == "pitch" || e.name() == "track" || e.name() == "tpc") {
+            count += e.readInt() != 0;
+        }
+    }
+    return count;
+}
+
+void TestScoreSnapshot::benchmarkReadXml()
+{
+    QByteArray mscx = readFile("moonlight.mscx");
+    QBENCHMARK {
+        XmlReader e(mscx);
+        QVERIFY(readTokens(e) > 0);
+    }
+}
+
+void TestScoreSnapshot::benchmarkReadSnapshot()
+{
+    QByteArray snapshot = BinaryXml::encode(readFile("moonlight.mscx"));
+    QBENCHMARK {
+        XmlReader e(snapshot);
+        QVERIFY(readTokens(e) > 0);
+    }
+}
+
+QTEST_MAIN(TestScoreSnapshot)
+#include "tst_scoresnapshot.moc"
@@ -0,0 +1,264 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "testing/qtestsuite.h"
+#include "testbase.h"
+#include "libmscore/masterscore.h"
+#include "libmscore/hairpin.h"
+#include "libmscore/spannermap.h"
+
+using namespace Ms;
+
+static const int SPANNER_COUNT = 20000;
+static const int SCORE_TICKS = 4 * 480 * 2000;
+
+//---------------------------------------------------------
+//   TestSpannerMap
+//---------------------------------------------------------
+
+class TestSpannerMap : public QObject, public MTest
+{
+    Q_OBJECT
+
+    std::vector<Spanner*> spanners;
+
+    void addSpanners(int count);
+    void deleteSpanners();
+    std::vector<Spanner*> bruteForceOverlapping(int start, int stop) const;
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void overlapping();
+    void tickChanges();
+    void removal();
+    void benchmarkBulkAdd();
+    void benchmarkEditQueries();
+};
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSpannerMap::initTestCase()
+{
+    initMTest();
+}
+
+//---------------------------------------------------------
+//   cleanup
+//---------------------------------------------------------
+
+void TestSpannerMap::cleanup()
+{
+    deleteSpanners();
+}
+
+//---------------------------------------------------------
+//   addSpanners
+//    deterministic pseudo-random hairpins, added in tick order
+//    like a score being read
+//---------------------------------------------------------
+
+void TestSpannerMap::addSpanners(int count)
+{
+    unsigned seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return int((seed >> 8) & 0xffffff);
+    };
+    for (int i = 0; i < count; ++i) {
+        Hairpin* h = new Hairpin(score);
+        h->setTick(Fraction::fromTicks(int(qint64(i) * SCORE_TICKS / count)));
+        h->setTicks(Fraction::fromTicks(480 + next() % (4 * 480 * 8)));
+        spanners.push_back(h);
+    }
+    for (Spanner* s : spanners) {
+        score->spannerMap().addSpanner(s);
+    }
+}
+
+//---------------------------------------------------------
+//   deleteSpanners
+//---------------------------------------------------------
+
+void TestSpannerMap::deleteSpanners()
+{
+    score->spannerMap().clear();
+    qDeleteAll(spanners);
+    spanners.clear();
+}
+
+//---------------------------------------------------------
+//   bruteForceOverlapping
+//---------------------------------------------------------
+
+std::vector<Spanner*> TestSpannerMap::bruteForceOverlapping(int start, int stop) const
+{
+    std::vector<Spanner*> result;
+    for (const auto& i : score->spannerMap().map()) {
+        Spanner* s = i.second;
+        if (s->tick2().ticks() >= start && s->tick().ticks() <= stop) {
+            result.push_back(s);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), [](Spanner* a, Spanner* b) {
+        return a->tick() < b->tick();
+    });
+    return result;
+}
+
+//---------------------------------------------------------
+//   overlapping
+//---------------------------------------------------------
+
+void TestSpannerMap::overlapping()
+{
+    addSpanners(500);
+    SpannerMap& smap = score->spannerMap();
+
+    for (int start = 0; start < SCORE_TICKS; start += SCORE_TICKS / 97) {
+        int stop = start + 4 * 480;
+        std::vector<Spanner*> expected = bruteForceOverlapping(start, stop);
+
+        const auto& found = smap.findOverlapping(start, stop);
+        QCOMPARE(int(found.size()), int(expected.size()));
+        for (size_t i = 0; i < found.size(); ++i) {
+            QCOMPARE(found[i].value, expected[i]);
+        }
+
+        size_t visited = 0;
+        smap.forEachOverlapping(start, stop, [&](Spanner* s) {
+            QVERIFY(visited < expected.size() && s == expected[visited]);
+            ++visited;
+        });
+        QCOMPARE(visited, expected.size());
+    }
+
+    // contained: both ends inside the range
+    const auto& contained = smap.findContained(0, SCORE_TICKS / 2);
+    for (const auto& i : contained) {
+        QVERIFY(i.value->tick().ticks() >= 0 && i.value->tick2().ticks() <= SCORE_TICKS / 2);
+    }
+    int count = 0;
+    for (Spanner* s : spanners) {
+        if (s->tick2().ticks() <= SCORE_TICKS / 2) {
+            ++count;
+        }
+    }
+    QCOMPARE(int(contained.size()), count);
+}
+
+//---------------------------------------------------------
+//   tickChanges
+//    Spanner::setTick/setTicks update the lookup tree
+//---------------------------------------------------------
+
+void TestSpannerMap::tickChanges()
+{
+    addSpanners(500);
+    SpannerMap& smap = score->spannerMap();
+
+    Spanner* s = spanners[10];
+    s->setTick(Fraction::fromTicks(SCORE_TICKS + 4800));
+    s->setTicks(Fraction::fromTicks(480));
+
+    const auto& found = smap.findOverlapping(SCORE_TICKS + 4800, SCORE_TICKS + 4800);
+    QCOMPARE(int(found.size()), 1);
+    QCOMPARE(found.front().value, s);
+
+    for (int i = 0; i < 100; ++i) {
+        spanners[i * 3]->setTick(Fraction::fromTicks((i * 7919) % SCORE_TICKS));
+    }
+    for (int start = 0; start < SCORE_TICKS; start += SCORE_TICKS / 31) {
+        std::vector<Spanner*> expected = bruteForceOverlapping(start, start + 480);
+        const auto& result = smap.findOverlapping(start, start + 480);
+        QCOMPARE(int(result.size()), int(expected.size()));
+    }
+}
+
+//---------------------------------------------------------
+//   removal
+//---------------------------------------------------------
+
+void TestSpannerMap::removal()
+{
+    addSpanners(500);
+    SpannerMap& smap = score->spannerMap();
+
+    for (size_t i = 0; i < spanners.size(); i += 2) {
+        QVERIFY(smap.removeSpanner(spanners[i]));
+    }
+    QVERIFY(!smap.removeSpanner(spanners[0]));
+    QCOMPARE(int(smap.map().size()), int(spanners.size() / 2));
+
+    const auto& all = smap.findOverlapping(0, SCORE_TICKS * 2);
+    QCOMPARE(int(all.size()), int(spanners.size() / 2));
+    for (const auto& i : all) {
+        auto index = std::find(spanners.begin(), spanners.end(), i.value) - spanners.begin();
+        QVERIFY(index % 2 == 1);
+    }
+}
+
+//---------------------------------------------------------
+//   benchmarkBulkAdd
+//    reading a large score: add all spanners, then the
+//    first query
+//---------------------------------------------------------
+
+void TestSpannerMap::benchmarkBulkAdd()
+{
+    QBENCHMARK {
+        deleteSpanners();
+        addSpanners(SPANNER_COUNT);
+        score->spannerMap().findOverlapping(0, 480);
+    }
+}
+
+//---------------------------------------------------------
+//   benchmarkEditQueries
+//    interleaved edits and segment sized queries, as done
+//    by the edit commands and incremental layout
+//---------------------------------------------------------
+
+void TestSpannerMap::benchmarkEditQueries()
+{
+    addSpanners(SPANNER_COUNT);
+    SpannerMap& smap = score->spannerMap();
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            Spanner* s = spanners[(i * 7919) % spanners.size()];
+            smap.removeSpanner(s);
+            smap.addSpanner(s);
+            s->setTicks(s->ticks() + Fraction(1, 4));
+
+            int tick = (i * 104729) % SCORE_TICKS;
+            size_t n = 0;
+            smap.forEachOverlapping(tick, tick, [&n](Spanner*) { ++n; });
+            smap.findOverlapping(tick, tick + 4 * 480);
+        }
+    }
+}
+
+QTEST_MAIN(TestSpannerMap)
+#include "tst_spannermap.moc"
@@ -0,0 +1,235 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "testing/qtestsuite.h"
+
+#include <QBuffer>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "infrastructure/io/xml.h"
+
+using namespace mu;
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestXmlWriter
+//    the output must be the same as written by QTextStream
+//---------------------------------------------------------
+
+class TestXmlWriter : public QObject
+{
+    Q_OBJECT
+
+    template<typename Func>
+    QByteArray write(Func func)
+    {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        XmlWriter xml(nullptr, &buffer);
+        func(xml);
+        buffer.close();
+        return buffer.buffer();
+    }
+
+    static QByteArray streamed(double v)
+    {
+        QString s;
+        QTextStream ts(&s);
+        ts << v;
+        ts.flush();
+        return s.toUtf8();
+    }
+
+private slots:
+    void doubles();
+    void integers();
+    void strings();
+    void variants();
+    void nesting();
+    void streamOrder();
+    void stringMode();
+    void benchmarkTags();
+};
+
+//---------------------------------------------------------
+//   doubles
+//---------------------------------------------------------
+
+void TestXmlWriter::doubles()
+{
+    std::vector<double> values = { 0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.5, 2.5, 1e-4, 9.99995e-5, 0.00015, 1.0 / 3.0,
+                                   12345.65, 99999.95, 123456.5, 999999.4, 999999.5, 1e6, 1e-7, 1e20, -3.25e-12,
+                                   std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() };
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> range(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> exponent(-8.0, 8.0);
+    for (int i = 0; i < 20000; ++i) {
+        values.push_back(range(random));
+        values.push_back(std::round(range(random) * 100.0) / 100.0);
+        values.push_back(std::pow(10.0, exponent(random)));
+    }
+
+    for (double v : values) {
+        QByteArray out = write([v](XmlWriter& xml) { xml.tag("v", v); });
+        QCOMPARE(out, "<v>" + streamed(v) + "</v>\n");
+    }
+}
+
+//---------------------------------------------------------
+//   integers
+//---------------------------------------------------------
+
+void TestXmlWriter::integers()
+{
+    QByteArray out = write([](XmlWriter& xml) {
+        xml.tag("i", 0);
+        xml.tag("i", -2147483647 - 1);
+        xml.tag("b", true);
+        xml.tag("l", qint64(1) << 40);
+        xml.tag("u", 7u);
+        xml.tag("d", 5, 5);
+        xml.tag("d", 5, 6);
+        xml.tag("f", Fraction(3, 8));
+        xml.tag("s", Spatium(1.5));
+    });
+    QCOMPARE(out, QByteArray("<i>0</i>\n<i>-2147483648</i>\n<b>1</b>\n<l>1099511627776</l>\n<u>7</u>\n<d>5</d>\n"
+                             "<f>3/8</f>\n<s>1.5</s>\n"));
+}
+
+//---------------------------------------------------------
+//   strings
+//---------------------------------------------------------
+
+void TestXmlWriter::strings()
+{
+    QByteArray out = write([](XmlWriter& xml) {
+        xml.tag("t", QString("a<b>&\"c\""));
+        xml.tag("t", QString::fromUtf8("Fl\xc3\xb6te \xf0\x9d\x84\x9e"));
+        xml.tag("t", QString("x") + QChar(0x01) + QString("y\tz"));
+        xml.tag("t", "plain");
+        xml.tag("text lang=\"en\"", QVariant(QString("x")));
+        xml.writeXml("w", QString("<b>bold</b>") + QChar(0x02));
+        xml.comment("note");
+    });
+    QCOMPARE(out, QByteArray("<t>a&lt;b&gt;&amp;&quot;c&quot;</t>\n")
+             + QByteArray("<t>Fl\xc3\xb6te \xf0\x9d\x84\x9e</t>\n")
+             + QByteArray("<t>xy\tz</t>\n<t>plain</t>\n<text lang=\"en\">x</text>\n<w><b>bold</b>?</w>\n<!-- note -->\n"));
+}
+
+//---------------------------------------------------------
+//   variants
+//---------------------------------------------------------
+
+void TestXmlWriter::variants()
+{
+    QByteArray out = write([](XmlWriter& xml) {
+        xml.tag("p", PointF(1.5, -2.0));
+        xml.tag("s", SizeF(3.0, 0.25));
+        xml.tag("r", RectF(0.1, 0.2, 10.0, 20.0));
+        xml.tag("c", QVariant::fromValue(draw::Color(1, 2, 3, 4)));
+        xml.tag("f", QVariant::fromValue(Fraction(1, 4)), QVariant());
+        xml.tag("o offset=\"1\"", QVariant::fromValue(Fraction(1, 4)));
+    });
+    QCOMPARE(out, QByteArray("<p x=\"1.5\" y=\"-2\"/>\n<s w=\"3\" h=\"0.25\"/>\n<r x=\"0.1\" y=\"0.2\" w=\"10\" h=\"20\"/>\n"
+                             "<c r=\"1\" g=\"2\" b=\"3\" a=\"4\"/>\n<f>1/4</f>\n<o offset=\"1\">1/4</o offset=\"1\">\n"));
+}
+
+//---------------------------------------------------------
+//   nesting
+//---------------------------------------------------------
+
+void TestXmlWriter::nesting()
+{
+    QByteArray out = write([](XmlWriter& xml) {
+        xml.header();
+        xml.stag("museScore version=\"4.00\"");
+        xml.stag(QString("Staff id=\"%1\"").arg(1));
+        xml.tagE("empty a=\"%d\"", 2);
+        xml.ntag("n");
+        xml.netag("n");
+        xml.etag();
+        xml.etag();
+    });
+    QCOMPARE(out, QByteArray("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<museScore version=\"4.00\">\n  <Staff id=\"1\">\n"
+                             "    <empty a=\"2\"/>\n    <n></n>\n    </Staff>\n  </museScore>\n"));
+}
+
+//---------------------------------------------------------
+//   streamOrder
+//    text written directly to the stream keeps its place
+//---------------------------------------------------------
+
+void TestXmlWriter::streamOrder()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    XmlWriter xml(nullptr);
+    xml.setDevice(&buffer);
+    xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml.stag("a");
+    xml.tag("b", 1);
+    xml.etag();
+    QCOMPARE(buffer.buffer(), QByteArray("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<a>\n  <b>1</b>\n  </a>\n"));
+}
+
+//---------------------------------------------------------
+//   stringMode
+//---------------------------------------------------------
+
+void TestXmlWriter::stringMode()
+{
+    QString out;
+    XmlWriter xml(nullptr);
+    xml.setString(&out, QIODevice::WriteOnly);
+    xml.stag("a");
+    xml.tag("t", QString::fromUtf8("\xc3\xa9"));
+    xml.flush();
+    QCOMPARE(out, QString::fromUtf8("<a>\n  <t>\xc3\xa9</t>\n"));
+}
+
+//---------------------------------------------------------
+//   benchmarkTags
+//---------------------------------------------------------
+
+void TestXmlWriter::benchmarkTags()
+{
+    QBENCHMARK {
+        write([](XmlWriter& xml) {
+            xml.stag("museScore");
+            for (int i = 0; i < 100000; ++i) {
+                xml.stag("Chord");
+                xml.tag("durationType", "quarter");
+                xml.tag("track", i % 4);
+                xml.tag("offset", PointF(0.25 * i, -1.5));
+                xml.tag("stretch", 1.0 + i * 0.001);
+                xml.etag();
+            }
+            xml.etag();
+        });
+    }
+}
+
+QTEST_MAIN(TestXmlWriter)
+#include "tst_xmlwriter.moc"
@@ -85,3 +85,76 @@ TEST_F(MsczFileTests, MsczFile_WriteRead)
         EXPECT_EQ(imageData, originImageData);
     }
 }
+
+TEST_F(MsczFileTests, MsczFile_WriteReadManyFiles)
+{
+    //! CASE Writing many files, which are compressed in parallel, and reading them
+
+    //! GIVEN Some datas, compressible and not
+    auto makeData = [](int index, bool compressible) {
+        QByteArray data;
+        quint32 seed = 2166136261u + index;
+        for (int i = 0; i < 200000; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            data.append(compressible ? char('a' + (seed >> 28)) : char(seed >> 24));
+        }
+        return data;
+    };
+
+    const QByteArray originScoreData = makeData(0, true);
+    std::vector<QByteArray> originExcerptDatas;
+    for (int i = 0; i < 16; ++i) {
+        originExcerptDatas.push_back(makeData(i + 1, true));
+    }
+    const QByteArray originImageData = makeData(100, false);
+
+    int compressibleSize = originScoreData.size();
+    for (const QByteArray& data : originExcerptDatas) {
+        compressibleSize += data.size();
+    }
+
+    for (bool fastCompression : { false, true }) {
+        //! DO Write datas
+        QByteArray msczData;
+        {
+            QBuffer buf(&msczData);
+            MscWriter::Params params;
+            params.device = &buf;
+            params.filePath = "simple2.mscz";
+            params.mode = MscIoMode::Zip;
+            params.fastCompression = fastCompression;
+
+            MscWriter writer(params);
+            writer.open();
+
+            writer.writeScoreFile(originScoreData);
+            for (size_t i = 0; i < originExcerptDatas.size(); ++i) {
+                writer.addExcerptFile(QString("Part %1").arg(i), originExcerptDatas[i]);
+            }
+            writer.addImageFile("image1.png", originImageData);
+        }
+
+        //! CHECK The compressible datas are compressed (16 symbols, so about a half)
+        EXPECT_LT(msczData.size(), originImageData.size() + compressibleSize * 7 / 10);
+
+        //! CHECK Read and compare with origin
+        QBuffer buf(&msczData);
+        MscReader::Params params;
+        params.device = &buf;
+        params.filePath = "simple2.mscz";
+        params.mode = MscIoMode::Zip;
+
+        MscReader reader(params);
+        reader.open();
+
+        EXPECT_EQ(reader.readScoreFile(), originScoreData);
+
+        std::vector<QString> excerpts = reader.excerptNames();
+        EXPECT_EQ(excerpts.size(), originExcerptDatas.size());
+        for (size_t i = 0; i < originExcerptDatas.size(); ++i) {
+            EXPECT_EQ(reader.readExcerptFile(QString("Part %1").arg(i)), originExcerptDatas[i]);
+        }
+
+        EXPECT_EQ(reader.readImageFile("image1.png"), originImageData);
+    }
+}
@@ -193,6 +193,7 @@ void AudioModule::onInit(const framework::IApplication::RunMode& mode)
         AudioEngine::instance()->setAudioChannelsCount(s_audioConfiguration->audioChannelsCount());
         AudioEngine::instance()->setSampleRate(activeSpec.sampleRate);
         AudioEngine::instance()->setReadBufferSize(activeSpec.samples);
+        AudioEngine::instance()->frozenTrackCache()->setMemoryLimit(s_audioConfiguration->trackFreezeMemoryLimit());
 
         auto fluidResolver = std::make_shared<FluidResolver>(s_audioConfiguration->soundFontDirectories(),
                                                              s_audioConfiguration->soundFontDirectoriesChanged());
@@ -208,6 +209,13 @@ void AudioModule::onInit(const framework::IApplication::RunMode& mode)
         s_audioBuffer->forward();
     };
 
+    //! NOTE The worker sleeps until there is something to do:
+    //! queued async calls wake it up by themselves, the driver does when it has consumed the buffer
+    s_audioBuffer->setOnLowWaterMark([]() {
+        s_audioWorker->wakeup();
+    });
+
+    s_audioWorker->setRealtimePriorityEnabled(s_audioConfiguration->isWorkerRealtimePriorityEnabled());
     s_audioWorker->run(workerSetup, workerLoopBody);
 
     //! --- Diagnostics ---
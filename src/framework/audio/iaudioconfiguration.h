@@ -45,6 +45,8 @@ public:
 
     virtual audioch_t audioChannelsCount() const = 0;
     virtual unsigned int driverBufferSize() const = 0; // samples
+    virtual bool isWorkerRealtimePriorityEnabled() const = 0;
+    virtual size_t trackFreezeMemoryLimit() const = 0; // bytes, 0 - tracks are always synthesized live
 
     virtual bool isShowControlsInMixer() const = 0;
     virtual void setIsShowControlsInMixer(bool show) = 0;
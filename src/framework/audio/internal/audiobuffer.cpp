@@ -25,6 +25,8 @@
 
 #include "log.h"
 
+#include "audiosanitizer.h"
+
 using namespace mu::audio;
 
 void AudioBuffer::init(const audioch_t audioChannelsCount, const samples_t samplesPerChannel)
@@ -49,35 +51,50 @@ void AudioBuffer::forward()
     fillup();
 }
 
+void AudioBuffer::setOnLowWaterMark(const std::function<void()>& f)
+{
+    m_onLowWaterMark = f;
+}
+
 void AudioBuffer::pop(float* dest, size_t sampleCount)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    AudioSanitizer::RealtimeScope realtimeScope;
+
+    const size_t lowWaterMark = m_minSampleLag + FILL_OVER;
+    bool wasAboveLowWaterMark = sampleLag() >= lowWaterMark;
 
-    size_t from = m_readIndex;
+    size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+    size_t from = readIndex;
     auto memStep = sizeof(float);
-    size_t to = m_readIndex + sampleCount * m_audioChannelsCount;
+    size_t to = readIndex + sampleCount * m_audioChannelsCount;
     if (to > m_data.size()) {
         to = m_data.size();
     }
     auto count = to - from;
     std::memcpy(dest, m_data.data() + from, count * memStep);
-    m_readIndex += count;
+    readIndex += count;
 
     size_t left = sampleCount * m_audioChannelsCount - count;
     if (left > 0) {
         std::memcpy(dest + count, m_data.data(), left * memStep);
-        m_readIndex = left;
+        readIndex = left;
     }
 
-    if (m_readIndex >= m_data.size()) {
-        m_readIndex -= m_data.size();
+    if (readIndex >= m_data.size()) {
+        readIndex -= m_data.size();
+    }
+
+    m_readIndex.store(readIndex, std::memory_order_release);
+
+    //! NOTE Waking the worker up does not lock, see AudioThread::wakeup
+    bool isBelowLowWaterMark = sampleLag() < lowWaterMark;
+    if (wasAboveLowWaterMark && isBelowLowWaterMark && m_onLowWaterMark) {
+        m_onLowWaterMark();
     }
 }
 
 void AudioBuffer::setMinSampleLag(size_t lag)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
     IF_ASSERT_FAILED(lag < m_data.size()) {
         lag = m_data.size();
     }
@@ -91,34 +108,41 @@ void AudioBuffer::fillup()
     }
 
     while (sampleLag() < m_minSampleLag + FILL_OVER) {
-        m_source->process(m_data.data() + m_writeIndex, FILL_SAMPLES);
+        m_source->process(m_data.data() + m_writeIndex.load(std::memory_order_relaxed), FILL_SAMPLES);
         updateWriteIndex(FILL_SAMPLES);
     }
 }
 
 void AudioBuffer::updateWriteIndex(const unsigned int samplesPerChannel)
 {
-    size_t from = m_writeIndex;
+    size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+    size_t from = writeIndex;
 
-    auto to = m_writeIndex + samplesPerChannel * m_audioChannelsCount;
+    auto to = writeIndex + samplesPerChannel * m_audioChannelsCount;
     if (to > m_data.size()) {
         to = m_data.size() - 1;
     }
     auto count = to - from;
-    m_writeIndex += count;
+    writeIndex += count;
 
-    if (m_writeIndex >= m_data.size()) {
-        m_writeIndex -= m_data.size();
+    if (writeIndex >= m_data.size()) {
+        writeIndex -= m_data.size();
     }
+
+    //! NOTE Publishes the samples written before
+    m_writeIndex.store(writeIndex, std::memory_order_release);
 }
 
 unsigned int AudioBuffer::sampleLag() const
 {
+    const size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+    const size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+
     size_t lag = 0;
-    if (m_readIndex <= m_writeIndex) {
-        lag = m_writeIndex - m_readIndex;
+    if (readIndex <= writeIndex) {
+        lag = writeIndex - readIndex;
     } else {
-        lag = m_writeIndex + m_data.size() - m_readIndex;
+        lag = writeIndex + m_data.size() - readIndex;
     }
 
     return static_cast<unsigned int>(lag / m_audioChannelsCount);
@@ -25,6 +25,7 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <functional>
 
 #include "modularity/ioc.h"
 
@@ -48,21 +49,28 @@ public:
     void pop(float* dest, size_t sampleCount) override;
     void setMinSampleLag(size_t lag) override;
 
+    //! NOTE Called by the consumer (from pop) when the buffer needs to be filled up again,
+    //! inside its realtime scope, so it must not lock or allocate. Must be set before the consumer is started
+    void setOnLowWaterMark(const std::function<void()>& f);
+
 private:
 
     unsigned int sampleLag() const;
     void fillup();
     void updateWriteIndex(const unsigned int samplesPerChannel);
 
+    //! NOTE Only between the worker and the main thread,
+    //! the consumer (pop) does not lock, it shares just the indexes with the worker
     std::mutex m_mutex;
-    size_t m_minSampleLag = FILL_SAMPLES;
-    size_t m_writeIndex = 0;
-    size_t m_readIndex = 0;
+    std::atomic<size_t> m_minSampleLag = FILL_SAMPLES;
+    std::atomic<size_t> m_writeIndex = 0;
+    std::atomic<size_t> m_readIndex = 0;
     samples_t m_samplesPerChannel = 0;
     audioch_t m_audioChannelsCount = 0;
 
     std::vector<float> m_data = {};
     std::shared_ptr<IAudioSource> m_source = nullptr;
+    std::function<void()> m_onLowWaterMark = nullptr;
 };
 }
 
@@ -41,6 +41,8 @@ static const audioch_t AUDIO_CHANNELS = 2;
 //TODO: add other setting: audio device etc
 static const Settings::Key AUDIO_API_KEY("audio", "io/audioApi");
 static const Settings::Key AUDIO_BUFFER_SIZE("audio", "driver_buffer");
+static const Settings::Key WORKER_REALTIME_PRIORITY("audio", "io/workerRealtimePriority");
+static const Settings::Key TRACK_FREEZE_MEMORY_LIMIT_MB("audio", "io/trackFreezeMemoryLimitMb");
 
 static const Settings::Key USER_SOUNDFONTS_PATH("midi", "application/paths/mySoundfonts");
 
@@ -57,6 +59,8 @@ void AudioConfiguration::init()
     defaultBufferSize = 1024;
 #endif
     settings()->setDefaultValue(AUDIO_BUFFER_SIZE, Val(defaultBufferSize));
+    settings()->setDefaultValue(WORKER_REALTIME_PRIORITY, Val(false));
+    settings()->setDefaultValue(TRACK_FREEZE_MEMORY_LIMIT_MB, Val(0)); // opt-in
 
     settings()->setDefaultValue(SHOW_CONTROLS_IN_MIXER, Val(true));
     settings()->setDefaultValue(AUDIO_API_KEY, Val("Core Audio"));
@@ -94,6 +98,17 @@ unsigned int AudioConfiguration::driverBufferSize() const
     return settings()->value(AUDIO_BUFFER_SIZE).toInt();
 }
 
+bool AudioConfiguration::isWorkerRealtimePriorityEnabled() const
+{
+    return settings()->value(WORKER_REALTIME_PRIORITY).toBool();
+}
+
+size_t AudioConfiguration::trackFreezeMemoryLimit() const
+{
+    int limitMb = settings()->value(TRACK_FREEZE_MEMORY_LIMIT_MB).toInt();
+    return limitMb > 0 ? static_cast<size_t>(limitMb) * 1024 * 1024 : 0;
+}
+
 SoundFontPaths AudioConfiguration::soundFontDirectories() const
 {
     std::string pathsStr = settings()->value(USER_SOUNDFONTS_PATH).toString();
@@ -42,6 +42,8 @@ public:
 
     audioch_t audioChannelsCount() const override;
     unsigned int driverBufferSize() const override;
+    bool isWorkerRealtimePriorityEnabled() const override;
+    size_t trackFreezeMemoryLimit() const override;
 
     io::paths soundFontDirectories() const override;
     async::Channel<io::paths> soundFontDirectoriesChanged() const override;
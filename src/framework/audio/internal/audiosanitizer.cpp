@@ -22,6 +22,18 @@
 #include "audiosanitizer.h"
 
 #include <thread>
+#include <atomic>
+
+#include "log.h"
+
+#ifdef AUDIO_REALTIME_GUARD_ENABLED
+#include <cstdlib>
+#include <new>
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <dlfcn.h>
+#endif
+#endif
 
 using namespace mu::audio;
 
@@ -57,3 +69,186 @@ bool AudioSanitizer::isWorkerThread()
 {
     return std::this_thread::get_id() == s_as_workerThreadID;
 }
+
+// Realtime guard
+
+static thread_local int s_rt_scopeDepth = 0;
+static thread_local int s_rt_suspendDepth = 0;
+static thread_local size_t s_rt_scopeAllocations = 0;
+static thread_local size_t s_rt_scopeLocks = 0;
+static std::atomic<size_t> s_rt_violations { 0 };
+
+#ifdef AUDIO_REALTIME_GUARD_ENABLED
+
+static inline bool isInRealtimeScope()
+{
+    return s_rt_scopeDepth > 0 && s_rt_suspendDepth == 0;
+}
+
+static inline void noteAllocation()
+{
+    if (isInRealtimeScope()) {
+        ++s_rt_scopeAllocations;
+        s_rt_violations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static inline void noteLock()
+{
+    if (isInRealtimeScope()) {
+        ++s_rt_scopeLocks;
+        s_rt_violations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+
+//! NOTE With glibc the C allocator itself is intercepted,
+//! so allocations made by C libraries (fluidsynth) are counted too
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+extern "C" void* malloc(size_t size)
+{
+    noteAllocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    noteAllocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+    noteAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr)
+{
+    if (ptr) {
+        noteAllocation();
+    }
+    __libc_free(ptr);
+}
+
+#else
+
+void* operator new(size_t size)
+{
+    noteAllocation();
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    noteAllocation();
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr) {
+        noteAllocation();
+    }
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    ::operator delete(ptr);
+}
+
+#endif
+
+#ifdef Q_OS_LINUX
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFunc = int (*)(pthread_mutex_t*);
+    static LockFunc realLock = reinterpret_cast<LockFunc>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+
+    noteLock();
+    return realLock(mutex);
+}
+
+#endif
+
+#endif // AUDIO_REALTIME_GUARD_ENABLED
+
+AudioSanitizer::RealtimeScope::RealtimeScope()
+{
+    if (s_rt_scopeDepth++ == 0) {
+        s_rt_scopeAllocations = 0;
+        s_rt_scopeLocks = 0;
+    }
+}
+
+AudioSanitizer::RealtimeScope::~RealtimeScope()
+{
+    if (--s_rt_scopeDepth > 0) {
+        return;
+    }
+
+    if (s_rt_scopeAllocations > 0 || s_rt_scopeLocks > 0) {
+        LOGE() << "not realtime safe: " << s_rt_scopeAllocations << " allocations, "
+               << s_rt_scopeLocks << " locks in the realtime scope";
+    }
+}
+
+AudioSanitizer::NonRealtimeScope::NonRealtimeScope()
+{
+    ++s_rt_suspendDepth;
+}
+
+AudioSanitizer::NonRealtimeScope::~NonRealtimeScope()
+{
+    --s_rt_suspendDepth;
+}
+
+bool AudioSanitizer::isRealtimeGuardEnabled()
+{
+#ifdef AUDIO_REALTIME_GUARD_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t AudioSanitizer::realtimeViolationsCount()
+{
+    return s_rt_violations.load(std::memory_order_relaxed);
+}
+
+void AudioSanitizer::resetRealtimeViolations()
+{
+    s_rt_violations.store(0, std::memory_order_relaxed);
+}
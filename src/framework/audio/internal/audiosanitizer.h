@@ -25,6 +25,7 @@
 //! NOTE This is dev tools
 
 #include <cassert>
+#include <cstddef>
 #include <thread>
 
 namespace mu::audio {
@@ -39,6 +40,26 @@ public:
     static void setupWorkerThread();
     static std::thread::id workerThread();
     static bool isWorkerThread();
+
+    //! NOTE Realtime guard
+    //! In builds with AUDIO_REALTIME_GUARD the memory allocations and mutex locks
+    //! made inside a realtime scope are counted and reported when the scope ends,
+    //! otherwise the scopes do nothing
+    struct RealtimeScope {
+        RealtimeScope();
+        ~RealtimeScope();
+    };
+
+    //! NOTE Suspends the guard for rare work which is known to be not realtime safe
+    //! (e.g. requesting the next portion of events from the main thread)
+    struct NonRealtimeScope {
+        NonRealtimeScope();
+        ~NonRealtimeScope();
+    };
+
+    static bool isRealtimeGuardEnabled();
+    static size_t realtimeViolationsCount();
+    static void resetRealtimeViolations();
 };
 }
 
@@ -21,6 +21,8 @@
  */
 #include "audiothread.h"
 
+#include <algorithm>
+
 #include "log.h"
 #include "runtime.h"
 #include "async/processevents.h"
@@ -29,10 +31,90 @@
 #include <emscripten/html5.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(Q_OS_MAC)
+#include <dispatch/dispatch.h>
+#elif defined(Q_OS_WIN)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <climits>
+#else
+#include <semaphore.h>
+#include <cerrno>
+#include <ctime>
+#endif
+
 using namespace mu::audio;
 
+//! NOTE The worker is woken up by queued calls and by the buffer consumer,
+//! the timeout only covers changes nobody signals about
+static constexpr std::chrono::milliseconds MAX_WAIT_TIME(20);
+static constexpr std::chrono::seconds STATS_PERIOD(10);
+
 std::thread::id AudioThread::ID;
 
+//! NOTE Posting takes no lock, unlike notifying a condition variable under its mutex,
+//! so the audio driver can wake the worker up from its realtime callback
+struct AudioThread::Semaphore {
+#if defined(Q_OS_MAC)
+    dispatch_semaphore_t handle = dispatch_semaphore_create(0);
+
+    ~Semaphore() { dispatch_release(handle); }
+
+    void post() { dispatch_semaphore_signal(handle); }
+
+    void waitFor(std::chrono::milliseconds timeout)
+    {
+        dispatch_semaphore_wait(handle, dispatch_time(DISPATCH_TIME_NOW, timeout.count() * NSEC_PER_MSEC));
+    }
+
+#elif defined(Q_OS_WIN)
+    HANDLE handle = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+
+    ~Semaphore() { CloseHandle(handle); }
+
+    void post() { ReleaseSemaphore(handle, 1, nullptr); }
+
+    void waitFor(std::chrono::milliseconds timeout)
+    {
+        WaitForSingleObject(handle, static_cast<DWORD>(timeout.count()));
+    }
+
+#else
+    sem_t handle;
+
+    Semaphore() { sem_init(&handle, 0, 0); }
+    ~Semaphore() { sem_destroy(&handle); }
+
+    void post() { sem_post(&handle); }
+
+    void waitFor(std::chrono::milliseconds timeout)
+    {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout.count() / 1000;
+        deadline.tv_nsec += (timeout.count() % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        while (sem_timedwait(&handle, &deadline) == -1 && errno == EINTR) {
+        }
+    }
+
+#endif
+};
+
+AudioThread::AudioThread()
+    : m_wakeupSemaphore(std::make_unique<Semaphore>())
+{
+}
+
 AudioThread::~AudioThread()
 {
     if (m_running) {
@@ -40,6 +122,11 @@ AudioThread::~AudioThread()
     }
 }
 
+void AudioThread::setRealtimePriorityEnabled(bool enabled)
+{
+    m_realtimePriorityEnabled = enabled;
+}
+
 void AudioThread::run(const Runnable& onStart, const Runnable& loopBody)
 {
     m_onStart = onStart;
@@ -62,6 +149,7 @@ void AudioThread::stop(const Runnable& onFinished)
 {
     m_onFinished = onFinished;
     m_running = false;
+    wakeup();
     if (m_thread) {
         m_thread->join();
     }
@@ -72,27 +160,118 @@ bool AudioThread::isRunning() const
     return m_running;
 }
 
+void AudioThread::wakeup()
+{
+    if (m_wakeupRequested.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    m_wakeupRequestTime = Clock::now().time_since_epoch().count();
+
+    //! NOTE One post per request, the worker takes the request after it woke up
+    if (!m_wakeupRequested.exchange(true, std::memory_order_acq_rel)) {
+        m_wakeupSemaphore->post();
+    }
+}
+
 void AudioThread::main()
 {
     mu::runtime::setThreadName("audio_worker");
 
     AudioThread::ID = std::this_thread::get_id();
 
+    if (m_realtimePriorityEnabled) {
+        setupRealtimePriority();
+    }
+
+    mu::async::onQueued(AudioThread::ID, [this]() {
+        wakeup();
+    });
+
     if (m_onStart) {
         m_onStart();
     }
 
+    m_stats = Stats();
+    m_stats.periodStart = Clock::now();
+
     while (m_running) {
+        Clock::time_point busyStart = Clock::now();
+
         mu::async::processEvents();
 
         if (m_mainLoopBody) {
             m_mainLoopBody();
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        Clock::duration busyTime = Clock::now() - busyStart;
+
+        waitForWakeup();
+
+        updateStats(busyTime);
     }
 
+    mu::async::onQueued(AudioThread::ID, nullptr);
+
     if (m_onFinished) {
         m_onFinished();
     }
 }
+
+void AudioThread::waitForWakeup()
+{
+    //! NOTE A request made while the worker was busy has posted already, so this returns at once
+    m_wakeupSemaphore->waitFor(MAX_WAIT_TIME);
+
+    Clock::time_point requestTime{ Clock::duration(m_wakeupRequestTime.load()) };
+    if (!m_wakeupRequested.exchange(false, std::memory_order_acq_rel)) {
+        m_stats.timeouts++;
+        return;
+    }
+
+    Clock::duration latency = std::max(Clock::now() - requestTime, Clock::duration::zero());
+    m_stats.wakeups++;
+    m_stats.totalWakeupLatency += latency;
+    m_stats.maxWakeupLatency = std::max(m_stats.maxWakeupLatency, latency);
+}
+
+void AudioThread::setupRealtimePriority()
+{
+#ifdef Q_OS_LINUX
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+    int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (ret != 0) {
+        LOGW() << "failed to set realtime priority for the audio worker, error: " << ret;
+    }
+#endif
+}
+
+void AudioThread::updateStats(Clock::duration busyTime)
+{
+    using namespace std::chrono;
+
+    m_stats.busyTime += busyTime;
+
+    Clock::duration period = Clock::now() - m_stats.periodStart;
+    if (period < STATS_PERIOD) {
+        return;
+    }
+
+    auto toUs = [](Clock::duration d) {
+        return duration_cast<microseconds>(d).count();
+    };
+
+    double busyPercent = 100.0 * duration<double>(m_stats.busyTime).count() / duration<double>(period).count();
+    long long avgLatency = m_stats.wakeups > 0 ? toUs(m_stats.totalWakeupLatency) / m_stats.wakeups : 0;
+
+    LOGD() << "audio worker: busy " << busyPercent << "%"
+           << ", wakeups: " << m_stats.wakeups
+           << ", timeouts: " << m_stats.timeouts
+           << ", wakeup latency avg: " << avgLatency << "us"
+           << ", max: " << toUs(m_stats.maxWakeupLatency) << "us";
+
+    m_stats = Stats();
+    m_stats.periodStart = Clock::now();
+}
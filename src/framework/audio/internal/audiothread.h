@@ -27,24 +27,47 @@
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <chrono>
 
 namespace mu::audio {
 class AudioThread
 {
 public:
-    AudioThread() = default;
+    AudioThread();
     ~AudioThread();
 
     static std::thread::id ID;
 
     using Runnable = std::function<void ()>;
 
+    void setRealtimePriorityEnabled(bool enabled);
+
     void run(const Runnable& onStart, const Runnable& loopBody);
     void stop(const Runnable& onFinished = nullptr);
     bool isRunning() const;
 
+    //! NOTE Wakes the worker up to process queued calls and run the loop body,
+    //! may be called from any thread, does not lock
+    void wakeup();
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Semaphore;
+
     void main();
+    void waitForWakeup();
+    void setupRealtimePriority();
+    void updateStats(Clock::duration busyTime);
+
+    struct Stats {
+        Clock::time_point periodStart;
+        Clock::duration busyTime = Clock::duration::zero();
+        Clock::duration maxWakeupLatency = Clock::duration::zero();
+        Clock::duration totalWakeupLatency = Clock::duration::zero();
+        int wakeups = 0;
+        int timeouts = 0;
+    };
 
     Runnable m_onStart = nullptr;
     Runnable m_mainLoopBody = nullptr;
@@ -52,6 +75,13 @@ private:
 
     std::unique_ptr<std::thread> m_thread = nullptr;
     std::atomic<bool> m_running = false;
+    bool m_realtimePriorityEnabled = false;
+
+    std::unique_ptr<Semaphore> m_wakeupSemaphore;
+    std::atomic<bool> m_wakeupRequested = false;
+    std::atomic<Clock::rep> m_wakeupRequestTime = 0;
+
+    Stats m_stats;
 };
 }
 
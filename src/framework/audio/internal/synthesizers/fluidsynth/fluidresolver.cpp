@@ -40,6 +40,7 @@ FluidResolver::FluidResolver(const io::paths& soundFontDirs, async::Channel<io::
     ONLY_AUDIO_WORKER_THREAD;
 
     m_soundFontDirs = soundFontDirs;
+    m_soundFontCache = std::make_shared<FluidSoundFontCache>();
     refresh();
 
     sfDirsChanges.onReceive(this, [this](const io::paths& newSfDirs) {
@@ -52,7 +53,8 @@ ISynthesizerPtr FluidResolver::resolveSynth(const TrackId /*trackId*/, const Aud
 {
     ONLY_AUDIO_WORKER_THREAD;
 
-    ISynthesizerPtr synth = std::make_shared<FluidSynth>();
+    //! NOTE All synths share one copy of each soundfont through the cache
+    ISynthesizerPtr synth = std::make_shared<FluidSynth>(m_soundFontCache);
     synth->init();
 
     auto search = m_resourcesCache.find(resourceId);
@@ -32,6 +32,7 @@
 
 #include "isynthresolver.h"
 #include "fluidsynth.h"
+#include "fluidsoundfontcache.h"
 
 namespace mu::audio::synth {
 class FluidResolver : public ISynthResolver::IResolver, public async::Asyncable
@@ -51,6 +52,7 @@ private:
 
     io::paths m_soundFontDirs;
     std::unordered_map<AudioResourceId, io::path> m_resourcesCache;
+    FluidSoundFontCachePtr m_soundFontCache = nullptr;
 };
 }
 
@@ -0,0 +1,238 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fluidsoundfontcache.h"
+
+#include <atomic>
+#include <cstdio>
+
+#include <fluidsynth.h>
+
+#include "internal/audiosanitizer.h"
+
+#include "log.h"
+
+using namespace mu::audio::synth;
+
+//! NOTE Soundfont files of the host synth are read through these callbacks,
+//! so the amount of data read from disk (including lazily loaded samples) is known
+static std::atomic<uint64_t> s_loadedBytes{ 0 };
+
+static void* openFile(const char* fileName)
+{
+    return std::fopen(fileName, "rb");
+}
+
+static int readFile(void* buf, int count, void* handle)
+{
+    if (std::fread(buf, count, 1, static_cast<FILE*>(handle)) != 1) {
+        return FLUID_FAILED;
+    }
+
+    s_loadedBytes += static_cast<uint64_t>(count);
+    return FLUID_OK;
+}
+
+static int seekFile(void* handle, long offset, int origin)
+{
+    return std::fseek(static_cast<FILE*>(handle), offset, origin) == 0 ? FLUID_OK : FLUID_FAILED;
+}
+
+static long tellFile(void* handle)
+{
+    return std::ftell(static_cast<FILE*>(handle));
+}
+
+static int closeFile(void* handle)
+{
+    return std::fclose(static_cast<FILE*>(handle)) == 0 ? FLUID_OK : FLUID_FAILED;
+}
+
+struct FluidSoundFontCache::Host {
+    fluid_settings_t* settings = nullptr;
+    fluid_synth_t* synth = nullptr;
+
+    ~Host()
+    {
+        delete_fluid_synth(synth);
+        delete_fluid_settings(settings);
+    }
+};
+
+struct FluidSoundFontCache::SharedSoundFont {
+    FluidSoundFontCache* cache = nullptr;
+    std::string fileName;
+    int id = -1; // in the host synth
+    fluid_sfont_t* sfont = nullptr;
+    int users = 0;
+};
+
+FluidSoundFontCache::FluidSoundFontCache(fluid_sfloader_t* loader)
+    : m_host(std::make_unique<Host>())
+{
+    m_host->settings = new_fluid_settings();
+    fluid_settings_setint(m_host->settings, "synth.lock-memory", 0);
+    fluid_settings_setint(m_host->settings, "synth.threadsafe-api", 0);
+    fluid_settings_setint(m_host->settings, "synth.dynamic-sample-loading", 1);
+    fluid_settings_setint(m_host->settings, "synth.polyphony", 1); // never plays, only owns the soundfonts
+
+    m_host->synth = new_fluid_synth(m_host->settings);
+
+    if (!loader) {
+        loader = new_fluid_defsfloader(m_host->settings);
+        fluid_sfloader_set_callbacks(loader, openFile, readFile, seekFile, tellFile, closeFile);
+    }
+
+    fluid_synth_add_sfloader(m_host->synth, loader);
+}
+
+FluidSoundFontCache::~FluidSoundFontCache()
+{
+    IF_ASSERT_FAILED(m_soundFonts.empty()) {
+        LOGE() << "soundfonts are still in use: " << m_soundFonts.size();
+    }
+}
+
+void FluidSoundFontCache::attachTo(fluid_synth_t* synth)
+{
+    IF_ASSERT_FAILED(synth) {
+        return;
+    }
+
+    fluid_sfloader_t* loader = new_fluid_sfloader(loadSoundFont, delete_fluid_sfloader);
+    fluid_sfloader_set_data(loader, this);
+
+    //! NOTE The synth owns the loader and tries it before its default one
+    fluid_synth_add_sfloader(synth, loader);
+}
+
+size_t FluidSoundFontCache::soundFontsCount() const
+{
+    return m_soundFonts.size();
+}
+
+uint64_t FluidSoundFontCache::loadedBytes() const
+{
+    return s_loadedBytes;
+}
+
+FluidSoundFontCache::SharedSoundFont* FluidSoundFontCache::acquire(const std::string& fileName)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    auto it = m_soundFonts.find(fileName);
+    if (it != m_soundFonts.end()) {
+        SharedSoundFont* soundFont = it->second.get();
+        soundFont->users++;
+        return soundFont;
+    }
+
+    int id = fluid_synth_sfload(m_host->synth, fileName.c_str(), 0);
+    if (id == FLUID_FAILED) {
+        return nullptr;
+    }
+
+    auto soundFont = std::make_unique<SharedSoundFont>();
+    soundFont->cache = this;
+    soundFont->fileName = fileName;
+    soundFont->id = id;
+    soundFont->sfont = fluid_synth_get_sfont_by_id(m_host->synth, id);
+    soundFont->users = 1;
+
+    LOGI() << "shared soundfont loaded: " << fileName << ", bytes read from soundfonts: " << loadedBytes();
+
+    SharedSoundFont* result = soundFont.get();
+    m_soundFonts.emplace(fileName, std::move(soundFont));
+    return result;
+}
+
+void FluidSoundFontCache::release(SharedSoundFont* soundFont)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    if (--soundFont->users > 0) {
+        return;
+    }
+
+    //! NOTE Samples are freed once no voice of any synth uses them
+    fluid_synth_sfunload(m_host->synth, soundFont->id, 0);
+
+    LOGI() << "shared soundfont unloaded: " << soundFont->fileName;
+
+    m_soundFonts.erase(soundFont->fileName);
+}
+
+fluid_sfont_t* FluidSoundFontCache::loadSoundFont(fluid_sfloader_t* loader, const char* fileName)
+{
+    FluidSoundFontCache* cache = static_cast<FluidSoundFontCache*>(fluid_sfloader_get_data(loader));
+
+    SharedSoundFont* soundFont = cache->acquire(fileName);
+    if (!soundFont) {
+        return nullptr;
+    }
+
+    fluid_sfont_t* sfont = new_fluid_sfont(soundFontName, soundFontPreset,
+                                           soundFontIterationStart, soundFontIterationNext,
+                                           freeSoundFont);
+    if (!sfont) {
+        cache->release(soundFont);
+        return nullptr;
+    }
+
+    fluid_sfont_set_data(sfont, soundFont);
+    return sfont;
+}
+
+const char* FluidSoundFontCache::soundFontName(fluid_sfont_t* sfont)
+{
+    SharedSoundFont* soundFont = static_cast<SharedSoundFont*>(fluid_sfont_get_data(sfont));
+    return fluid_sfont_get_name(soundFont->sfont);
+}
+
+//! NOTE The presets of the shared soundfont are handed out as they are:
+//! a preset plays its notes on the synth passed to noteon, and selecting it on a channel
+//! loads its samples into the shared soundfont
+fluid_preset_t* FluidSoundFontCache::soundFontPreset(fluid_sfont_t* sfont, int bank, int program)
+{
+    SharedSoundFont* soundFont = static_cast<SharedSoundFont*>(fluid_sfont_get_data(sfont));
+    return fluid_sfont_get_preset(soundFont->sfont, bank, program);
+}
+
+void FluidSoundFontCache::soundFontIterationStart(fluid_sfont_t* sfont)
+{
+    SharedSoundFont* soundFont = static_cast<SharedSoundFont*>(fluid_sfont_get_data(sfont));
+    fluid_sfont_iteration_start(soundFont->sfont);
+}
+
+fluid_preset_t* FluidSoundFontCache::soundFontIterationNext(fluid_sfont_t* sfont)
+{
+    SharedSoundFont* soundFont = static_cast<SharedSoundFont*>(fluid_sfont_get_data(sfont));
+    return fluid_sfont_iteration_next(soundFont->sfont);
+}
+
+int FluidSoundFontCache::freeSoundFont(fluid_sfont_t* sfont)
+{
+    SharedSoundFont* soundFont = static_cast<SharedSoundFont*>(fluid_sfont_get_data(sfont));
+    soundFont->cache->release(soundFont);
+    delete_fluid_sfont(sfont);
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_AUDIO_FLUIDSOUNDFONTCACHE_H
+#define MU_AUDIO_FLUIDSOUNDFONTCACHE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+typedef struct _fluid_synth_t fluid_synth_t;
+typedef struct _fluid_sfloader_t fluid_sfloader_t;
+typedef struct _fluid_sfont_t fluid_sfont_t;
+typedef struct _fluid_preset_t fluid_preset_t;
+
+namespace mu::audio::synth {
+//! NOTE Keeps every soundfont file loaded only once for all FluidSynth instances.
+//! The soundfont itself is owned by a private host synth; a synth attached to the cache
+//! gets a light-weight soundfont that hands out the presets of the shared one,
+//! so preset tables and sample data are parsed and decoded once.
+//! Samples are still loaded lazily, when a preset is selected on a channel of any synth.
+//! All methods must be called from the audio worker thread
+class FluidSoundFontCache
+{
+public:
+    //! NOTE The soundfont files are read by the default fluid loader,
+    //! another loader can be given instead (e.g. in the tests), the cache takes its ownership
+    explicit FluidSoundFontCache(fluid_sfloader_t* loader = nullptr);
+    ~FluidSoundFontCache();
+
+    //! NOTE Must be called before any soundfont is loaded into the synth
+    void attachTo(fluid_synth_t* synth);
+
+    size_t soundFontsCount() const;
+    uint64_t loadedBytes() const;
+
+private:
+    struct SharedSoundFont;
+
+    static fluid_sfont_t* loadSoundFont(fluid_sfloader_t* loader, const char* fileName);
+    static const char* soundFontName(fluid_sfont_t* sfont);
+    static fluid_preset_t* soundFontPreset(fluid_sfont_t* sfont, int bank, int program);
+    static void soundFontIterationStart(fluid_sfont_t* sfont);
+    static fluid_preset_t* soundFontIterationNext(fluid_sfont_t* sfont);
+    static int freeSoundFont(fluid_sfont_t* sfont);
+
+    SharedSoundFont* acquire(const std::string& fileName);
+    void release(SharedSoundFont* soundFont);
+
+    struct Host;
+    std::unique_ptr<Host> m_host;
+    std::map<std::string, std::unique_ptr<SharedSoundFont> > m_soundFonts;
+};
+
+using FluidSoundFontCachePtr = std::shared_ptr<FluidSoundFontCache>;
+}
+
+#endif // MU_AUDIO_FLUIDSOUNDFONTCACHE_H
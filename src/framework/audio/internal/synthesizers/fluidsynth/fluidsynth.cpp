@@ -56,7 +56,8 @@ struct mu::audio::synth::Fluid {
     }
 };
 
-FluidSynth::FluidSynth()
+FluidSynth::FluidSynth(FluidSoundFontCachePtr soundFontCache)
+    : m_soundFontCache(std::move(soundFontCache))
 {
     m_fluid = std::make_shared<Fluid>();
 }
@@ -153,6 +154,10 @@ Ret FluidSynth::init()
 
     m_fluid->synth = new_fluid_synth(m_fluid->settings);
 
+    if (m_soundFontCache) {
+        m_soundFontCache->attachTo(m_fluid->synth);
+    }
+
     LOGD() << "synth inited\n";
     return true;
 }
@@ -215,6 +220,16 @@ Ret FluidSynth::removeSoundFonts()
     return ok ? make_ret(Err::NoError) : make_ret(Err::SoundFontFailedUnload);
 }
 
+std::vector<io::path> FluidSynth::soundFonts() const
+{
+    std::vector<io::path> result;
+    for (const SoundFont& sf : m_soundFonts) {
+        result.push_back(sf.path);
+    }
+
+    return result;
+}
+
 Ret FluidSynth::setupMidiChannels(const std::vector<Event>& events)
 {
     IF_ASSERT_FAILED(m_fluid->synth) {
@@ -253,11 +268,10 @@ bool FluidSynth::handleEvent(const Event& e)
     static uint8_t CTRL_PROGRAM = 0x81;
 
     if (e.isChannelVoice20()) {
-        auto events = e.toMIDI10();
         bool ret = true;
-        for (auto& event : events) {
+        e.forEachMIDI10([this, &ret](const Event& event) {
             ret &= handleEvent(event);
-        }
+        });
         return ret;
     }
 
@@ -31,13 +31,14 @@
 #include "modularity/ioc.h"
 
 #include "isynthesizer.h"
+#include "fluidsoundfontcache.h"
 
 namespace mu::audio::synth {
 struct Fluid;
 class FluidSynth : public ISynthesizer
 {
 public:
-    FluidSynth();
+    explicit FluidSynth(FluidSoundFontCachePtr soundFontCache = nullptr);
 
     bool isValid() const override;
 
@@ -49,6 +50,7 @@ public:
     void setSampleRate(unsigned int sampleRate) override;
     Ret addSoundFonts(const std::vector<io::path>& sfonts) override;
     Ret removeSoundFonts() override;
+    std::vector<io::path> soundFonts() const override;
 
     bool isActive() const override;
     void setIsActive(bool arg) override;
@@ -84,6 +86,7 @@ private:
         io::path path;
     };
 
+    FluidSoundFontCachePtr m_soundFontCache = nullptr; // must outlive m_fluid
     std::shared_ptr<Fluid> m_fluid = nullptr;
     std::vector<SoundFont> m_soundFonts;
 
@@ -72,6 +72,12 @@ Ret SanitySynthesizer::removeSoundFonts()
     return m_synth->removeSoundFonts();
 }
 
+std::vector<io::path> SanitySynthesizer::soundFonts() const
+{
+    ONLY_AUDIO_WORKER_THREAD;
+    return m_synth->soundFonts();
+}
+
 bool SanitySynthesizer::isActive() const
 {
     ONLY_AUDIO_WORKER_THREAD;
@@ -39,6 +39,7 @@ public:
     Ret init() override;
     Ret addSoundFonts(const std::vector<io::path>& sfonts) override;
     Ret removeSoundFonts() override;
+    std::vector<io::path> soundFonts() const override;
 
     bool isActive() const override;
     void setIsActive(bool arg) override;
@@ -61,6 +61,7 @@ mu::Ret AudioEngine::init(IAudioBufferPtr bufferPtr)
     }
 
     m_mixer = std::make_shared<Mixer>();
+    m_frozenTrackCache = std::make_shared<FrozenTrackCache>();
 
     m_buffer = std::move(bufferPtr);
     m_buffer->setSource(m_mixer->mixedSource());
@@ -77,6 +78,7 @@ void AudioEngine::deinit()
         m_buffer->setSource(nullptr);
         m_buffer = nullptr;
         m_mixer = nullptr;
+        m_frozenTrackCache = nullptr;
         m_inited = false;
     }
 }
@@ -119,3 +121,9 @@ MixerPtr AudioEngine::mixer() const
     ONLY_AUDIO_WORKER_THREAD;
     return m_mixer;
 }
+
+FrozenTrackCachePtr AudioEngine::frozenTrackCache() const
+{
+    ONLY_AUDIO_WORKER_THREAD;
+    return m_frozenTrackCache;
+}
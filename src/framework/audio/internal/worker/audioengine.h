@@ -30,6 +30,7 @@
 
 #include "iaudiodriver.h"
 #include "internal/worker/mixer.h"
+#include "internal/worker/frozentrackcache.h"
 #include "internal/iaudiobuffer.h"
 
 namespace mu::audio {
@@ -48,6 +49,7 @@ public:
     void setAudioChannelsCount(const audioch_t count);
 
     MixerPtr mixer() const;
+    FrozenTrackCachePtr frozenTrackCache() const;
 
 private:
     AudioEngine();
@@ -55,6 +57,7 @@ private:
     bool m_inited = false;
 
     MixerPtr m_mixer = nullptr;
+    FrozenTrackCachePtr m_frozenTrackCache = nullptr;
     IAudioBufferPtr m_buffer = nullptr;
 };
 }
@@ -55,9 +55,10 @@ bool AudioStream::loadFile(const io::path& path)
 void AudioStream::convertSampleRate(unsigned int sampleRate)
 {
     if (sampleRate != m_sampleRate) {
-        auto src = new SampleRateConvertor(m_data, m_channels, m_sampleRate, sampleRate);
-        m_data = src->convert();
+        SampleRateConvertor src(m_data, m_channels, m_sampleRate, sampleRate);
+        m_data = src.convert();
         m_sampleRate = sampleRate;
+        m_src.setSampleRateIn(m_sampleRate);
     }
 }
 
@@ -0,0 +1,364 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "frozentrackcache.h"
+
+#include <algorithm>
+
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "async/async.h"
+#include "log.h"
+#include "internal/audiosanitizer.h"
+
+using namespace mu;
+using namespace mu::audio;
+using namespace mu::midi;
+
+static constexpr unsigned int RENDER_BLOCK_SIZE = 1024;
+static constexpr unsigned int RENDER_TAIL_SECS = 3; // release and reverb after the last event
+static constexpr tempo_t DEFAULT_TEMPO = 500000;
+static constexpr std::chrono::milliseconds RENDER_SLICE_TIME(2); // per worker loop, small against the audio buffer
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+static void hashCombine(uint64_t& hash, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+}
+
+static void hashCombine(uint64_t& hash, const Event& event)
+{
+    for (uint32_t word : event.rawData()) {
+        hashCombine(hash, word);
+    }
+}
+
+FrozenTrackCache::FrozenTrackCache()
+{
+    ONLY_AUDIO_WORKER_THREAD;
+}
+
+uint64_t FrozenTrackCache::makeKey(const Events& events, const MidiMapping& mapping,
+                                   const std::vector<Event>& setupEvents, const AudioInputParams& params,
+                                   const std::vector<io::path>& soundFonts, unsigned int sampleRate)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    hashCombine(hash, sampleRate);
+    hashCombine(hash, static_cast<uint64_t>(params.type));
+    for (char c : params.resourceId) {
+        hashCombine(hash, static_cast<uint64_t>(c));
+    }
+
+    for (const io::path& soundFont : soundFonts) {
+        for (char c : soundFont.toStdString()) {
+            hashCombine(hash, static_cast<uint64_t>(c));
+        }
+
+        QFileInfo fileInfo(soundFont.toQString());
+        hashCombine(hash, static_cast<uint64_t>(fileInfo.size()));
+        hashCombine(hash, static_cast<uint64_t>(fileInfo.lastModified().toMSecsSinceEpoch()));
+    }
+
+    hashCombine(hash, mapping.division);
+    for (const auto& pair : mapping.tempo) {
+        hashCombine(hash, pair.first);
+        hashCombine(hash, pair.second);
+    }
+
+    for (const Event& event : setupEvents) {
+        hashCombine(hash, event);
+    }
+
+    for (const auto& pair : events) {
+        hashCombine(hash, pair.first);
+        for (const Event& event : pair.second) {
+            hashCombine(hash, event);
+        }
+    }
+
+    return hash;
+}
+
+void FrozenTrackCache::setMemoryLimit(size_t bytes)
+{
+    m_memoryLimit = bytes;
+}
+
+bool FrozenTrackCache::isEnabled() const
+{
+    return m_memoryLimit > 0;
+}
+
+FrozenTrackPtr FrozenTrackCache::track(uint64_t key)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    auto it = m_tracks.find(key);
+    if (it == m_tracks.end()) {
+        return nullptr;
+    }
+
+    it->second.lastUsed = ++m_useCounter;
+    return it->second.track;
+}
+
+void FrozenTrackCache::requestRender(RenderRequest&& request)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    IF_ASSERT_FAILED(request.synth) {
+        return;
+    }
+
+    if (m_tracks.find(request.key) != m_tracks.end()) {
+        return;
+    }
+
+    if (m_currentJob && m_currentJob->request.trackId == request.trackId) {
+        if (m_currentJob->request.key == request.key) {
+            return;
+        }
+
+        //! NOTE The events of the track changed, the rendered part is outdated
+        m_currentJob = nullptr;
+    }
+
+    auto sameTrack = std::find_if(m_jobs.begin(), m_jobs.end(), [&request](const RenderRequest& job) {
+        return job.trackId == request.trackId;
+    });
+
+    if (sameTrack != m_jobs.end()) {
+        *sameTrack = std::move(request);
+    } else {
+        m_jobs.push_back(std::move(request));
+    }
+
+    scheduleRenderSlice();
+}
+
+async::Channel<uint64_t> FrozenTrackCache::trackRendered() const
+{
+    return m_trackRendered;
+}
+
+async::Channel<uint64_t> FrozenTrackCache::trackEvicted() const
+{
+    return m_trackEvicted;
+}
+
+void FrozenTrackCache::scheduleRenderSlice()
+{
+    if (m_renderSliceScheduled) {
+        return;
+    }
+
+    m_renderSliceScheduled = true;
+
+    //! NOTE Queued, so the worker loop processes the audio blocks between the slices
+    async::Async::call(this, [this]() {
+        renderSlice();
+    });
+}
+
+void FrozenTrackCache::renderSlice()
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    m_renderSliceScheduled = false;
+
+    if (!m_currentJob && !startNextJob()) {
+        return;
+    }
+
+    if (renderJob(*m_currentJob, Clock::now() + RENDER_SLICE_TIME)) {
+        finishJob(m_currentJob->track);
+    }
+
+    if (m_currentJob || !m_jobs.empty()) {
+        scheduleRenderSlice();
+    }
+}
+
+bool FrozenTrackCache::startNextJob()
+{
+    while (!m_jobs.empty()) {
+        auto job = std::make_unique<RenderJob>();
+        job->request = std::move(m_jobs.front());
+        m_jobs.pop_front();
+
+        m_currentJob = std::move(job);
+        if (prepareJob(*m_currentJob)) {
+            return true;
+        }
+
+        finishJob(nullptr);
+    }
+
+    return false;
+}
+
+bool FrozenTrackCache::prepareJob(RenderJob& job)
+{
+    const RenderRequest& request = job.request;
+    audioch_t channels = static_cast<audioch_t>(request.synth->audioChannelsCount());
+    if (channels == 0 || request.sampleRate == 0 || request.events.empty()) {
+        return false;
+    }
+
+    //! NOTE Tick -> sample conversion, the same tempo map is used for the live playback
+    TempoMap tempos = request.mapping.tempo;
+    if (tempos.empty()) {
+        tempos.insert({ 0, DEFAULT_TEMPO });
+    }
+
+    double division = request.mapping.division > 0 ? request.mapping.division : 480;
+    for (const auto& pair : tempos) {
+        TempoSegment segment;
+        segment.startTick = pair.first;
+        segment.samplesPerTick = pair.second / 1000000.0 * request.sampleRate / division;
+        if (!job.tempoSegments.empty()) {
+            const TempoSegment& prev = job.tempoSegments.back();
+            segment.startSample = prev.startSample + (segment.startTick - prev.startTick) * prev.samplesPerTick;
+        }
+        job.tempoSegments.push_back(segment);
+    }
+
+    job.totalSamples = sampleAt(job, request.events.rbegin()->first) + RENDER_TAIL_SECS * request.sampleRate;
+    job.tempoSegmentIdx = 0;
+
+    size_t bytes = job.totalSamples * channels * sizeof(float);
+    if (bytes > m_memoryLimit) {
+        LOGW() << "track " << request.trackId << " does not fit into the freeze memory limit";
+        return false;
+    }
+
+    //! NOTE The samples are reserved up front, so they count against the limit while rendering
+    makeRoom(bytes);
+
+    job.track = std::make_shared<FrozenTrack>();
+    job.track->key = request.key;
+    job.track->sampleRate = request.sampleRate;
+    job.track->audioChannelsCount = channels;
+
+    //! NOTE Only reserved: the samples are zeroed block by block while rendering, not all in one slice
+    job.track->samples.reserve(job.totalSamples * channels);
+
+    job.nextEvents = request.events.cbegin();
+    job.position = 0;
+
+    request.synth->setSampleRate(request.sampleRate);
+    request.synth->flushSound();
+
+    return true;
+}
+
+bool FrozenTrackCache::renderJob(RenderJob& job, Clock::time_point deadline) const
+{
+    const synth::ISynthesizerPtr& synth = job.request.synth;
+    const Events& events = job.request.events;
+    std::vector<float>& samples = job.track->samples;
+    audioch_t channels = job.track->audioChannelsCount;
+
+    while (Clock::now() < deadline) {
+        size_t target = job.totalSamples;
+        if (job.nextEvents != events.cend()) {
+            target = std::min(sampleAt(job, job.nextEvents->first), job.totalSamples);
+        }
+
+        if (job.position >= target) {
+            if (job.nextEvents == events.cend()) {
+                return true;
+            }
+
+            for (const Event& event : job.nextEvents->second) {
+                synth->handleEvent(event);
+            }
+
+            ++job.nextEvents;
+            continue;
+        }
+
+        unsigned int count = static_cast<unsigned int>(std::min<size_t>(RENDER_BLOCK_SIZE, target - job.position));
+        samples.resize((job.position + count) * channels, 0.f);
+        synth->process(samples.data() + job.position * channels, count);
+        job.position += count;
+    }
+
+    return false;
+}
+
+size_t FrozenTrackCache::sampleAt(RenderJob& job, tick_t tick) const
+{
+    const std::vector<TempoSegment>& segments = job.tempoSegments;
+    while (job.tempoSegmentIdx + 1 < segments.size() && segments[job.tempoSegmentIdx + 1].startTick <= tick) {
+        ++job.tempoSegmentIdx;
+    }
+
+    const TempoSegment& segment = segments[job.tempoSegmentIdx];
+    double ticks = tick >= segment.startTick ? tick - segment.startTick : 0;
+    return static_cast<size_t>(segment.startSample + ticks * segment.samplesPerTick);
+}
+
+void FrozenTrackCache::finishJob(FrozenTrackPtr track)
+{
+    uint64_t key = m_currentJob->request.key;
+    m_currentJob = nullptr;
+
+    if (track) {
+        insert(track);
+    }
+
+    m_trackRendered.send(key);
+}
+
+void FrozenTrackCache::makeRoom(size_t bytes)
+{
+    //! NOTE Evict least recently used tracks, the sources that play them release their copy
+    while (!m_tracks.empty() && m_memoryUsed + bytes > m_memoryLimit) {
+        auto oldest = std::min_element(m_tracks.begin(), m_tracks.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+
+        uint64_t key = oldest->first;
+        m_memoryUsed -= oldest->second.track->samples.size() * sizeof(float);
+        m_tracks.erase(oldest);
+
+        m_trackEvicted.send(key);
+    }
+}
+
+void FrozenTrackCache::insert(FrozenTrackPtr track)
+{
+    size_t bytes = track->samples.size() * sizeof(float);
+
+    makeRoom(bytes);
+
+    m_memoryUsed += bytes;
+    m_tracks[track->key] = { track, ++m_useCounter };
+}
@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_AUDIO_FROZENTRACKCACHE_H
+#define MU_AUDIO_FROZENTRACKCACHE_H
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <deque>
+#include <chrono>
+
+#include "async/asyncable.h"
+#include "async/channel.h"
+#include "midi/miditypes.h"
+
+#include "isynthesizer.h"
+#include "audiotypes.h"
+
+namespace mu::audio {
+//! NOTE Rendered output of a whole MIDI track (before the mixer channel fx),
+//! so unchanged tracks can be played back without running the synthesizer
+struct FrozenTrack {
+    uint64_t key = 0;
+    unsigned int sampleRate = 0;
+    audioch_t audioChannelsCount = 0;
+    std::vector<float> samples; // interleaved
+
+    size_t samplesPerChannel() const { return audioChannelsCount ? samples.size() / audioChannelsCount : 0; }
+};
+
+using FrozenTrackPtr = std::shared_ptr<const FrozenTrack>;
+
+class FrozenTrackCache : public async::Asyncable
+{
+public:
+    FrozenTrackCache();
+
+    struct RenderRequest {
+        TrackId trackId = -1;
+        uint64_t key = 0;
+        synth::ISynthesizerPtr synth = nullptr;
+        midi::Events events;
+        midi::MidiMapping mapping;
+        unsigned int sampleRate = 0;
+    };
+
+    //! NOTE The soundfonts are identified by their files, so replacing a soundfont under the same name re-renders the tracks
+    static uint64_t makeKey(const midi::Events& events, const midi::MidiMapping& mapping,
+                            const std::vector<midi::Event>& setupEvents, const AudioInputParams& params,
+                            const std::vector<io::path>& soundFonts, unsigned int sampleRate);
+
+    void setMemoryLimit(size_t bytes);
+    bool isEnabled() const;
+
+    FrozenTrackPtr track(uint64_t key);
+
+    //! NOTE Renders in short slices between the audio blocks of the worker thread,
+    //! because the synths (and the soundfonts they share) may only be used there.
+    //! A queued or running request of the same track is replaced
+    void requestRender(RenderRequest&& request);
+    async::Channel<uint64_t> trackRendered() const;
+
+    //! NOTE The limit covers the tracks played by the sources too,
+    //! so a source releases its copy when its track is evicted
+    async::Channel<uint64_t> trackEvicted() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        FrozenTrackPtr track = nullptr;
+        uint64_t lastUsed = 0;
+    };
+
+    struct TempoSegment {
+        midi::tick_t startTick = 0;
+        double startSample = 0.0;
+        double samplesPerTick = 0.0;
+    };
+
+    //! NOTE The track being rendered, kept between the slices
+    struct RenderJob {
+        RenderRequest request;
+        std::shared_ptr<FrozenTrack> track = nullptr;
+        std::vector<TempoSegment> tempoSegments;
+        size_t tempoSegmentIdx = 0;
+        midi::Events::const_iterator nextEvents;
+        size_t position = 0; // samples per channel
+        size_t totalSamples = 0;
+    };
+
+    void scheduleRenderSlice();
+    void renderSlice();
+
+    bool startNextJob();
+    bool prepareJob(RenderJob& job);
+    //! NOTE Returns true when the whole track is rendered
+    bool renderJob(RenderJob& job, Clock::time_point deadline) const;
+    size_t sampleAt(RenderJob& job, midi::tick_t tick) const;
+    void finishJob(FrozenTrackPtr track);
+
+    void makeRoom(size_t bytes);
+    void insert(FrozenTrackPtr track);
+
+    size_t m_memoryLimit = 0;
+
+    std::deque<RenderRequest> m_jobs;
+    std::unique_ptr<RenderJob> m_currentJob = nullptr;
+    bool m_renderSliceScheduled = false;
+
+    std::map<uint64_t, Entry> m_tracks;
+    size_t m_memoryUsed = 0;
+    uint64_t m_useCounter = 0;
+
+    async::Channel<uint64_t> m_trackRendered;
+    async::Channel<uint64_t> m_trackEvicted;
+};
+
+using FrozenTrackCachePtr = std::shared_ptr<FrozenTrackCache>;
+}
+
+#endif // MU_AUDIO_FROZENTRACKCACHE_H
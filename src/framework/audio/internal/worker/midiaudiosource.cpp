@@ -23,12 +23,14 @@
 #include "midiaudiosource.h"
 
 #include <limits>
+#include <algorithm>
 #include <cstring>
 
 #include "log.h"
 #include "realfn.h"
 #include "internal/audiosanitizer.h"
 #include "internal/synthesizers/fluidsynth/fluidsynth.h"
+#include "internal/worker/audioengine.h"
 
 using namespace mu;
 using namespace mu::audio;
@@ -36,6 +38,9 @@ using namespace mu::audio::synth;
 using namespace mu::midi;
 
 static tick_t MINIMAL_REQUIRED_LOOKAHEAD = 480 * 4 * 10; // about 10 measures of 4/4 time signature
+static constexpr unsigned int FREEZE_REQUEST_DELAY_SECS = 2; // idle time after an edit before the track is re-rendered
+static constexpr unsigned int LIVE_SYNTH_TAIL_SECS = 3; // keep the live synth running after a note was triggered
+static constexpr unsigned int LIVE_SYNTH_BLOCK_SIZE = 1024; // the blocks the audio buffer is filled up with
 
 MidiAudioSource::MidiAudioSource(const TrackId trackId, const MidiData& midiData, const AudioInputParams& params,
                                  async::Channel<AudioInputParams> paramsChanged)
@@ -65,6 +70,33 @@ MidiAudioSource::MidiAudioSource(const TrackId trackId, const MidiData& midiData
 
     buildTempoMap();
 
+    m_frozenTrackCache = AudioEngine::instance()->frozenTrackCache();
+
+    m_stream.eventsChanged.onNotify(this, [this]() {
+        dropFrozenTrack();
+        m_allEventsRequestPending = true;
+        m_idleSamples = 0;
+    });
+
+    m_stream.allEventsStream.onReceive(this, [this](Events events) {
+        onAllEventsReceived(std::move(events));
+    });
+
+    if (m_frozenTrackCache) {
+        m_frozenTrackCache->trackRendered().onReceive(this, [this](uint64_t key) {
+            if (key == m_freezeKey && !isActive()) {
+                adoptFrozenTrack();
+            }
+        });
+
+        m_frozenTrackCache->trackEvicted().onReceive(this, [this](uint64_t key) {
+            //! NOTE Not requested again until the next edit, the live synth plays the track
+            if (m_frozenTrack && m_frozenTrack->key == key) {
+                dropFrozenTrack();
+            }
+        });
+    }
+
     requestNextEvents(MINIMAL_REQUIRED_LOOKAHEAD);
 }
 
@@ -72,6 +104,13 @@ MidiAudioSource::~MidiAudioSource()
 {
     m_stream.backgroundStream.resetOnReceive(this);
     m_stream.mainStream.resetOnReceive(this);
+    m_stream.eventsChanged.resetOnNotify(this);
+    m_stream.allEventsStream.resetOnReceive(this);
+
+    if (m_frozenTrackCache) {
+        m_frozenTrackCache->trackRendered().resetOnReceive(this);
+        m_frozenTrackCache->trackEvicted().resetOnReceive(this);
+    }
 }
 
 bool MidiAudioSource::isActive() const
@@ -96,9 +135,19 @@ void MidiAudioSource::setIsActive(const bool active)
     // invalidate cached events when we stop playing
     if (!active) {
         invalidateCaches(m_mainStreamEventsBuffer);
+        m_playbackPosition = 0;
     }
 
     m_synth->setIsActive(active);
+
+    if (active) {
+        m_wasPlayed = true;
+    }
+
+    //! NOTE A track rendered during the playback is picked up when it stops
+    if (!active && !m_frozenTrack) {
+        adoptFrozenTrack();
+    }
 }
 
 void MidiAudioSource::setupChannels()
@@ -154,6 +203,9 @@ void MidiAudioSource::sendRequestFromTick(const tick_t from)
 {
     tick_t to = std::min(m_stream.lastTick, from + MINIMAL_REQUIRED_LOOKAHEAD);
 
+    //! NOTE Happens once per lookahead period. The request is queued to the main thread,
+    //! the events arrive later through the main stream
+    AudioSanitizer::NonRealtimeScope nonRealtimeScope;
     m_stream.eventsRequest.send(from, to);
     m_hasActiveRequest = true;
 }
@@ -164,18 +216,9 @@ void MidiAudioSource::findAndSendNextEvents(MidiAudioSource::EventsBuffer& event
         return;
     }
 
-    tick_t from = eventsBuffer.currentTick;
-    tick_t to = eventsBuffer.currentTick + nextTicks;
-
-    for (tick_t tick = from; tick <= to; ++tick) {
-        eventsBuffer.currentTick = tick;
-
-        if (!eventsBuffer.hasEventsForTick(tick)) {
-            continue;
-        }
-
-        sendEvents(eventsBuffer.pop());
-    }
+    eventsBuffer.popUntil(eventsBuffer.currentTick + nextTicks, [this](const std::vector<Event>& events) {
+        sendEvents(events);
+    });
 }
 
 void MidiAudioSource::handleBackgroundStream(const msecs_t nextMsecsNumber)
@@ -212,6 +255,11 @@ void MidiAudioSource::setSampleRate(unsigned int sampleRate)
 {
     ONLY_AUDIO_WORKER_THREAD;
 
+    if (m_sampleRate != sampleRate) {
+        dropFrozenTrack();
+        m_allEventsRequestPending = true;
+    }
+
     m_sampleRate = sampleRate;
 
     if (!m_synth) {
@@ -251,9 +299,154 @@ void MidiAudioSource::process(float* buffer, unsigned int sampleCount)
         return;
     }
 
+    if (m_frozenTrack && isActive()) {
+        processFrozenTrack(buffer, sampleCount);
+        return;
+    }
+
     m_synth->process(buffer, sampleCount);
 
     handleNextMsecs(sampleCount * 1000 / m_sampleRate);
+
+    if (isActive()) {
+        m_playbackPosition += sampleCount;
+    } else {
+        requestAllEventsWhenIdle(sampleCount);
+    }
+}
+
+void MidiAudioSource::processFrozenTrack(float* buffer, unsigned int sampleCount)
+{
+    audioch_t channels = m_frozenTrack->audioChannelsCount;
+    size_t frozenSamples = m_frozenTrack->samplesPerChannel();
+    size_t available = m_playbackPosition < frozenSamples ? frozenSamples - m_playbackPosition : 0;
+    size_t count = std::min<size_t>(sampleCount, available);
+
+    const float* frozen = m_frozenTrack->samples.data() + m_playbackPosition * channels;
+    std::copy(frozen, frozen + count * channels, buffer);
+    std::fill(buffer + count * channels, buffer + sampleCount * channels, 0.f);
+
+    m_playbackPosition += sampleCount;
+
+    //! NOTE Notes triggered by the user while playing still go through the live synth
+    if (!m_backgroundStreamEventsBuffer.isEmpty()) {
+        m_liveSynthTailSamples = static_cast<uint64_t>(LIVE_SYNTH_TAIL_SECS) * m_sampleRate;
+    }
+
+    if (m_liveSynthTailSamples == 0) {
+        return;
+    }
+
+    //! NOTE The buffer is sized when the track is adopted, bigger blocks are mixed in parts
+    for (unsigned int done = 0; done < sampleCount;) {
+        unsigned int count = std::min<unsigned int>(sampleCount - done, LIVE_SYNTH_BLOCK_SIZE);
+        m_synth->process(m_liveSynthBuffer.data(), count);
+
+        float* out = buffer + done * channels;
+        for (size_t i = 0; i < count * channels; ++i) {
+            out[i] += m_liveSynthBuffer[i];
+        }
+
+        done += count;
+    }
+
+    handleBackgroundStream(sampleCount * 1000 / m_sampleRate);
+    m_liveSynthTailSamples -= std::min<uint64_t>(m_liveSynthTailSamples, sampleCount);
+}
+
+void MidiAudioSource::requestAllEventsWhenIdle(unsigned int sampleCount)
+{
+    //! NOTE Only the tracks that were played are frozen, not every track of every opened score
+    if (!m_wasPlayed || !m_allEventsRequestPending || !m_frozenTrackCache || !m_frozenTrackCache->isEnabled() || m_sampleRate == 0) {
+        return;
+    }
+
+    m_idleSamples += sampleCount;
+    if (m_idleSamples < static_cast<uint64_t>(FREEZE_REQUEST_DELAY_SECS) * m_sampleRate) {
+        return;
+    }
+
+    m_allEventsRequestPending = false;
+
+    AudioSanitizer::NonRealtimeScope nonRealtimeScope;
+    m_stream.allEventsRequest.notify();
+}
+
+void MidiAudioSource::onAllEventsReceived(Events&& events)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    if (!m_frozenTrackCache || !m_synth || events.empty()) {
+        return;
+    }
+
+    uint64_t key = FrozenTrackCache::makeKey(events, m_mapping, m_stream.controlEventsStream.val, m_params,
+                                             m_synth->soundFonts(), m_sampleRate);
+    if (m_frozenTrack && m_frozenTrack->key == key) {
+        return;
+    }
+
+    dropFrozenTrack();
+    m_freezeKey = key;
+
+    if (m_frozenTrackCache->track(key)) {
+        if (!isActive()) {
+            adoptFrozenTrack();
+        }
+        return;
+    }
+
+    //! NOTE The track is rendered by its own synth instance, the live one keeps serving this source
+    synth::ISynthesizerPtr renderSynth = m_params.isValid()
+                                         ? synthResolver()->resolveSynth(m_trackId, m_params)
+                                         : synthResolver()->resolveDefaultSynth(m_trackId);
+    if (!renderSynth) {
+        return;
+    }
+
+    renderSynth->setSampleRate(m_sampleRate);
+    renderSynth->setupMidiChannels(m_stream.controlEventsStream.val);
+
+    FrozenTrackCache::RenderRequest request;
+    request.trackId = m_trackId;
+    request.key = key;
+    request.synth = std::move(renderSynth);
+    request.events = std::move(events);
+    request.mapping = m_mapping;
+    request.sampleRate = m_sampleRate;
+
+    m_frozenTrackCache->requestRender(std::move(request));
+}
+
+void MidiAudioSource::adoptFrozenTrack()
+{
+    if (!m_frozenTrackCache || m_freezeKey == 0) {
+        return;
+    }
+
+    FrozenTrackPtr track = m_frozenTrackCache->track(m_freezeKey);
+    if (!track || track->sampleRate != m_sampleRate || !m_synth || track->audioChannelsCount != m_synth->audioChannelsCount()) {
+        return;
+    }
+
+    m_liveSynthBuffer.resize(LIVE_SYNTH_BLOCK_SIZE * track->audioChannelsCount, 0.f);
+    m_frozenTrack = std::move(track);
+}
+
+void MidiAudioSource::dropFrozenTrack()
+{
+    m_freezeKey = 0;
+
+    if (!m_frozenTrack) {
+        return;
+    }
+
+    m_frozenTrack = nullptr;
+
+    //! NOTE Continue with the live synth from the current position
+    if (isActive() && m_sampleRate > 0) {
+        seek(m_playbackPosition * 1000 / m_sampleRate);
+    }
 }
 
 bool MidiAudioSource::sendEvents(const std::vector<Event>& events)
@@ -272,6 +465,11 @@ bool MidiAudioSource::sendEvents(const std::vector<Event>& events)
 
 void MidiAudioSource::resolveSynth(const AudioInputParams& inputParams)
 {
+    m_params = inputParams;
+    dropFrozenTrack();
+    m_allEventsRequestPending = true;
+    m_idleSamples = 0;
+
     if (!inputParams.isValid()) {
         m_synth = synthResolver()->resolveDefaultSynth(m_trackId);
         m_synth->setSampleRate(m_sampleRate);
@@ -293,6 +491,7 @@ void MidiAudioSource::seek(const msecs_t newPositionMsecs)
 
     invalidateCaches(m_mainStreamEventsBuffer);
     m_mainStreamEventsBuffer.currentTick = tickFromMsec(newPositionMsecs);
+    m_playbackPosition = newPositionMsecs * m_sampleRate / 1000;
 
     requestNextEvents(MINIMAL_REQUIRED_LOOKAHEAD);
 }
@@ -35,6 +35,7 @@
 
 #include "isynthresolver.h"
 #include "audiotypes.h"
+#include "frozentrackcache.h"
 
 namespace mu::audio {
 class MidiAudioSource : public IAudioSource, public async::Asyncable
@@ -64,18 +65,29 @@ private:
         midi::tick_t currentTick = 0;
         midi::tick_t endTick = 0;
 
-        bool hasEventsForTick(const midi::tick_t tick) const
+        //! NOTE Calls f for the events up to the tick (inclusive) and moves the current tick there.
+        //! The popped events are released on the next push or reset, not here,
+        //! so that popping does not free memory in the audio processing
+        template<typename Func>
+        void popUntil(const midi::tick_t tick, Func f)
         {
-            return m_eventsMap.find(tick) != m_eventsMap.end();
-        }
+            auto end = m_eventsMap.upper_bound(tick);
+            for (auto it = firstPending(); it != end; ++it) {
+                f(it->second);
+            }
 
-        std::vector<midi::Event> pop()
-        {
-            return m_eventsMap.extract(currentTick).mapped();
+            currentTick = tick;
+            m_isCurrentTickPopped = true;
         }
 
         void push(midi::Events&& newEvents)
         {
+            m_eventsMap.erase(m_eventsMap.begin(), firstPending());
+
+            //! NOTE The popped events are gone now, so the events at the current tick are new ones
+            //! (a refill requested from the current tick after the buffer ran dry) and must be played
+            m_isCurrentTickPopped = false;
+
             for (auto& pair : newEvents) {
                 for (midi::Event& event : pair.second) {
                     std::vector<midi::Event>& eventsAtTick = m_eventsMap[pair.first];
@@ -86,18 +98,30 @@ private:
 
         bool isEmpty() const
         {
-            return m_eventsMap.empty();
+            return firstPending() == m_eventsMap.end();
         }
 
         void reset()
         {
             currentTick = 0;
             endTick = 0;
+            m_isCurrentTickPopped = false;
             m_eventsMap.clear();
         }
 
     private:
+        midi::Events::iterator firstPending()
+        {
+            return m_isCurrentTickPopped ? m_eventsMap.upper_bound(currentTick) : m_eventsMap.lower_bound(currentTick);
+        }
+
+        midi::Events::const_iterator firstPending() const
+        {
+            return m_isCurrentTickPopped ? m_eventsMap.upper_bound(currentTick) : m_eventsMap.lower_bound(currentTick);
+        }
+
         midi::Events m_eventsMap;
+        bool m_isCurrentTickPopped = false;
     };
 
     void handleNextMsecs(const msecs_t nextMsecsNumber);
@@ -118,6 +142,13 @@ private:
 
     void invalidateCaches(EventsBuffer& eventsBuffer);
 
+    // track freeze
+    void processFrozenTrack(float* buffer, unsigned int sampleCount);
+    void requestAllEventsWhenIdle(unsigned int sampleCount);
+    void onAllEventsReceived(midi::Events&& events);
+    void adoptFrozenTrack();
+    void dropFrozenTrack();
+
     bool m_hasActiveRequest = false;
 
     TrackId m_trackId = -1;
@@ -131,6 +162,16 @@ private:
     EventsBuffer m_backgroundStreamEventsBuffer;
 
     unsigned int m_sampleRate = 0;
+    uint64_t m_playbackPosition = 0; // samples
+
+    FrozenTrackCachePtr m_frozenTrackCache = nullptr;
+    FrozenTrackPtr m_frozenTrack = nullptr;
+    uint64_t m_freezeKey = 0;
+    bool m_allEventsRequestPending = true;
+    bool m_wasPlayed = false;
+    uint64_t m_idleSamples = 0;
+    uint64_t m_liveSynthTailSamples = 0;
+    std::vector<float> m_liveSynthBuffer;
 
     struct TempoItem {
         midi::tempo_t tempo = 500000;
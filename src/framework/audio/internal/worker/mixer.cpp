@@ -115,29 +115,36 @@ void Mixer::process(float* outBuffer, unsigned int samplesPerChannel)
 {
     ONLY_AUDIO_WORKER_THREAD;
 
-    for (IClockPtr clock : m_clocks) {
+    for (const IClockPtr& clock : m_clocks) {
         clock->forward((samplesPerChannel * 1000) / m_sampleRate);
     }
 
-    std::fill(outBuffer, outBuffer + samplesPerChannel * audioChannelsCount(), 0.f);
+    {
+        //! NOTE The notifications to the other threads allocate, so they are sent after the processing
+        AudioSanitizer::RealtimeScope realtimeScope;
 
-    if (m_writeCacheBuff.size() != samplesPerChannel * audioChannelsCount()) {
-        m_writeCacheBuff.resize(samplesPerChannel * audioChannelsCount(), 0.f);
-    }
+        std::fill(outBuffer, outBuffer + samplesPerChannel * audioChannelsCount(), 0.f);
 
-    for (auto& channel : m_mixerChannels) {
-        channel.second->process(m_writeCacheBuff.data(), samplesPerChannel);
-        mixOutput(outBuffer, m_writeCacheBuff.data(), samplesPerChannel);
-        std::fill(m_writeCacheBuff.begin(), m_writeCacheBuff.end(), 0.f);
-    }
+        if (m_writeCacheBuff.size() != samplesPerChannel * audioChannelsCount()) {
+            m_writeCacheBuff.resize(samplesPerChannel * audioChannelsCount(), 0.f);
+        }
 
-    // TODO add limiter
+        for (auto& channel : m_mixerChannels) {
+            channel.second->process(m_writeCacheBuff.data(), samplesPerChannel);
+            mixOutput(outBuffer, m_writeCacheBuff.data(), samplesPerChannel);
+            std::fill(m_writeCacheBuff.begin(), m_writeCacheBuff.end(), 0.f);
+        }
+
+        // TODO add limiter
 
-    for (IFxProcessorPtr& fxProcessor : m_globalFxProcessors) {
-        if (fxProcessor->active()) {
-            fxProcessor->process(outBuffer, samplesPerChannel);
+        for (IFxProcessorPtr& fxProcessor : m_globalFxProcessors) {
+            if (fxProcessor->active()) {
+                fxProcessor->process(outBuffer, samplesPerChannel);
+            }
         }
     }
+
+    notifyAboutAudioSignalChanges();
 }
 
 void Mixer::addClock(IClockPtr clock)
@@ -201,6 +208,10 @@ void Mixer::mixOutput(float* outBuffer, float* inBuffer, unsigned int samplesCou
         return;
     }
 
+    if (m_signalAmplitudesRms.size() != audioChannelsCount()) {
+        m_signalAmplitudesRms.resize(audioChannelsCount(), 0.f);
+    }
+
     for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount(); ++audioChNum) {
         float squaredSum = 0.f;
 
@@ -216,7 +227,18 @@ void Mixer::mixOutput(float* outBuffer, float* inBuffer, unsigned int samplesCou
             squaredSum += resultSample * resultSample;
         }
 
-        float rms = samplesRootMeanSquare(std::move(squaredSum), samplesCount);
+        m_signalAmplitudesRms[audioChNum] = samplesRootMeanSquare(std::move(squaredSum), samplesCount);
+    }
+}
+
+void Mixer::notifyAboutAudioSignalChanges()
+{
+    for (auto& channel : m_mixerChannels) {
+        channel.second->notifyAboutAudioSignalChanges();
+    }
+
+    for (audioch_t audioChNum = 0; audioChNum < m_signalAmplitudesRms.size(); ++audioChNum) {
+        float rms = m_signalAmplitudesRms[audioChNum];
         m_masterSignalAmplitudeRmsChanged.send(audioChNum, rms);
         m_masterVolumePressureDbfsChanged.send(audioChNum, dbFullScaleFromSample(rms));
     }
@@ -64,8 +64,10 @@ public:
 
 private:
     void mixOutput(float* outBuffer, float* inBuffer, unsigned int samplesCount);
+    void notifyAboutAudioSignalChanges();
 
     std::vector<float> m_writeCacheBuff;
+    std::vector<float> m_signalAmplitudesRms;
 
     AudioOutputParams m_masterParams;
     async::Channel<AudioOutputParams> m_masterOutputParamsChanged;
@@ -144,15 +144,19 @@ void MixerChannel::process(float* buffer, unsigned int sampleCount)
 
     m_audioSource->process(buffer, sampleCount);
 
-    for (IFxProcessorPtr fx : m_fxProcessors) {
+    for (const IFxProcessorPtr& fx : m_fxProcessors) {
         fx->process(buffer, sampleCount);
     }
 
     completeOutput(buffer, sampleCount);
 }
 
-void MixerChannel::completeOutput(float* buffer, unsigned int samplesCount) const
+void MixerChannel::completeOutput(float* buffer, unsigned int samplesCount)
 {
+    if (m_signalAmplitudesRms.size() != audioChannelsCount()) {
+        m_signalAmplitudesRms.resize(audioChannelsCount(), 0.f);
+    }
+
     for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount(); ++audioChNum) {
         float squaredSum = 0.f;
 
@@ -166,7 +170,20 @@ void MixerChannel::completeOutput(float* buffer, unsigned int samplesCount) cons
             squaredSum += buffer[idx] * buffer[idx];
         }
 
-        float rms = samplesRootMeanSquare(std::move(squaredSum), samplesCount);
+        m_signalAmplitudesRms[audioChNum] = samplesRootMeanSquare(std::move(squaredSum), samplesCount);
+    }
+}
+
+void MixerChannel::notifyAboutAudioSignalChanges()
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    if (m_params.muted) {
+        return;
+    }
+
+    for (audioch_t audioChNum = 0; audioChNum < m_signalAmplitudesRms.size(); ++audioChNum) {
+        float rms = m_signalAmplitudesRms[audioChNum];
 
         m_signalAmplitudeRmsChanged.send(audioChNum, rms);
         m_volumePressureDbfsChanged.send(audioChNum, dbFullScaleFromSample(rms));
@@ -53,9 +53,13 @@ public:
     async::Channel<unsigned int> audioChannelsCountChanged() const override;
     void process(float* buffer, unsigned int sampleCount) override;
 
+    //! NOTE Sends the signal values of the last processed block,
+    //! called by the mixer outside of the realtime processing
+    void notifyAboutAudioSignalChanges();
+
 private:
     void setOutputParams(const AudioOutputParams& params);
-    void completeOutput(float* buffer, unsigned int samplesCount) const;
+    void completeOutput(float* buffer, unsigned int samplesCount);
 
     TrackId m_trackId = -1;
     MixerChannelId m_id = -1;
@@ -65,6 +69,7 @@ private:
 
     IAudioSourcePtr m_audioSource = nullptr;
     std::vector<IFxProcessorPtr> m_fxProcessors = {};
+    std::vector<float> m_signalAmplitudesRms;
 
     mutable async::Channel<audioch_t, float> m_signalAmplitudeRmsChanged;
     mutable async::Channel<audioch_t, volume_dbfs_t> m_volumePressureDbfsChanged;
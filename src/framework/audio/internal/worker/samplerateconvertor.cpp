@@ -20,74 +20,280 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "samplerateconvertor.h"
-#include "log.h"
+
 #include <cmath>
+#include <numeric>
+#include <algorithm>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "log.h"
 
 using namespace mu::audio;
 
+struct QualityPreset {
+    unsigned int taps;      //!< per phase, multiple of 8
+    double kaiserBeta;
+    double cutoff;          //!< relative to the lower of the two Nyquist frequencies
+};
+
+static QualityPreset qualityPreset(SampleRateConvertor::Quality quality)
+{
+    switch (quality) {
+    case SampleRateConvertor::Quality::Low: return { 16, 5.7, 0.80 };
+    case SampleRateConvertor::Quality::Medium: return { 32, 8.6, 0.86 };
+    case SampleRateConvertor::Quality::High: return { 64, 11.5, 0.91 };
+    }
+    return { 32, 8.6, 0.86 };
+}
+
+//! NOTE The length is always a multiple of 8
+static inline float dotProduct(const float* x, const float* h, unsigned int length)
+{
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    unsigned int i = 0;
+    for (; i + 16 <= length; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(h + i + 8), acc1);
+    }
+    if (i < length) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), acc0);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (unsigned int i = 0; i < length; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(h + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#elif defined(__ARM_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+    for (unsigned int i = 0; i < length; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(x + i), vld1q_f32(h + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(x + i + 4), vld1q_f32(h + i + 4));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+    float sum[4] = { 0.f, 0.f, 0.f, 0.f };
+    for (unsigned int i = 0; i < length; i += 4) {
+        sum[0] += x[i] * h[i];
+        sum[1] += x[i + 1] * h[i + 1];
+        sum[2] += x[i + 2] * h[i + 2];
+        sum[3] += x[i + 3] * h[i + 3];
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+#endif
+}
+
+//! modified Bessel function of the first kind, order 0
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+
+    return sum;
+}
+
 SampleRateConvertor::SampleRateConvertor(const std::vector<float>& data,
                                          unsigned int channelsCount,
                                          unsigned int sampleRateIn,
-                                         unsigned int sampleRateOut)
-    : m_data(data), m_fir(), m_channelsCount(channelsCount), m_sampleRateIn(sampleRateIn), m_sampleRateOut(sampleRateOut)
+                                         unsigned int sampleRateOut,
+                                         Quality quality)
+    : m_data(&data), m_channelsCount(channelsCount), m_sampleRateIn(sampleRateIn), m_sampleRateOut(sampleRateOut),
+    m_quality(quality)
 {
-    m_fir.resize(FIR_LENGTH, 0);
-    m_y.resize(FIR_LENGTH, 0);
-    initWindow();
+    initFilterBank();
+}
+
+SampleRateConvertor::SampleRateConvertor(unsigned int channelsCount, unsigned int sampleRateIn, unsigned int sampleRateOut,
+                                         Quality quality)
+    : m_channelsCount(channelsCount), m_sampleRateIn(sampleRateIn), m_sampleRateOut(sampleRateOut), m_quality(quality)
+{
+    initFilterBank();
 }
 
 std::vector<float> SampleRateConvertor::convert()
 {
     std::vector<float> out;
-    auto resultSamples = m_data.size() * m_sampleRateOut / (m_channelsCount * m_sampleRateIn);
+    if (!m_data || m_channelsCount == 0) {
+        return out;
+    }
+
+    updatePlanarData();
+
+    size_t inputFrames = m_data->size() / m_channelsCount;
+    size_t resultSamples = static_cast<size_t>(static_cast<unsigned long long>(inputFrames) * m_sampleRateOut / m_sampleRateIn);
 
     out.resize(resultSamples * m_channelsCount);
-    for (unsigned sample = 0; sample < resultSamples; ++sample) {
-        for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
-            out[sample * m_channelsCount + channel] = y(sample, channel);
-        }
-    }
+    convert(out.data(), 0, static_cast<unsigned int>(resultSamples));
 
     return out;
 }
 
 unsigned int SampleRateConvertor::convert(float* buffer, unsigned int from, unsigned int count)
 {
-    unsigned int sample = from;
+    if (!m_data || m_channelsCount == 0) {
+        return 0;
+    }
+
+    updatePlanarData();
+
+    const unsigned int halfTaps = m_taps / 2;
+    unsigned long long position = static_cast<unsigned long long>(from) * m_M;
+
     unsigned int converted = 0;
+    for (; converted < count; ++converted, position += m_M) {
+        if (!availableSamples(from + converted)) {
+            break;
+        }
+
+        size_t base = static_cast<size_t>(position / m_L);
+        unsigned int phase = static_cast<unsigned int>(position % m_L);
 
-    for (converted = 0; converted < count; ++converted, ++sample) {
+        //! NOTE The planar data is padded by m_taps zeros
+        size_t windowStart = base + m_taps - halfTaps + 1;
         for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
-            if (!availableSamples(sample)) {
-                return converted;
-            }
-            buffer[converted * m_channelsCount + channel] = y(sample, channel);
+            buffer[converted * m_channelsCount + channel] = y(m_planarData[channel].data() + windowStart, phase);
         }
     }
+
     return converted;
 }
 
-float SampleRateConvertor::y(unsigned int sample, unsigned int channel) const
+size_t SampleRateConvertor::process(const float* input, size_t inputFrames, float* output, size_t outputCapacity)
 {
-    switch (m_method) {
-    case SINC:
-        return ySinc(sample, channel);
-    case FIR:
-        return yFIR(sample, channel);
+    if (m_channelsCount == 0) {
+        return 0;
+    }
+
+    const unsigned int halfTaps = m_taps / 2;
+
+    if (m_history.size() != m_channelsCount) {
+        reset();
+    }
+
+    //! NOTE The history starts with m_taps zeros before the first input frame
+    for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
+        std::vector<float>& history = m_history[channel];
+        size_t size = history.size();
+        history.resize(size + inputFrames);
+        for (size_t frame = 0; frame < inputFrames; ++frame) {
+            history[size + frame] = input[frame * m_channelsCount + channel];
+        }
     }
-    return 0.f;
+
+    const size_t historyFrames = m_history.front().size();
+
+    size_t produced = 0;
+    while (produced < outputCapacity) {
+        //! NOTE History index of the frame m_streamBase is m_streamBase + m_taps - m_streamDropped
+        size_t windowStart = m_streamBase + m_taps - halfTaps + 1 - m_streamDropped;
+        if (windowStart + m_taps > historyFrames) {
+            break;
+        }
+
+        unsigned int phase = static_cast<unsigned int>(m_streamPhase);
+        for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
+            output[produced * m_channelsCount + channel] = y(m_history[channel].data() + windowStart, phase);
+        }
+        ++produced;
+
+        m_streamPhase += m_M;
+        m_streamBase += static_cast<size_t>(m_streamPhase / m_L);
+        m_streamPhase %= m_L;
+    }
+
+    //! NOTE Drop the frames before the next window
+    size_t nextWindowStart = m_streamBase + m_taps - halfTaps + 1 - m_streamDropped;
+    size_t drop = std::min(nextWindowStart, historyFrames);
+    if (drop > 0) {
+        for (std::vector<float>& history : m_history) {
+            history.erase(history.begin(), history.begin() + drop);
+        }
+        m_streamDropped += drop;
+    }
+
+    return produced;
+}
+
+size_t SampleRateConvertor::maxOutputFrames(size_t inputFrames) const
+{
+    return static_cast<size_t>(static_cast<unsigned long long>(inputFrames) * m_L / m_M) + 1;
+}
+
+size_t SampleRateConvertor::latency() const
+{
+    return m_taps / 2;
+}
+
+void SampleRateConvertor::reset()
+{
+    m_history.assign(m_channelsCount, std::vector<float>(m_taps, 0.f));
+    m_streamBase = 0;
+    m_streamPhase = 0;
+    m_streamDropped = 0;
+}
+
+float SampleRateConvertor::y(const float* window, unsigned int phase) const
+{
+    if (m_phases == m_L) {
+        return dotProduct(window, m_filterBank.data() + static_cast<size_t>(phase) * m_taps, m_taps);
+    }
+
+    //! NOTE Too many phases for the ratio, interpolate between the two nearest
+    double position = static_cast<double>(phase) * m_phases / m_L;
+    unsigned int phase0 = static_cast<unsigned int>(position);
+    float weight = static_cast<float>(position - phase0);
+
+    float y0 = dotProduct(window, m_filterBank.data() + static_cast<size_t>(phase0) * m_taps, m_taps);
+    float y1 = dotProduct(window, m_filterBank.data() + static_cast<size_t>(phase0 + 1) * m_taps, m_taps);
+
+    return y0 + (y1 - y0) * weight;
 }
 
 void SampleRateConvertor::setChannelCount(unsigned int count)
 {
-    m_channelsCount = count;
+    if (m_channelsCount != count) {
+        m_channelsCount = count;
+        m_planarSource = nullptr;
+        reset();
+    }
 }
 
 void SampleRateConvertor::setSampleRateIn(unsigned int sampleRate)
 {
     if (m_sampleRateIn != sampleRate) {
         m_sampleRateIn = sampleRate;
-        initWindow();
+        initFilterBank();
     }
 }
 
@@ -95,116 +301,104 @@ void SampleRateConvertor::setSampleRateOut(unsigned int sampleRate)
 {
     if (m_sampleRateOut != sampleRate) {
         m_sampleRateOut = sampleRate;
-        initWindow();
+        initFilterBank();
     }
 }
 
-float SampleRateConvertor::ySinc(unsigned int sample, unsigned int channel) const
+void SampleRateConvertor::setQuality(Quality quality)
 {
-    double currentOutputSampleTime = sample / static_cast<double>(m_sampleRateOut);
-    auto zeroInputSample = std::floor(currentOutputSampleTime * m_sampleRateIn);
-
-    float out = 0.f;
-    for (unsigned int i = 0; i < USE_SAMPLES; ++i) {
-        int currentSample = zeroInputSample + i - USE_SAMPLES / 2;
-        double currentInputSampleTime = currentSample / static_cast<double>(m_sampleRateIn);
-
-        if (currentSample < 0 || currentSample * m_channelsCount + channel >= m_data.size()) {
-            continue;
-        }
-        out += m_data.at(currentSample * m_channelsCount + channel) * sinc(currentOutputSampleTime - currentInputSampleTime);
+    if (m_quality != quality) {
+        m_quality = quality;
+        initFilterBank();
     }
-    return out;
 }
 
-float SampleRateConvertor::yFIR(unsigned int sample, unsigned int channel) const
+SampleRateConvertor::Quality SampleRateConvertor::quality() const
 {
-    auto x = [this, &channel](int m) -> float {
-        int pos = m * m_M / m_L * m_channelsCount + channel;
-        if (pos >= 0 && pos < static_cast<int>(m_data.size())) {
-            return m_data.at(pos);
-        }
-        return 0.f;
-    };
-
-    float y = 0.f;
-    for (unsigned int i = 0; i < FIR_LENGTH; ++i) {
-        int t = sample - static_cast<int>(i);
-        y += x(t) * m_fir[i];
-    }
-    return y;
+    return m_quality;
 }
 
 bool SampleRateConvertor::availableSamples(unsigned int sample) const
 {
-    float currentOutputSampleTime = sample / static_cast<float>(m_sampleRateOut);
-    auto firstInputSample = std::floor(currentOutputSampleTime * m_sampleRateIn) - USE_SAMPLES / 2;
+    size_t inputFrames = m_data->size() / m_channelsCount;
+    unsigned long long base = static_cast<unsigned long long>(sample) * m_M / m_L;
 
-    // first sample for convertion points out of the input buffer
-    if (firstInputSample * m_channelsCount >= m_data.size()) {
-        return false;
-    }
-    return true;
+    return base < inputFrames;
 }
 
-inline double zeroBessel(double x)
+void SampleRateConvertor::updatePlanarData()
 {
-    //return std::cyl_bessel_i(0, x);
+    if (m_planarSource == m_data->data() && m_planarSourceSize == m_data->size() && m_planarData.size() == m_channelsCount) {
+        return;
+    }
 
-    double s = 1, y = 1;
-    int m = 1;
+    size_t inputFrames = m_data->size() / m_channelsCount;
 
-    while (y > std::numeric_limits<float>::min()) {
-        m += 2;
-        y *= x * x / (4 * m * m);
-        s += s * y;
+    m_planarData.resize(m_channelsCount);
+    for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
+        std::vector<float>& planar = m_planarData[channel];
+        planar.assign(inputFrames + 2 * m_taps, 0.f);
+        for (size_t frame = 0; frame < inputFrames; ++frame) {
+            planar[m_taps + frame] = (*m_data)[frame * m_channelsCount + channel];
+        }
     }
 
-    return s;
+    m_planarSource = m_data->data();
+    m_planarSourceSize = m_data->size();
 }
 
-void SampleRateConvertor::initWindow()
+void SampleRateConvertor::initFilterBank()
 {
-    int max = std::max(m_sampleRateIn, m_sampleRateOut), min = std::min(m_sampleRateIn, m_sampleRateOut);
-    int maxCommonDivider = 1;
-    while (max % min != 0) {
-        maxCommonDivider = max % min;
-        max = min;
-        min = maxCommonDivider;
+    IF_ASSERT_FAILED(m_sampleRateIn > 0 && m_sampleRateOut > 0) {
+        return;
     }
-    m_M = m_sampleRateIn / maxCommonDivider;
-    m_L = m_sampleRateOut / maxCommonDivider;
-    double fStop = std::min(m_sampleRateIn, m_sampleRateOut) / 2,
-           fIntermediateSampleRate = m_sampleRateIn * m_M,
-           attenuation = 96 /*dB*/;
-    int M = FIR_LENGTH;
-    int Np = (M - 1) / 2;
 
-    double alpha = 0.1102 * (attenuation - 8.7);
-    double A[FIR_LENGTH];
+    unsigned int gcd = std::gcd(m_sampleRateIn, m_sampleRateOut);
+    m_M = m_sampleRateIn / gcd;
+    m_L = m_sampleRateOut / gcd;
+    m_phases = std::min(m_L, MAX_PHASES);
 
-    A[0] = 2 * fStop / fIntermediateSampleRate;
-    for (int j = 1; j <= Np; j++) {
-        A[j]  = std::sin(2 * j * M_PI * fStop / fIntermediateSampleRate) / j * M_PI;
-    }
+    QualityPreset preset = qualityPreset(m_quality);
+    bool tapsChanged = m_taps != preset.taps;
+    m_taps = preset.taps;
 
-    for (int j = 0; j <= Np; j++) {
-        m_fir[Np + j]  = A[j];
-        m_fir[Np + j] *= zeroBessel(alpha * std::sqrt(1 - (j * j / (Np * Np))));
-        m_fir[Np + j] /= zeroBessel(alpha);
-    }
+    //! NOTE Windowed sinc, in input samples: the phase p is the filter for the output at p / m_phases after an input sample
+    const double cutoff = preset.cutoff * std::min(m_sampleRateIn, m_sampleRateOut) / m_sampleRateIn;
+    const double halfLength = m_taps / 2.0;
+    const double windowNorm = besselI0(preset.kaiserBeta);
+
+    m_filterBank.assign(static_cast<size_t>(m_phases + 1) * m_taps, 0.f);
+    for (unsigned int p = 0; p <= m_phases; ++p) {
+        float* filter = m_filterBank.data() + static_cast<size_t>(p) * m_taps;
+        double fraction = static_cast<double>(p) / m_phases;
+        double sum = 0.0;
+
+        for (unsigned int j = 0; j < m_taps; ++j) {
+            double u = fraction + halfLength - 1.0 - j;
+            double r = u / halfLength;
+            if (std::abs(r) >= 1.0) {
+                continue;
+            }
+
+            double x = M_PI * cutoff * u;
+            double sinc = x == 0.0 ? 1.0 : std::sin(x) / x;
+            double window = besselI0(preset.kaiserBeta * std::sqrt(1.0 - r * r)) / windowNorm;
 
-    for (int j = 0; j < Np; j++) {
-        m_fir[j] = m_fir[M - 1 - j];
+            double value = cutoff * sinc * window;
+            filter[j] = static_cast<float>(value);
+            sum += value;
+        }
+
+        //! NOTE Unity gain at DC for each phase
+        if (sum != 0.0) {
+            for (unsigned int j = 0; j < m_taps; ++j) {
+                filter[j] = static_cast<float>(filter[j] / sum);
+            }
+        }
     }
-}
 
-double SampleRateConvertor::sinc(double value) const
-{
-    if (value == 0) {
-        return 1.f;
+    if (tapsChanged) {
+        m_planarSource = nullptr;
+        reset();
     }
-    double sincArg = M_PI * value * m_sampleRateIn;
-    double gain = std::min(1.0, m_sampleRateOut / static_cast<double>(m_sampleRateIn));
-    return gain * std::sin(sincArg) / sincArg;
 }
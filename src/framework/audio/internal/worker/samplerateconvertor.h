@@ -23,56 +23,87 @@
 #define MU_AUDIO_SAMPLERATECONVERTOR_H
 
 #include <vector>
-#include <deque>
+#include <cstddef>
+
 namespace mu::audio {
+//! NOTE Polyphase windowed-sinc resampler.
+//! The filter is designed once for the rational ratio of the rates (L/M) and stored as a bank of L phase filters,
+//! each output sample is a single inner product of a contiguous window of one channel with one phase filter
 class SampleRateConvertor
 {
 public:
-    enum Method {
-        SINC, FIR
+    enum class Quality {
+        Low,        //!< 16 taps per phase, about 55 dB stopband attenuation
+        Medium,     //!< 32 taps per phase, about 80 dB
+        High        //!< 64 taps per phase, about 120 dB
     };
+
+    //! convert the data (interleaved), which can be changed and reloaded between the calls
     explicit SampleRateConvertor(const std::vector<float>& data, unsigned int channelsCount, unsigned int sampleRateIn,
-                                 unsigned int sampleRateOut);
+                                 unsigned int sampleRateOut, Quality quality = Quality::Medium);
+
+    //! convert a stream of blocks, see process()
+    explicit SampleRateConvertor(unsigned int channelsCount, unsigned int sampleRateIn, unsigned int sampleRateOut,
+                                 Quality quality = Quality::Medium);
 
     //! offline convert full data set
     std::vector<float> convert();
 
-    //! online convert
+    //! online convert, from is the position in the output samples
     unsigned int convert(float* buffer, unsigned int from, unsigned int count);
 
+    //! streaming convert: takes all the input frames and writes the output frames which are ready,
+    //! returns the count of the written frames (not more than maxOutputFrames(inputFrames)).
+    //! The output is delayed by latency() input frames
+    size_t process(const float* input, size_t inputFrames, float* output, size_t outputCapacity);
+    size_t maxOutputFrames(size_t inputFrames) const;
+    size_t latency() const;
+    void reset();
+
     void setChannelCount(unsigned int count);
     void setSampleRateIn(unsigned int sampleRate);
     void setSampleRateOut(unsigned int sampleRate);
+    void setQuality(Quality quality);
 
-private:
-
-    //! return value of sinc function (LPF) with considaration of used sampleRates
-    double sinc(double value) const;
+    Quality quality() const;
 
-    //! output sample value
-    float y(unsigned int sample, unsigned int channel) const;
-    float ySinc(unsigned int sample, unsigned int channel) const;
-    float yFIR(unsigned int sample, unsigned int channel) const;
+private:
+    //! output sample of one channel, the window starts m_taps / 2 - 1 frames before the input position
+    float y(const float* window, unsigned int phase) const;
 
     //! return true if there are samples in input buffer for convertion
     bool availableSamples(unsigned int sample) const;
 
-    //! calculate window function values
-    void initWindow();
+    //! calculate the phase filters
+    void initFilterBank();
+
+    //! copy the data to the planar channels, zero padded at both sides
+    void updatePlanarData();
+
+    //! the phases count is limited for the ratios of big primes, the phases in between are interpolated
+    static constexpr unsigned int MAX_PHASES = 2048;
+
+    const std::vector<float>* m_data = nullptr;
+    const float* m_planarSource = nullptr;
+    size_t m_planarSourceSize = 0;
+    std::vector<std::vector<float> > m_planarData;
 
-    const static unsigned int USE_SAMPLES = 16; //!< this value defines the quality and complexity of SRC.
-    const std::vector<float>& m_data;
+    unsigned int m_L = 1; //!< interpolation factor
+    unsigned int m_M = 1; //!< decimation factor
+    unsigned int m_phases = 1;
+    unsigned int m_taps = 0; //!< per phase, multiple of 8
+    std::vector<float> m_filterBank; //!< m_phases + 1 filters of m_taps, the last one is the first one shifted by one input sample
 
-    //! values of window function for USE_SAMPLES
-    const static unsigned int FIR_LENGTH = 33;
-    unsigned int m_M = 1, m_L = 1;
-    std::vector<float> m_fir;
-    mutable std::deque<float> m_y;
+    // streaming state
+    std::vector<std::vector<float> > m_history;
+    size_t m_streamBase = 0; //!< input frame of the next output frame
+    unsigned long long m_streamPhase = 0;
+    size_t m_streamDropped = 0; //!< input frames removed from the history
 
-    unsigned int m_channelsCount;
-    unsigned int m_sampleRateIn;
-    unsigned int m_sampleRateOut;
-    Method m_method = FIR;
+    unsigned int m_channelsCount = 0;
+    unsigned int m_sampleRateIn = 0;
+    unsigned int m_sampleRateOut = 0;
+    Quality m_quality = Quality::Medium;
 };
 }
 
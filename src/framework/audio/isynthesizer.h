@@ -44,6 +44,7 @@ public:
     virtual Ret init() = 0;
     virtual Ret addSoundFonts(const std::vector<io::path>& sfonts) = 0;
     virtual Ret removeSoundFonts() = 0;
+    virtual std::vector<io::path> soundFonts() const = 0;
 
     virtual Ret setupMidiChannels(const std::vector<midi::Event>& events) = 0;
     virtual bool handleEvent(const midi::Event& e) = 0;
@@ -0,0 +1,260 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <fluidsynth.h>
+
+#include "internal/audiosanitizer.h"
+#include "internal/synthesizers/fluidsynth/fluidsoundfontcache.h"
+
+using namespace mu::audio;
+using namespace mu::audio::synth;
+
+static const char* SOUNDFONT_FILE = "stub.sf3";
+static constexpr int PARTS_COUNT = 60;
+
+namespace {
+//! NOTE Stands for the default fluid loader, counts the soundfonts it loads and frees
+struct StubLoader {
+    int loadsCount = 0;
+    int freesCount = 0;
+};
+
+struct StubSoundFont {
+    StubLoader* loader = nullptr;
+    fluid_sfont_t* sfont = nullptr;
+    fluid_preset_t* preset = nullptr;
+    bool iterated = false;
+};
+
+const char* stubSoundFontName(fluid_sfont_t*)
+{
+    return SOUNDFONT_FILE;
+}
+
+fluid_preset_t* stubSoundFontPreset(fluid_sfont_t* sfont, int bank, int program)
+{
+    StubSoundFont* soundFont = static_cast<StubSoundFont*>(fluid_sfont_get_data(sfont));
+    return bank == 0 && program == 0 ? soundFont->preset : nullptr;
+}
+
+void stubSoundFontIterationStart(fluid_sfont_t* sfont)
+{
+    static_cast<StubSoundFont*>(fluid_sfont_get_data(sfont))->iterated = false;
+}
+
+fluid_preset_t* stubSoundFontIterationNext(fluid_sfont_t* sfont)
+{
+    StubSoundFont* soundFont = static_cast<StubSoundFont*>(fluid_sfont_get_data(sfont));
+    if (soundFont->iterated) {
+        return nullptr;
+    }
+
+    soundFont->iterated = true;
+    return soundFont->preset;
+}
+
+int freeStubSoundFont(fluid_sfont_t* sfont)
+{
+    StubSoundFont* soundFont = static_cast<StubSoundFont*>(fluid_sfont_get_data(sfont));
+    soundFont->loader->freesCount++;
+
+    delete_fluid_preset(soundFont->preset);
+    delete_fluid_sfont(sfont);
+    delete soundFont;
+    return 0;
+}
+
+const char* stubPresetName(fluid_preset_t*)
+{
+    return "Piano";
+}
+
+int stubPresetBank(fluid_preset_t*)
+{
+    return 0;
+}
+
+int stubPresetNum(fluid_preset_t*)
+{
+    return 0;
+}
+
+int stubPresetNoteOn(fluid_preset_t*, fluid_synth_t*, int, int, int)
+{
+    return FLUID_OK;
+}
+
+fluid_sfont_t* loadStubSoundFont(fluid_sfloader_t* sfloader, const char*)
+{
+    StubLoader* loader = static_cast<StubLoader*>(fluid_sfloader_get_data(sfloader));
+    loader->loadsCount++;
+
+    StubSoundFont* soundFont = new StubSoundFont();
+    soundFont->loader = loader;
+    soundFont->sfont = new_fluid_sfont(stubSoundFontName, stubSoundFontPreset,
+                                       stubSoundFontIterationStart, stubSoundFontIterationNext,
+                                       freeStubSoundFont);
+    soundFont->preset = new_fluid_preset(soundFont->sfont, stubPresetName, stubPresetBank, stubPresetNum,
+                                         stubPresetNoteOn, delete_fluid_preset);
+    fluid_sfont_set_data(soundFont->sfont, soundFont);
+
+    return soundFont->sfont;
+}
+}
+
+class FluidSoundFontCacheTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        fluid_sfloader_t* loader = new_fluid_sfloader(loadStubSoundFont, delete_fluid_sfloader);
+        fluid_sfloader_set_data(loader, &m_loader);
+        m_cache = std::make_shared<FluidSoundFontCache>(loader);
+
+        m_settings = new_fluid_settings();
+        fluid_settings_setint(m_settings, "synth.threadsafe-api", 0);
+    }
+
+    void TearDown() override
+    {
+        for (fluid_synth_t* synth : m_synths) {
+            delete_fluid_synth(synth);
+        }
+
+        m_synths.clear();
+        m_cache = nullptr;
+
+        delete_fluid_settings(m_settings);
+    }
+
+    //! NOTE A synth per part, as the resolver creates them
+    void makeSynths(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            fluid_synth_t* synth = new_fluid_synth(m_settings);
+            m_cache->attachTo(synth);
+            m_synths.push_back(synth);
+        }
+    }
+
+    StubLoader m_loader;
+    FluidSoundFontCachePtr m_cache;
+    fluid_settings_t* m_settings = nullptr;
+    std::vector<fluid_synth_t*> m_synths;
+};
+
+TEST_F(FluidSoundFontCacheTests, PresetsAreShared)
+{
+    //! GIVEN The synths of a score with many parts
+    makeSynths(PARTS_COUNT);
+
+    //! WHEN Each of them loads the same soundfont
+    std::vector<int> ids;
+    for (fluid_synth_t* synth : m_synths) {
+        int id = fluid_synth_sfload(synth, SOUNDFONT_FILE, 0);
+        ASSERT_NE(id, FLUID_FAILED);
+        ids.push_back(id);
+    }
+
+    //! THEN The soundfont file is loaded only once
+    EXPECT_EQ(m_loader.loadsCount, 1);
+    EXPECT_EQ(m_cache->soundFontsCount(), size_t(1));
+
+    //! AND All the synths hand out the same preset
+    fluid_preset_t* firstPreset = fluid_sfont_get_preset(fluid_synth_get_sfont_by_id(m_synths.front(), ids.front()), 0, 0);
+    ASSERT_TRUE(firstPreset);
+
+    for (size_t i = 0; i < m_synths.size(); ++i) {
+        fluid_sfont_t* sfont = fluid_synth_get_sfont_by_id(m_synths[i], ids[i]);
+        ASSERT_TRUE(sfont);
+        EXPECT_EQ(fluid_sfont_get_preset(sfont, 0, 0), firstPreset);
+        EXPECT_STREQ(fluid_sfont_get_name(sfont), SOUNDFONT_FILE);
+    }
+
+    for (size_t i = 0; i < m_synths.size(); ++i) {
+        fluid_synth_sfunload(m_synths[i], ids[i], 0);
+    }
+}
+
+TEST_F(FluidSoundFontCacheTests, SharedSoundFontIsRefcounted)
+{
+    //! GIVEN The synths of a score with many parts, all with the shared soundfont
+    makeSynths(PARTS_COUNT);
+
+    std::vector<int> ids;
+    for (fluid_synth_t* synth : m_synths) {
+        ids.push_back(fluid_synth_sfload(synth, SOUNDFONT_FILE, 0));
+    }
+
+    //! WHEN All the synths but the last one unload it
+    for (size_t i = 0; i + 1 < m_synths.size(); ++i) {
+        EXPECT_EQ(fluid_synth_sfunload(m_synths[i], ids[i], 0), FLUID_OK);
+    }
+
+    //! THEN The soundfont is kept for the last synth
+    EXPECT_EQ(m_loader.freesCount, 0);
+    EXPECT_EQ(m_cache->soundFontsCount(), size_t(1));
+    EXPECT_TRUE(fluid_sfont_get_preset(fluid_synth_get_sfont_by_id(m_synths.back(), ids.back()), 0, 0));
+
+    //! WHEN A new synth loads it again
+    makeSynths(1);
+    int id = fluid_synth_sfload(m_synths.back(), SOUNDFONT_FILE, 0);
+    EXPECT_NE(id, FLUID_FAILED);
+
+    //! THEN It is not loaded from the file again
+    EXPECT_EQ(m_loader.loadsCount, 1);
+
+    //! WHEN The last users unload it
+    fluid_synth_sfunload(m_synths[m_synths.size() - 2], ids.back(), 0);
+    EXPECT_EQ(m_loader.freesCount, 0);
+
+    fluid_synth_sfunload(m_synths.back(), id, 0);
+
+    //! THEN It is freed
+    EXPECT_EQ(m_loader.freesCount, 1);
+    EXPECT_EQ(m_cache->soundFontsCount(), size_t(0));
+}
+
+TEST_F(FluidSoundFontCacheTests, DeletedSynthReleasesSoundFont)
+{
+    //! GIVEN Two synths with the shared soundfont
+    makeSynths(2);
+    for (fluid_synth_t* synth : m_synths) {
+        fluid_synth_sfload(synth, SOUNDFONT_FILE, 0);
+    }
+
+    //! WHEN The synths are deleted, as when the parts are removed
+    delete_fluid_synth(m_synths.front());
+    EXPECT_EQ(m_cache->soundFontsCount(), size_t(1));
+
+    delete_fluid_synth(m_synths.back());
+    m_synths.clear();
+
+    //! THEN The soundfont is freed with the last one
+    EXPECT_EQ(m_loader.freesCount, 1);
+    EXPECT_EQ(m_cache->soundFontsCount(), size_t(0));
+}
@@ -0,0 +1,195 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "modularity/ioc.h"
+#include "async/asyncable.h"
+#include "midi/imidioutport.h"
+
+#include "isynthresolver.h"
+#include "internal/audiosanitizer.h"
+#include "internal/worker/mixer.h"
+#include "internal/worker/midiaudiosource.h"
+#include "internal/synthesizers/fluidsynth/fluidsynth.h"
+
+using namespace mu;
+using namespace mu::audio;
+using namespace mu::midi;
+
+static const std::string TEST_MODULE = "audio_tests";
+
+static constexpr unsigned int SAMPLE_RATE = 48000;
+static constexpr samples_t BLOCK_SIZE = 1024;
+static constexpr audioch_t AUDIO_CHANNELS = 2;
+static constexpr tick_t MEASURE_TICKS = 480 * 4;
+static constexpr int MEASURES = 20;
+
+namespace {
+class SynthResolverStub : public synth::ISynthResolver
+{
+public:
+    synth::ISynthesizerPtr synth;
+
+    void init(const AudioInputParams&) override {}
+    synth::ISynthesizerPtr resolveSynth(const TrackId, const AudioInputParams&) const override { return synth; }
+    synth::ISynthesizerPtr resolveDefaultSynth(const TrackId) const override { return synth; }
+    AudioResourceIdList resolveAvailableResources(const AudioSourceType) const override { return {}; }
+    void registerResolver(const AudioSourceType, IResolverPtr) override {}
+};
+
+//! NOTE Not a gmock mock: the mock call bookkeeping would allocate inside the realtime scope
+class MidiOutPortStub : public IMidiOutPort
+{
+public:
+    int sentEventsCount = 0;
+
+    MidiDeviceList devices() const override { return {}; }
+    async::Notification devicesChanged() const override { return {}; }
+    Ret connect(const MidiDeviceID&) override { return make_ret(Ret::Code::Ok); }
+    void disconnect() override {}
+    bool isConnected() const override { return false; }
+    MidiDeviceID deviceID() const override { return {}; }
+
+    Ret sendEvent(const Event&) override
+    {
+        ++sentEventsCount;
+        return make_ret(Ret::Code::Ok);
+    }
+};
+}
+
+class RealtimeGuardTests : public ::testing::Test, public async::Asyncable
+{
+public:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_synth = std::make_shared<synth::FluidSynth>();
+        m_synth->init();
+        m_synth->setSampleRate(SAMPLE_RATE);
+
+        m_synthResolver = std::make_shared<SynthResolverStub>();
+        m_synthResolver->synth = m_synth;
+        modularity::ioc()->registerExport<synth::ISynthResolver>(TEST_MODULE, m_synthResolver);
+
+        m_midiOutPort = std::make_shared<MidiOutPortStub>();
+        modularity::ioc()->registerExport<IMidiOutPort>(TEST_MODULE, m_midiOutPort);
+    }
+
+    void TearDown() override
+    {
+        modularity::ioc()->unregisterExport<synth::ISynthResolver>();
+        modularity::ioc()->unregisterExport<IMidiOutPort>();
+    }
+
+    //! NOTE A quarter note on each beat
+    void makeScore()
+    {
+        m_midiData.mapping.tempo[0] = 500000;
+        m_midiData.mapping.programms.push_back(Program());
+        m_midiData.stream.lastTick = MEASURES * MEASURE_TICKS;
+
+        for (tick_t tick = 0; tick < m_midiData.stream.lastTick; tick += 480) {
+            Event noteOn(Event::Opcode::NoteOn);
+            noteOn.setNote(60);
+            noteOn.setVelocity(40000);
+            m_scoreEvents[tick].push_back(noteOn);
+
+            Event noteOff(Event::Opcode::NoteOff);
+            noteOff.setNote(60);
+            m_scoreEvents[tick + 240].push_back(noteOff);
+
+            m_scoreEventsCount += 2;
+        }
+
+        //! NOTE Answered between the audio blocks, as the main thread would do
+        m_midiData.stream.eventsRequest.onReceive(this, [this](tick_t from, tick_t to) {
+            m_pendingRequests.push_back({ from, to });
+        });
+    }
+
+    void answerPendingRequests()
+    {
+        for (const auto& request : m_pendingRequests) {
+            Events events;
+            auto end = m_scoreEvents.lower_bound(request.second);
+            for (auto it = m_scoreEvents.lower_bound(request.first); it != end; ++it) {
+                events.insert(*it);
+            }
+
+            m_midiData.stream.mainStream.send(events, request.second);
+        }
+
+        m_pendingRequests.clear();
+    }
+
+    std::shared_ptr<synth::FluidSynth> m_synth;
+    std::shared_ptr<SynthResolverStub> m_synthResolver;
+    std::shared_ptr<MidiOutPortStub> m_midiOutPort;
+
+    MidiData m_midiData;
+    Events m_scoreEvents;
+    int m_scoreEventsCount = 0;
+    std::vector<std::pair<tick_t, tick_t> > m_pendingRequests;
+};
+
+TEST_F(RealtimeGuardTests, PlayScoreOffline)
+{
+    //! GIVEN A score played through the mixer, a midi source and the fluid synth
+    makeScore();
+
+    auto mixer = std::make_shared<Mixer>();
+    mixer->setSampleRate(SAMPLE_RATE);
+    mixer->setAudioChannelsCount(AUDIO_CHANNELS);
+
+    auto source = std::make_shared<MidiAudioSource>(0, m_midiData, AudioInputParams(), async::Channel<AudioInputParams>());
+    mixer->addChannel(0, source, AudioOutputParams(), async::Channel<AudioOutputParams>());
+    source->setIsActive(true);
+
+    std::vector<float> buffer(BLOCK_SIZE * AUDIO_CHANNELS, 0.f);
+
+    //! NOTE The first block sets up the buffers
+    answerPendingRequests();
+    mixer->process(buffer.data(), BLOCK_SIZE);
+    AudioSanitizer::resetRealtimeViolations();
+
+    //! WHEN The whole score is played
+    const size_t scoreBlocks = (MEASURES * 2 + 1) * SAMPLE_RATE / BLOCK_SIZE;
+    for (size_t i = 0; i < scoreBlocks; ++i) {
+        answerPendingRequests();
+        mixer->process(buffer.data(), BLOCK_SIZE);
+    }
+
+    //! THEN All the events are played
+    EXPECT_EQ(m_midiOutPort->sentEventsCount, m_scoreEventsCount);
+
+    //! AND Nothing in the realtime processing allocated memory or locked a mutex
+    if (AudioSanitizer::isRealtimeGuardEnabled()) {
+        EXPECT_EQ(AudioSanitizer::realtimeViolationsCount(), size_t(0));
+    }
+
+    source->setIsActive(false);
+    m_midiData.stream.eventsRequest.resetOnReceive(this);
+}
@@ -0,0 +1,224 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "internal/worker/samplerateconvertor.h"
+
+using namespace mu::audio;
+
+using Quality = SampleRateConvertor::Quality;
+
+namespace {
+std::vector<float> sine(double frequency, unsigned int sampleRate, size_t frames, unsigned int channels)
+{
+    std::vector<float> data(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        float value = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequency * i / sampleRate));
+        for (unsigned int ch = 0; ch < channels; ++ch) {
+            data[i * channels + ch] = value;
+        }
+    }
+    return data;
+}
+
+std::vector<float> channel(const std::vector<float>& data, unsigned int channels, unsigned int ch)
+{
+    std::vector<float> result(data.size() / channels);
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = data[i * channels + ch];
+    }
+    return result;
+}
+
+//! THD+N in dB: the residual after the least squares fit of a sine of the known frequency, the edges are skipped
+double thdn(const std::vector<float>& signal, double frequency, unsigned int sampleRate, size_t skip)
+{
+    double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+    for (size_t i = skip; i < signal.size() - skip; ++i) {
+        double w = 2.0 * M_PI * frequency * i / sampleRate;
+        double s = std::sin(w);
+        double c = std::cos(w);
+        ss += s * s;
+        sc += s * c;
+        cc += c * c;
+        ys += signal[i] * s;
+        yc += signal[i] * c;
+    }
+
+    double det = ss * cc - sc * sc;
+    double a = (ys * cc - yc * sc) / det;
+    double b = (yc * ss - ys * sc) / det;
+
+    double signalEnergy = 0, noiseEnergy = 0;
+    for (size_t i = skip; i < signal.size() - skip; ++i) {
+        double w = 2.0 * M_PI * frequency * i / sampleRate;
+        double model = a * std::sin(w) + b * std::cos(w);
+        signalEnergy += model * model;
+        noiseEnergy += (signal[i] - model) * (signal[i] - model);
+    }
+
+    return 10.0 * std::log10(noiseEnergy / signalEnergy);
+}
+}
+
+class SampleRateConvertorTests : public ::testing::Test
+{
+};
+
+TEST_F(SampleRateConvertorTests, SineDistortion)
+{
+    struct Case {
+        unsigned int rateIn;
+        unsigned int rateOut;
+        double frequency;
+    };
+
+    const std::vector<Case> cases = {
+        { 44100, 48000, 1000 },
+        { 48000, 44100, 1000 },
+        { 44100, 48000, 15000 },
+        { 22050, 48000, 5000 },
+        { 44100, 44101, 1000 }, // interpolated phases
+    };
+
+    for (const Case& c : cases) {
+        std::vector<float> input = sine(c.frequency, c.rateIn, c.rateIn, 2);
+
+        SampleRateConvertor medium(input, 2, c.rateIn, c.rateOut, Quality::Medium);
+        std::vector<float> output = medium.convert();
+        EXPECT_EQ(output.size(), static_cast<size_t>(c.rateOut) * 2);
+        EXPECT_LT(thdn(channel(output, 2, 0), c.frequency, c.rateOut, 200), -90.0) << c.rateIn << " -> " << c.rateOut;
+        EXPECT_EQ(channel(output, 2, 0), channel(output, 2, 1));
+
+        SampleRateConvertor high(input, 2, c.rateIn, c.rateOut, Quality::High);
+        EXPECT_LT(thdn(channel(high.convert(), 2, 0), c.frequency, c.rateOut, 200), -120.0) << c.rateIn << " -> " << c.rateOut;
+    }
+}
+
+TEST_F(SampleRateConvertorTests, Aliasing)
+{
+    //! NOTE Above the output Nyquist frequency, must be filtered out instead of being folded back
+    const unsigned int rateIn = 48000;
+    const unsigned int rateOut = 44100;
+    std::vector<float> input = sine(23000, rateIn, rateIn, 1);
+
+    auto level = [](const std::vector<float>& output) {
+        double energy = 0;
+        for (size_t i = 200; i < output.size() - 200; ++i) {
+            energy += output[i] * output[i];
+        }
+        return 10.0 * std::log10(energy / (output.size() - 400) / 0.125);
+    };
+
+    SampleRateConvertor medium(input, 1, rateIn, rateOut, Quality::Medium);
+    EXPECT_LT(level(medium.convert()), -75.0);
+
+    SampleRateConvertor high(input, 1, rateIn, rateOut, Quality::High);
+    EXPECT_LT(level(high.convert()), -115.0);
+}
+
+TEST_F(SampleRateConvertorTests, StreamingBlocks)
+{
+    const unsigned int channels = 2;
+    const size_t frames = 100000;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    std::vector<float> input(frames * channels);
+    for (float& value : input) {
+        value = distribution(random);
+    }
+
+    SampleRateConvertor oneShot(channels, 44100, 48000);
+    std::vector<float> expected(oneShot.maxOutputFrames(frames) * channels);
+    expected.resize(oneShot.process(input.data(), frames, expected.data(), oneShot.maxOutputFrames(frames)) * channels);
+
+    //! NOTE The streaming output is the same as the offline one, it only waits for the window to be filled
+    SampleRateConvertor offline(input, channels, 44100, 48000);
+    std::vector<float> offlineOutput = offline.convert();
+    ASSERT_LE(expected.size(), offlineOutput.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), offlineOutput.begin()));
+
+    SampleRateConvertor blocks(channels, 44100, 48000);
+    std::vector<float> actual;
+    std::vector<float> block;
+    size_t position = 0;
+    while (position < frames) {
+        size_t count = std::min<size_t>(random() % 700, frames - position);
+        block.resize(blocks.maxOutputFrames(count) * channels);
+
+        size_t produced = blocks.process(input.data() + position * channels, count, block.data(), blocks.maxOutputFrames(count));
+        actual.insert(actual.end(), block.begin(), block.begin() + produced * channels);
+        position += count;
+    }
+
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(SampleRateConvertorTests, Benchmark)
+{
+    using Clock = std::chrono::steady_clock;
+
+    //! GIVEN Ten seconds of stereo audio at the usual soundfont rate
+    const unsigned int seconds = 10;
+    const size_t blockFrames = 512; // a usual driver buffer
+    std::vector<float> input = sine(1000, 44100, 44100 * seconds, 2);
+
+    for (Quality quality : { Quality::Low, Quality::Medium, Quality::High }) {
+        const std::string name = quality == Quality::Low ? "low" : quality == Quality::Medium ? "medium" : "high";
+
+        //! WHEN It is converted at once, as for the export
+        SampleRateConvertor offline(input, 2, 44100, 48000, quality);
+        Clock::time_point start = Clock::now();
+        std::vector<float> output = offline.convert();
+        std::chrono::duration<double> offlineTime = Clock::now() - start;
+
+        EXPECT_EQ(output.size(), 48000u * seconds * 2);
+
+        //! WHEN It is converted block by block, as on the audio thread
+        SampleRateConvertor streaming(2, 44100, 48000, quality);
+        std::vector<float> block(streaming.maxOutputFrames(blockFrames) * 2);
+        std::chrono::duration<double, std::micro> maxBlockTime(0);
+        start = Clock::now();
+        for (size_t position = 0; position + blockFrames <= input.size() / 2; position += blockFrames) {
+            Clock::time_point blockStart = Clock::now();
+            streaming.process(input.data() + position * 2, blockFrames, block.data(), streaming.maxOutputFrames(blockFrames));
+            maxBlockTime = std::max<std::chrono::duration<double, std::micro> >(maxBlockTime, Clock::now() - blockStart);
+        }
+        std::chrono::duration<double> streamingTime = Clock::now() - start;
+
+        //! THEN Both are faster than realtime, even in unoptimized builds
+        EXPECT_GT(seconds / offlineTime.count(), 1.0) << name;
+        EXPECT_GT(seconds / streamingTime.count(), 1.0) << name;
+
+        //! NOTE The realtime factors and the longest block go to the test report (--gtest_output=xml)
+        RecordProperty(name + "OfflineRealtimeFactor", static_cast<int>(seconds / offlineTime.count()));
+        RecordProperty(name + "StreamingRealtimeFactor", static_cast<int>(seconds / streamingTime.count()));
+        RecordProperty(name + "MaxBlockMicroseconds", static_cast<int>(std::ceil(maxBlockTime.count())));
+    }
+}
@@ -26,6 +26,8 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <functional>
+#include <mutex>
 #include <cassert>
 #include <iostream>
 #include "imoduleexport.h"
@@ -44,7 +46,7 @@ public:
             assert(c);
             return;
         }
-        registerService(module, I::interfaceId(), std::shared_ptr<IModuleExportInterface>(), c);
+        registerService(module, I::interfaceId(), std::shared_ptr<IModuleExportInterface>(), c, nullptr);
     }
 
     template<class I>
@@ -74,7 +76,21 @@ public:
             assert(p);
             return;
         }
-        registerService(module, I::interfaceId(), std::static_pointer_cast<IModuleExportInterface>(p), nullptr);
+        registerService(module, I::interfaceId(), std::static_pointer_cast<IModuleExportInterface>(p), nullptr, nullptr);
+    }
+
+    //! NOTE The service is created by the factory on the first resolve, not at registration.
+    //! Suits services that are expensive to create and not needed by every run (e.g. converter)
+    template<class I>
+    void registerExportLazy(const std::string& module, std::function<std::shared_ptr<I>()> factory)
+    {
+        if (!factory) {
+            assert(factory);
+            return;
+        }
+        registerService(module, I::interfaceId(), std::shared_ptr<IModuleExportInterface>(), nullptr, [factory]() {
+            return std::static_pointer_cast<IModuleExportInterface>(factory());
+        });
     }
 
     template<class I>
@@ -116,6 +132,8 @@ public:
 
 private:
 
+    using LazyFactory = std::function<std::shared_ptr<IModuleExportInterface>()>;
+
     ModulesIoC() = default;
 
     void unregisterService(const std::string& id)
@@ -126,7 +144,8 @@ private:
     void registerService(const std::string& module,
                          const std::string& id,
                          std::shared_ptr<IModuleExportInterface> p,
-                         IModuleExportCreator* c)
+                         IModuleExportCreator* c,
+                         LazyFactory factory)
     {
         auto foundIt = m_map.find(id);
         if (foundIt != m_map.end()) {
@@ -139,6 +158,7 @@ private:
         inj.sourceModule = module;
         inj.c = c;
         inj.p = p;
+        inj.factory = factory;
         m_map[id] = inj;
     }
 
@@ -151,6 +171,17 @@ private:
         }
 
         Service& inj = it->second;
+
+        //! NOTE Services are resolved from any thread; the lock is only taken for the lazy ones.
+        //! Recursive, because the factory may resolve other lazy services
+        if (inj.factory) {
+            std::lock_guard<std::recursive_mutex> lock(m_lazyMutex);
+            if (!inj.p) {
+                inj.p = inj.factory();
+            }
+            return inj.p;
+        }
+
         if (inj.p) {
             return inj.p;
         }
@@ -164,11 +195,13 @@ private:
 
     struct Service {
         IModuleExportCreator* c = nullptr;
+        LazyFactory factory;
         std::string sourceModule;
         std::shared_ptr<IModuleExportInterface> p;
     };
 
     std::map<std::string, Service > m_map;
+    std::recursive_mutex m_lazyMutex;
 };
 
 template<class T>
@@ -0,0 +1,151 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2022 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "async/asyncable.h"
+#include "async/channel.h"
+#include "async/processevents.h"
+
+using namespace mu;
+
+class AsyncTests : public ::testing::Test, public async::Asyncable
+{
+public:
+    struct Result {
+        bool inOrder = true;
+        int received = 0;
+        double seconds = 0.0;
+        double maxSendMicroseconds = 0.0; // the longest a sender was blocked, e.g. the audio thread
+    };
+
+    //! NOTE Sends `count` messages from each of `producers` threads to a consumer thread through a channel
+    Result sendFromThreads(int producers, int count)
+    {
+        async::Channel<int, int> channel;
+        Result result;
+
+        std::atomic<bool> subscribed = false;
+        std::atomic<bool> finished = false;
+        std::vector<int> lastValues(producers, -1);
+
+        std::thread consumer([&]() {
+            channel.onReceive(this, [&](int producer, int value) {
+                if (lastValues[producer] != value - 1) {
+                    result.inOrder = false;
+                }
+                lastValues[producer] = value;
+                ++result.received;
+            });
+            subscribed = true;
+
+            while (!finished || result.received < producers * count) {
+                async::processEvents();
+                std::this_thread::yield();
+            }
+
+            channel.resetOnReceive(this);
+        });
+
+        while (!subscribed) {
+            std::this_thread::yield();
+        }
+
+        std::vector<double> maxSendTimes(producers, 0.0);
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                for (int i = 0; i < count; ++i) {
+                    auto sendStart = std::chrono::steady_clock::now();
+                    channel.send(p, i);
+                    std::chrono::duration<double, std::micro> sendTime = std::chrono::steady_clock::now() - sendStart;
+                    maxSendTimes[p] = std::max(maxSendTimes[p], sendTime.count());
+                }
+            });
+        }
+
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        finished = true;
+        consumer.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.seconds = elapsed.count();
+        result.maxSendMicroseconds = *std::max_element(maxSendTimes.cbegin(), maxSendTimes.cend());
+
+        return result;
+    }
+};
+
+TEST_F(AsyncTests, QueuedInvoker_SingleProducer)
+{
+    //! GIVEN One thread sending to another
+
+    //! WHEN More messages are sent than fit into the queue without overflowing
+    Result result = sendFromThreads(1, 10000);
+
+    //! THEN All messages are received in the order they were sent
+    EXPECT_EQ(result.received, 10000);
+    EXPECT_TRUE(result.inOrder);
+}
+
+TEST_F(AsyncTests, QueuedInvoker_ManyProducers)
+{
+    //! GIVEN Several threads sending to one thread at the same time
+    const int producers = 4;
+    const int count = 50000;
+
+    //! WHEN The messages are sent
+    Result result = sendFromThreads(producers, count);
+
+    //! THEN All messages are received, and the messages of each sender keep their order
+    EXPECT_EQ(result.received, producers * count);
+    EXPECT_TRUE(result.inOrder);
+}
+
+TEST_F(AsyncTests, QueuedInvoker_Benchmark)
+{
+    //! GIVEN The audio thread and a few more threads sending to the main thread,
+    //! like the playback position, the meters and the parameter changes
+    const int producers = 3;
+    const int count = 200000;
+
+    //! WHEN The messages are sent as fast as possible
+    Result result = sendFromThreads(producers, count);
+
+    //! THEN All messages are received
+    EXPECT_EQ(result.received, producers * count);
+    EXPECT_TRUE(result.inOrder);
+
+    //! NOTE The throughput and the longest time a sender was blocked go to the test report (--gtest_output=xml)
+    RecordProperty("messagesPerSecond", static_cast<int>(result.received / result.seconds));
+    RecordProperty("maxSendMicroseconds", static_cast<int>(std::ceil(result.maxSendMicroseconds)));
+}
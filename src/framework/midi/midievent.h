@@ -133,6 +133,8 @@ struct Event {
         return 0;
     }
 
+    const std::array<uint32_t, 4>& rawData() const { return m_data; }
+
     bool operator ==(const Event& other) const { return m_data == other.m_data; }
     bool operator !=(const Event& other) const { return !operator==(other); }
     operator bool() const {
@@ -632,8 +634,18 @@ struct Event {
     std::list<Event> toMIDI10() const
     {
         std::list<Event> events;
+        forEachMIDI10([&events](const Event& e) {
+            events.push_back(e);
+        });
+        return events;
+    }
+
+    //!convert ChannelVoice from MIDI2.0 to MIDI1.0 without allocations, f is called for each MIDI1.0 event
+    template<typename Func>
+    void forEachMIDI10(Func f) const
+    {
         switch (messageType()) {
-        case MessageType::ChannelVoice10: events.push_back(*this);
+        case MessageType::ChannelVoice10: f(*this);
             break;
         case MessageType::ChannelVoice20: {
             auto basic10Event = Event(opcode(), MessageType::ChannelVoice10);
@@ -652,7 +664,7 @@ struct Event {
                     //4.2.2 velocity comment
                     e.setVelocity(1);
                 }
-                events.push_back(e);
+                f(e);
                 break;
             }
 
@@ -660,25 +672,25 @@ struct Event {
             case Opcode::ChannelPressure: {
                 auto e = basic10Event;
                 e.setData(scaleDown(data(), 32, 7));
-                events.push_back(e);
+                f(e);
                 break;
             }
 
             //D2.3
             case Opcode::AssignableController:
             case Opcode::RegisteredController: {
-                std::list<std::pair<uint8_t, uint8_t> > controlChanges = {
+                const std::pair<uint8_t, uint8_t> controlChanges[] = {
                     { (opcode() == Opcode::RegisteredController ? 101 : 99), bank() },
                     { (opcode() == Opcode::RegisteredController ? 100 : 98), index() },
                     { 6,  (data() & 0x7FFFFFFF) >> 24 },
                     { 38, (data() & 0x1FC0000) >> 18 }
                 };
-                for (auto& c : controlChanges) {
+                for (const auto& c : controlChanges) {
                     auto e = basic10Event;
                     e.setOpcode(Opcode::ControlChange);
                     e.setIndex(c.first);
                     e.setData(c.second);
-                    events.push_back(e);
+                    f(e);
                 }
                 break;
             }
@@ -690,21 +702,21 @@ struct Event {
                     e.setOpcode(Opcode::ControlChange);
                     e.setIndex(0);
                     e.setData((bank() & 0x7F00) >> 8);
-                    events.push_back(e);
+                    f(e);
                     e.setIndex(0);
                     e.setData(bank() & 0x7F);
-                    events.push_back(e);
+                    f(e);
                 }
                 auto e = basic10Event;
                 e.setProgram(program());
-                events.push_back(e);
+                f(e);
                 break;
             }
             //D2.5
             case Opcode::PitchBend: {
                 auto e = basic10Event;
                 e.setData(data());
-                events.push_back(e);
+                f(e);
                 break;
             }
             default: break;
@@ -713,7 +725,6 @@ struct Event {
         }
         default: break;
         }
-        return events;
     }
 
     //!convert ChannelVoice from MIDI1.0 to MIDI2.0
@@ -32,6 +32,7 @@
 #include <set>
 #include <cassert>
 #include "async/channel.h"
+#include "async/notification.h"
 #include "retval.h"
 #include "midievent.h"
 
@@ -84,6 +85,11 @@ struct MidiStream {
     async::Channel<Events, tick_t /*endTick*/> backgroundStream;
     async::Channel<tick_t /*from*/, tick_t /*from*/> eventsRequest;
 
+    //! NOTE Used to render the whole track ahead of playback (track freeze)
+    async::Notification eventsChanged;
+    async::Notification allEventsRequest;
+    async::Channel<Events> allEventsStream;
+
     bool operator==(const MidiStream& other) const
     {
         return lastTick == other.lastTick
@@ -91,6 +91,11 @@ Ret VstSynthesiser::removeSoundFonts()
     return Ret(Ret::Code::NotSupported);
 }
 
+std::vector<io::path> VstSynthesiser::soundFonts() const
+{
+    return {};
+}
+
 bool VstSynthesiser::handleEvent(const midi::Event& e)
 {
     if (!m_vstAudioClient) {
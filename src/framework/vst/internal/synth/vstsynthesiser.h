@@ -57,6 +57,7 @@ public:
     audio::synth::SoundFontFormats soundFontFormats() const override;
     Ret addSoundFonts(const std::vector<io::path>& sfonts) override;
     Ret removeSoundFonts() override;
+    std::vector<io::path> soundFonts() const override;
 
     bool handleEvent(const midi::Event& e) override;
     void writeBuf(float* stream, unsigned int samples) override;
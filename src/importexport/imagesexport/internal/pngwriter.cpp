@@ -94,10 +94,7 @@ mu::Ret PngWriter::write(INotationPtr notation, Device& destinationDevice, const
         painter.translate(-pageRect.topLeft());
     }
 
-    QList<Ms::Element*> elements = page->elements();
-    std::stable_sort(elements.begin(), elements.end(), Ms::elementLessThan);
-
-    engraving::Paint::paintElements(painter, elements);
+    engraving::Paint::paintSortedElements(painter, page->paintItems());
     image.save(&destinationDevice, "png");
 
     score->setPrinting(false);
@@ -165,12 +165,9 @@ mu::Ret SvgWriter::write(INotationPtr notation, Device& destinationDevice, const
     }
 
     // 2nd pass: the rest of the elements
-    QList<Ms::Element*> elements = page->elements();
-    std::stable_sort(elements.begin(), elements.end(), Ms::elementLessThan);
-
     int lastNoteIndex = -1;
     for (int i = 0; i < PAGE_NUMBER; ++i) {
-        for (const Ms::Element* element: pages[i]->elements()) {
+        for (const Ms::Element* element: pages[i]->paintItems()) {
             if (element->type() == Ms::ElementType::NOTE) {
                 lastNoteIndex++;
             }
@@ -179,7 +176,7 @@ mu::Ret SvgWriter::write(INotationPtr notation, Device& destinationDevice, const
 
     NotesColors notesColors = parseNotesColors(options.value(OptionKey::NOTES_COLORS, Val()).toQVariant());
 
-    for (const Ms::Element* element : elements) {
+    for (const Ms::Element* element : page->paintItems()) {
         // Always exclude invisible elements
         if (!element->visible()) {
             continue;
@@ -21,6 +21,7 @@
  */
 
 #include <QMessageBox>
+#include <QElapsedTimer>
 
 #include "engraving/compat/midi/midifile.h"
 #include "engraving/style/style.h"
@@ -230,23 +231,31 @@ void quantizeAllTracks(std::multimap<int, MTrack>& tracks,
 {
     auto& opers = midiImportOperations;
 
-    for (auto& track: tracks) {
-        MTrack& mtrack = track.second;
+    // operations are shared between tracks, so set them up
+    // before the tracks are processed in parallel
+    if (opers.data()->processingsOfOpenedFile == 0) {
+        for (const auto& track: tracks) {
+            const MTrack& mtrack = track.second;
+            if (mtrack.chords.empty()) {
+                continue;
+            }
+            opers.data()->trackOpers.isDrumTrack.setValue(
+                mtrack.indexOfOperation, mtrack.mtrack->drumTrack());
+            if (mtrack.mtrack->drumTrack()) {
+                opers.data()->trackOpers.maxVoiceCount.setValue(
+                    mtrack.indexOfOperation, MidiOperations::VoiceCount::V_1);
+            }
+        }
+    }
+
+    MidiTracks::forEachTrackInParallel(tracks, [&](MTrack& mtrack) {
         if (mtrack.chords.empty()) {
-            continue;
+            return;
         }
         // pass current track index through MidiImportOperations
         // for further usage
         MidiOperations::CurrentTrackSetter setCurrentTrack{ opers, mtrack.indexOfOperation };
 
-        if (opers.data()->processingsOfOpenedFile == 0) {
-            opers.data()->trackOpers.isDrumTrack.setValue(
-                opers.currentTrack(), mtrack.mtrack->drumTrack());
-            if (mtrack.mtrack->drumTrack()) {
-                opers.data()->trackOpers.maxVoiceCount.setValue(
-                    opers.currentTrack(), MidiOperations::VoiceCount::V_1);
-            }
-        }
         const auto basicQuant = Quantize::quantValueToFraction(
             opers.data()->trackOpers.quantValue.value(mtrack.indexOfOperation));
 #ifdef QT_DEBUG
@@ -261,7 +270,7 @@ void quantizeAllTracks(std::multimap<int, MTrack>& tracks,
             MidiTuplet::findAllTuplets(mtrack.tuplets, mtrack.chords, sigmap, basicQuant);
         }
 #ifdef QT_DEBUG
-        Q_ASSERT_X(!doNotesOverlap(track.second),
+        Q_ASSERT_X(!doNotesOverlap(mtrack),
                    "quantizeAllTracks",
                    "There are overlapping notes of the same voice that is incorrect");
 #endif
@@ -275,7 +284,7 @@ void quantizeAllTracks(std::multimap<int, MTrack>& tracks,
                    "quantizeAllTracks", "Tuplet chord/note is outside tuplet "
                                         "or non-tuplet chord/note is inside tuplet");
 #endif
-    }
+    });
 }
 
 //---------------------------------------------------------
@@ -1110,10 +1119,19 @@ ReducedFraction findLastChordTick(const std::multimap<int, MTrack>& tracks)
 QList<MTrack> convertMidi(Score* score, const MidiFile* mf)
 {
     auto* sigmap = score->sigmap();
+    auto& opers = midiImportOperations;
+
+    auto& stageTimings = opers.data()->stageTimings;
+    stageTimings.clear();
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    const auto finishStage = [&](const char* stageName) {
+        stageTimings.push_back({ stageName, stageTimer.restart() });
+    };
 
     auto tracks = createMTrackList(sigmap, mf);
+    finishStage("read tracks");
 
-    auto& opers = midiImportOperations;
     if (opers.data()->processingsOfOpenedFile == 0) {         // for newly opened MIDI file
         MidiChordName::findChordNames(tracks);
     }
@@ -1136,6 +1154,7 @@ QList<MTrack> convertMidi(Score* score, const MidiFile* mf)
     } else {      // user value
         MidiBeat::setTimeSignature(sigmap);
     }
+    finishStage("beat detection");
 
     Q_ASSERT_X((opers.data()->trackOpers.isHumanPerformance.value())
                ? Meter::userTimeSigToFraction(opers.data()->trackOpers.timeSigNumerator.value(),
@@ -1146,6 +1165,7 @@ QList<MTrack> convertMidi(Score* score, const MidiFile* mf)
     MChord::collectChords(tracks, { 2, 1 }, { 1, 2 });
     MidiBeat::adjustChordsToBeats(tracks);
     MChord::mergeChordsWithEqualOnTimeAndVoice(tracks);
+    finishStage("chord collection");
 
     // for newly opened MIDI file
     if (opers.data()->processingsOfOpenedFile == 0
@@ -1161,8 +1181,10 @@ QList<MTrack> convertMidi(Score* score, const MidiFile* mf)
     LRHand::splitIntoLeftRightHands(tracks);
     MidiDrum::splitDrumVoices(tracks);
     MidiDrum::splitDrumTracks(tracks);
+    finishStage("hand and drum splitting");
     ReducedFraction lastTick = findLastChordTick(tracks);
     quantizeAllTracks(tracks, sigmap, lastTick);
+    finishStage("quantization and tuplet detection");
     MChord::removeOverlappingNotes(tracks);
 #ifdef QT_DEBUG
     Q_ASSERT_X(!doNotesOverlap(tracks),
@@ -1177,12 +1199,14 @@ QList<MTrack> convertMidi(Score* score, const MidiFile* mf)
     }
     Simplify::simplifyDurationsForDrums(tracks, sigmap);
     MChord::splitUnequalChords(tracks);
+    finishStage("voice separation and simplification");
     // no more track insertion/reordering/deletion from now
     QList<MTrack> trackList = prepareTrackList(tracks);
     MidiInstr::setGrandStaffProgram(trackList);
     MidiInstr::findInstrumentsForAllTracks(trackList);
     MidiInstr::createInstruments(score, trackList);
     MidiDrum::setStaffBracketForDrums(trackList);
+    finishStage("instruments");
 
     const auto firstTick = findFirstChordTick(trackList);
 
@@ -1201,6 +1225,11 @@ QList<MTrack> convertMidi(Score* score, const MidiFile* mf)
     MidiLyrics::setLyricsToScore(trackList);
     MidiTempo::setTempo(tracks, score);
     MidiChordName::setChordNames(trackList);
+    finishStage("score creation");
+
+    for (const auto& stage: stageTimings) {
+        qDebug("MIDI import: %s: %lld ms", qPrintable(stage.first), stage.second);
+    }
 
     return trackList;
 }
@@ -28,9 +28,12 @@
 #include "importmidi_operation.h"
 
 #include <vector>
+#include <map>
 #include <cstddef>
 #include <utility>
 
+#include <QtConcurrentMap>
+
 // ---------------------------------------------------------------------------------------
 // These inner classes definitions are used in cpp files only
 // Include this header to link tests
@@ -120,6 +123,23 @@ private:
     void updateTuplet(std::multimap<ReducedFraction, MidiTuplet::TupletData>::iterator&);
 };
 
+namespace MidiTracks {
+// runs the per-track analysis 'func' for all tracks on the global thread pool;
+// 'func' may modify only the track it gets and read the import operations,
+// so the result doesn't depend on the order in which tracks are processed
+
+template<typename Func>
+void forEachTrackInParallel(std::multimap<int, MTrack>& tracks, Func func)
+{
+    std::vector<MTrack*> trackList;
+    trackList.reserve(tracks.size());
+    for (auto& track: tracks) {
+        trackList.push_back(&track.second);
+    }
+    QtConcurrent::blockingMap(trackList, [&func](MTrack* track) { func(*track); });
+}
+} // namespace MidiTracks
+
 namespace MidiTuplet {
 struct TupletInfo
 {
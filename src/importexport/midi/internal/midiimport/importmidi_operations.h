@@ -233,6 +233,8 @@ struct FileData
     QList<std::multimap<ReducedFraction, std::string> > lyricTracks;
     std::multimap<ReducedFraction, QString> chordNames;
     HumanBeatData humanBeatData;
+    // <stage name, elapsed ms> of the last conversion of this file
+    std::vector<std::pair<QString, qint64> > stageTimings;
 };
 
 class Data
@@ -256,7 +258,9 @@ private:
 
     QString _currentMidiFile;
     QString _midiOperationsFile;
-    int _currentTrack = -1;
+    // per thread because tracks are analysed in parallel,
+    // see MidiTracks::forEachTrackInParallel
+    static thread_local int _currentTrack;
 
     std::map<QString, FileData> _data;      // <file name, tracks data>
 };
@@ -283,14 +283,13 @@ void simplifyDurations(
 {
     auto& opers = midiImportOperations;
 
-    for (auto& track: tracks) {
-        MTrack& mtrack = track.second;
+    MidiTracks::forEachTrackInParallel(tracks, [&](MTrack& mtrack) {
         if (mtrack.mtrack->drumTrack() != simplifyDrumTracks) {
-            continue;
+            return;
         }
-        auto& chords = track.second.chords;
+        auto& chords = mtrack.chords;
         if (chords.empty()) {
-            continue;
+            return;
         }
 
         if (opers.data()->trackOpers.simplifyDurations.value(mtrack.indexOfOperation)) {
@@ -310,7 +309,7 @@ void simplifyDurations(
                                                       "or non-tuplet chord/note is inside tuplet after simplification");
 #endif
         }
-    }
+    });
 }
 
 void simplifyDurationsForDrums(std::multimap<int, MTrack>& tracks, const TimeSigMap* sigmap)
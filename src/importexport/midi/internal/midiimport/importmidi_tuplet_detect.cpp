@@ -206,13 +206,19 @@ TupletInfo findTupletApproximation(
 
     std::multimap<Error, Candidate> chordCandidates;
 
+    const auto halfTupletNoteLen = tupletNoteLen / 2;
+    // tuplet note positions are increasing, so chords that are too early
+    // for the current position are too early for all next positions as well
+    auto windowStartIt = startChordIt;
+
     for (int posIndex = 0; posIndex != tupletNumber; ++posIndex) {
         const auto tupletNotePos = startTupletTime + tupletNoteLen * posIndex;
-        for (auto it = startChordIt; it != endChordIt; ++it) {
-            if (it->first < tupletNotePos - tupletNoteLen / 2) {
-                continue;
-            }
-            if (it->first > tupletNotePos + tupletNoteLen / 2) {
+        while (windowStartIt != endChordIt
+               && windowStartIt->first < tupletNotePos - halfTupletNoteLen) {
+            ++windowStartIt;
+        }
+        for (auto it = windowStartIt; it != endChordIt; ++it) {
+            if (it->first > tupletNotePos + halfTupletNoteLen) {
                 break;
             }
 
@@ -311,15 +317,15 @@ bool haveChordsInTheMiddleBetweenTupletChords(
     return false;
 }
 
+// regular quant of the chord range doesn't depend on the tuplet number,
+// so it is found once per bar division by the caller
+
 bool isTupletLenAllowed(
     const ReducedFraction& tupletLen,
     int tupletNumber,
-    const std::multimap<ReducedFraction, MidiChord>::const_iterator beg,
-    const std::multimap<ReducedFraction, MidiChord>::const_iterator end,
-    const ReducedFraction& basicQuant)
+    const ReducedFraction& regularQuant)
 {
     const auto tupletNoteLen = tupletLen / tupletNumber;
-    const auto regularQuant = Quantize::findQuantForRange(beg, end, basicQuant);
     return tupletNoteLen >= regularQuant;
 }
 
@@ -366,8 +372,14 @@ std::vector<TupletInfo> detectTuplets(
     int id = 0;
     const auto tol = basicQuant / 2;
 
+    const auto& opers = midiImportOperations.data()->trackOpers;
+    const bool simplifyDurations = opers.simplifyDurations.value(midiImportOperations.currentTrack());
+
     for (const auto& divLen: divLengths) {
         const auto tupletNumbers = findTupletNumbers(divLen, barFraction);
+        if (tupletNumbers.empty()) {
+            continue;
+        }
         const auto div = barFraction / divLen;
         const int divCount = div.numerator() / div.denominator();
 
@@ -391,21 +403,19 @@ std::vector<TupletInfo> detectTuplets(
             if (!isNextBarOwnershipOk(startDivChordIt, endDivChordIt, chords, barIndex)) {
                 continue;
             }
+            const auto regularQuant = Quantize::findQuantForRange(startDivChordIt, endDivChordIt,
+                                                                  basicQuant);
             // try different tuplets, nested tuplets are not allowed
             // here chords from next bar can be captured
             // if their on time < next bar start
             for (const auto& tupletNumber: tupletNumbers) {
-                if (!isTupletLenAllowed(divLen, tupletNumber, startDivChordIt, endDivChordIt,
-                                        basicQuant)) {
+                if (!isTupletLenAllowed(divLen, tupletNumber, regularQuant)) {
                     continue;
                 }
                 auto tupletInfo = findTupletApproximation(divLen, tupletNumber,
                                                           basicQuant, startDivTime, startDivChordIt, endDivChordIt);
 
-                const auto& opers = midiImportOperations.data()->trackOpers;
-                const int currentTrack = midiImportOperations.currentTrack();
-
-                if (opers.simplifyDurations.value(currentTrack)) {
+                if (simplifyDurations) {
                     if (!haveChordsInTheMiddleBetweenTupletChords(
                             startDivChordIt, endDivChordIt, tupletInfo)) {
                         detectStaccato(tupletInfo);
@@ -22,6 +22,7 @@
 #include "importmidi_voice.h"
 
 #include <QSet>
+#include <atomic>
 
 #include "importmidi_tuplet.h"
 #include "importmidi_inner.h"
@@ -1063,16 +1064,14 @@ void sortVoices(
 bool separateVoices(std::multimap<int, MTrack>& tracks, const TimeSigMap* sigmap)
 {
     auto& opers = midiImportOperations;
-    bool changed = false;
+    std::atomic<bool> changed(false);
 
-    for (auto& track: tracks) {
-        MTrack& mtrack = track.second;
+    MidiTracks::forEachTrackInParallel(tracks, [&](MTrack& mtrack) {
         if (mtrack.mtrack->drumTrack()) {
-            continue;
+            return;
         }
-        auto& chords = track.second.chords;
-        if (chords.empty()) {
-            continue;
+        if (mtrack.chords.empty()) {
+            return;
         }
         const int userVoiceCount = toIntVoiceCount(
             opers.data()->trackOpers.maxVoiceCount.value(mtrack.indexOfOperation));
@@ -1113,7 +1112,7 @@ bool separateVoices(std::multimap<int, MTrack>& tracks, const TimeSigMap* sigmap
                                                     "after voice sort");
 #endif
         }
-    }
+    });
 
     return changed;
 }
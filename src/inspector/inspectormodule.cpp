@@ -58,7 +58,7 @@
 using namespace mu::inspector;
 using namespace mu::modularity;
 
-static std::shared_ptr<InspectorModelCreator> s_inspectorModelCreator = std::make_shared<InspectorModelCreator>();
+static std::shared_ptr<InspectorModelCreator> s_inspectorModelCreator;
 
 static void inspector_init_qrc()
 {
@@ -72,6 +72,9 @@ std::string InspectorModule::moduleName() const
 
 void InspectorModule::registerExports()
 {
+    //! NOTE Created here rather than statically, so nothing is created when the module is not set up (converter mode)
+    s_inspectorModelCreator = std::make_shared<InspectorModelCreator>();
+
     ioc()->registerExport<IInspectorModelCreator>(moduleName(), s_inspectorModelCreator);
 }
 
@@ -34,8 +34,13 @@ using namespace mu::learn;
 using namespace mu::framework;
 using namespace mu::modularity;
 
-static std::shared_ptr<LearnConfiguration> s_learnConfiguration = std::make_shared<LearnConfiguration>();
-static std::shared_ptr<LearnService> s_learnService = std::make_shared<LearnService>();
+//! NOTE The playlists are needed only when the learn page is opened
+//! or after the delayed init, so the service is created on the first use
+static std::shared_ptr<LearnService> learnService()
+{
+    static std::shared_ptr<LearnService> s_learnService = std::make_shared<LearnService>();
+    return s_learnService;
+}
 
 static void learn_init_qrc()
 {
@@ -49,8 +54,8 @@ std::string LearnModule::moduleName() const
 
 void LearnModule::registerExports()
 {
-    ioc()->registerExport<ILearnConfiguration>(moduleName(), s_learnConfiguration);
-    ioc()->registerExport<ILearnService>(moduleName(), s_learnService);
+    ioc()->registerExport<ILearnConfiguration>(moduleName(), new LearnConfiguration());
+    ioc()->registerExportLazy<ILearnService>(moduleName(), []() { return learnService(); });
 }
 
 void LearnModule::registerResources()
@@ -65,5 +70,5 @@ void LearnModule::registerUiTypes()
 
 void LearnModule::onDelayedInit()
 {
-    s_learnService->refreshPlaylists();
+    learnService()->refreshPlaylists();
 }
@@ -208,7 +208,7 @@ int main(int argc, char** argv)
 #endif
     app.addModule(new mu::midi::MidiModule());
 
-    app.addModule(new mu::learn::LearnModule());
+    app.addGuiModule(new mu::learn::LearnModule());
 
     app.addModule(new mu::engraving::EngravingModule());
     app.addModule(new mu::notation::NotationModule());
@@ -221,20 +221,20 @@ int main(int argc, char** argv)
 #endif
 
 #ifdef BUILD_INSTRUMENTSSCENE_MODULE
-    app.addModule(new mu::instrumentsscene::InstrumentsSceneModule());
+    app.addGuiModule(new mu::instrumentsscene::InstrumentsSceneModule());
 #else
-    app.addModule(new mu::instrumentsscene::InstrumentsSceneStubModule());
+    app.addGuiModule(new mu::instrumentsscene::InstrumentsSceneStubModule());
 #endif
 
 #ifdef BUILD_VST
     app.addModule(new mu::vst::VSTModule());
 #endif
 
-    app.addModule(new mu::inspector::InspectorModule());
+    app.addGuiModule(new mu::inspector::InspectorModule());
 #ifdef BUILD_PALETTE_MODULE
-    app.addModule(new mu::palette::PaletteModule());
+    app.addGuiModule(new mu::palette::PaletteModule());
 #else
-    app.addModule(new mu::palette::PaletteStubModule());
+    app.addGuiModule(new mu::palette::PaletteStubModule());
 #endif
     app.addModule(new mu::converter::ConverterModule());
 
@@ -279,7 +279,7 @@ int main(int argc, char** argv)
     app.addModule(new mu::diagnostics::DiagnosticsModule());
 
 #ifdef BUILD_AUTOBOT_MODULE
-    app.addModule(new mu::autobot::AutobotModule());
+    app.addGuiModule(new mu::autobot::AutobotModule());
 #endif
 
 #else
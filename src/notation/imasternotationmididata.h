@@ -32,6 +32,14 @@
 #include "notation/inotationparts.h"
 
 namespace mu::notation {
+struct MidiEventsCacheCounters {
+    uint64_t hits = 0;              // chunks served from the cache
+    uint64_t misses = 0;            // chunks rendered on request
+    uint64_t prerendered = 0;       // chunks rendered in the background after an edit
+    uint64_t invalidated = 0;       // chunks dropped by edits
+    uint64_t renderedTicks = 0;
+};
+
 class IMasterNotationMidiData
 {
 public:
@@ -46,6 +54,8 @@ public:
                                         const midi::tick_t toTick) const = 0;
     virtual midi::Events retrieveEventsForElement(const Element* element, const midi::channel_t midiChannel) const = 0;
     virtual std::vector<midi::Event> retrieveSetupEvents(const std::list<InstrumentChannel*> instrChannel) const = 0;
+
+    virtual MidiEventsCacheCounters eventsCacheCounters() const = 0;
 };
 
 using IMasterNotationMidiDataPtr = std::shared_ptr<IMasterNotationMidiData>;
@@ -76,6 +76,10 @@ public:
     virtual int selectionProximity() const = 0;
     virtual void setSelectionProximity(int proxymity) = 0;
 
+    virtual int canvasRasterCacheSizeMb() const = 0;
+    virtual void setCanvasRasterCacheSizeMb(int sizeMb) = 0;
+    virtual async::Channel<int> canvasRasterCacheSizeMbChanged() const = 0;
+
     virtual ZoomType defaultZoomType() const = 0;
     virtual void setDefaultZoomType(ZoomType zoomType) = 0;
 
@@ -153,6 +157,8 @@ public:
 
     virtual io::paths userScoreOrderListPaths() const = 0;
     virtual void setUserScoreOrderListPaths(const io::paths& paths) = 0;
+
+    virtual io::path instrumentTemplatesCachePath() const = 0;
 };
 }
 
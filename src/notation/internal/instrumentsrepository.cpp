@@ -21,10 +21,16 @@
  */
 #include "instrumentsrepository.h"
 
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QLocale>
+
 #include "log.h"
 #include "translation.h"
 
 #include "libmscore/instrtemplate.h"
+#include "libmscore/instrtemplatecache.h"
 
 using namespace mu::notation;
 
@@ -65,14 +71,25 @@ void InstrumentsRepository::load()
 {
     TRACEFUNC;
 
+    QElapsedTimer timer;
+    timer.start();
+
     m_instrumentTemplates.clear();
     m_genres.clear();
     m_groups.clear();
-    Ms::clearInstrumentTemplates();
 
-    for (const io::path& filePath: configuration()->instrumentListPaths()) {
-        if (!Ms::loadInstrumentTemplates(filePath.toQString())) {
-            LOGE() << "Could not load instruments from " << filePath.toQString() << "!";
+    io::paths sourcePaths = configuration()->instrumentListPaths();
+    QString cachePath = configuration()->instrumentTemplatesCachePath().toQString();
+    QByteArray sourcesKey = makeSourcesKey(sourcePaths);
+
+    bool fromCache = Ms::loadInstrumentTemplatesCache(cachePath, sourcesKey);
+    if (!fromCache) {
+        Ms::clearInstrumentTemplates();
+
+        for (const io::path& filePath: sourcePaths) {
+            if (!Ms::loadInstrumentTemplates(filePath.toQString())) {
+                LOGE() << "Could not load instruments from " << filePath.toQString() << "!";
+            }
         }
     }
 
@@ -92,4 +109,26 @@ void InstrumentsRepository::load()
             m_instrumentTemplates << templ;
         }
     }
+
+    if (!fromCache && !Ms::writeInstrumentTemplatesCache(cachePath, sourcesKey)) {
+        LOGW() << "Could not write the instrument templates cache: " << cachePath;
+    }
+
+    LOGI() << "Instrument templates loaded from " << (fromCache ? "cache" : "xml") << " in " << timer.elapsed() << " ms";
+}
+
+//! NOTE The cache is valid for exactly these files in their current state, and for the current language,
+//! because the names are translated while reading the xml
+QByteArray InstrumentsRepository::makeSourcesKey(const io::paths& sourcePaths) const
+{
+    QByteArray key = QLocale().name().toUtf8();
+
+    for (const io::path& filePath : sourcePaths) {
+        QFileInfo info(filePath.toQString());
+        key += '\n' + info.absoluteFilePath().toUtf8()
+               + '\t' + QByteArray::number(info.size())
+               + '\t' + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+    }
+
+    return key;
 }
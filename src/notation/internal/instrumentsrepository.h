@@ -47,6 +47,8 @@ private:
     void load();
     void clear();
 
+    QByteArray makeSourcesKey(const io::paths& sourcePaths) const;
+
     InstrumentTemplateList m_instrumentTemplates;
     InstrumentGroupList m_groups;
     InstrumentGenreList m_genres;
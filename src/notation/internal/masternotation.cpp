@@ -487,9 +487,27 @@ void MasterNotation::doSetExcerpts(ExcerptNotationList excerpts)
     static_cast<MasterNotationParts*>(m_parts.get())->setExcerpts(excerpts);
 
     for (auto excerpt : excerpts) {
+        //! NOTE The parts draw from the pixmaps budget of the main score
+        get_impl(excerpt)->m_rasterCache = m_rasterCache;
+
         excerpt->notation()->undoStack()->stackChanged().onNotify(this, [this]() {
             notifyAboutNeedSaveChanged();
         });
+
+        excerpt->notation()->notationChanged().onNotify(this, [this]() {
+            scheduleLayoutStep();
+        });
+    }
+}
+
+void MasterNotation::scheduleLayoutStep()
+{
+    //! NOTE An edit in any of the scores cancels the pending layout of all of them,
+    //! so the steps are continued for the main score and every part together
+    Notation::scheduleLayoutStep();
+
+    for (const IExcerptNotationPtr& excerpt : m_excerpts.val) {
+        get_impl(excerpt)->Notation::scheduleLayoutStep();
     }
 }
 
@@ -78,6 +78,8 @@ private:
 
     void notifyAboutNeedSaveChanged();
 
+    void scheduleLayoutStep() override;
+
     ValCh<ExcerptNotationList> m_excerpts;
     IMasterNotationMidiDataPtr m_notationMidiData = nullptr;
 
@@ -25,6 +25,7 @@
 #include "engraving/libmscore/repeatlist.h"
 #include "engraving/libmscore/tempo.h"
 
+#include "async/async.h"
 #include "log.h"
 
 #include "notationerrors.h"
@@ -33,12 +34,19 @@ using namespace mu;
 using namespace mu::notation;
 using namespace mu::midi;
 
+static constexpr int MIN_CHUNK_SIZE_MEASURES = 10;
+
 MasterNotationMidiData::MasterNotationMidiData(IGetScore* getScore, async::Notification notationChanged)
     : m_getScore(getScore)
 {
     notationChanged.onNotify(this, [this]() {
-        m_renderRanges.clear();
-        m_eventsCache.clear();
+        invalidateChunks();
+
+        for (auto& pair : m_midiDataMap) {
+            pair.second.stream.eventsChanged.notify();
+        }
+
+        scheduleChunksRendering();
     });
 }
 
@@ -55,6 +63,10 @@ void MasterNotationMidiData::init(INotationPartsPtr parts)
 
     m_parts = std::move(parts);
     m_midiRenderImpl = std::unique_ptr<Ms::MidiRenderer>(new Ms::MidiRenderer(score()));
+    m_midiRenderImpl->setMinChunkSize(MIN_CHUNK_SIZE_MEASURES);
+    m_chunksCache.clear();
+    m_pendingChunks.clear();
+    m_renderSettingsValid = false;
 
     m_midiDataMap.clear();
 
@@ -110,11 +122,38 @@ Ret MasterNotationMidiData::triggerElementMidiData(const Element* element)
 
 Events MasterNotationMidiData::retrieveEvents(const channel_t midiChannel, const tick_t fromTick, const tick_t toTick) const
 {
-    for (const auto& gap : m_renderRanges.unrenderedGaps(fromTick, toTick)) {
-        loadEvents(gap.second.start, gap.second.end);
+    if (fromTick >= toTick || !m_midiRenderImpl) {
+        return {};
     }
 
-    return eventsFromRange(midiChannel, fromTick, toTick);
+    updateRenderSettings();
+
+    for (const Ms::MidiRenderer::Chunk& chunk : m_midiRenderImpl->chunksFromRange(fromTick, toTick)) {
+        ensureChunkEvents(chunk);
+    }
+
+    Events result;
+
+    auto end = m_chunksCache.upper_bound(toTick);
+    for (auto it = m_chunksCache.begin(); it != end; ++it) {
+        const ChunkEvents& chunk = it->second;
+        if (chunk.lastEventTick < fromTick) {
+            continue;
+        }
+
+        auto search = chunk.events.find(midiChannel);
+        if (search == chunk.events.end()) {
+            continue;
+        }
+
+        const Events& events = search->second;
+        for (auto evIt = events.lower_bound(fromTick); evIt != events.end() && evIt->first <= toTick; ++evIt) {
+            std::vector<Event>& eventsAtTick = result[evIt->first];
+            eventsAtTick.insert(eventsAtTick.end(), evIt->second.begin(), evIt->second.end());
+        }
+    }
+
+    return result;
 }
 
 Events MasterNotationMidiData::retrieveEventsForElement(const Element* element, const channel_t midiChannel) const
@@ -157,25 +196,9 @@ std::vector<Event> MasterNotationMidiData::retrieveSetupEvents(const std::list<I
     return result;
 }
 
-Events MasterNotationMidiData::eventsFromRange(const channel_t midiChannel, const tick_t fromTick, const tick_t toTick) const
+MidiEventsCacheCounters MasterNotationMidiData::eventsCacheCounters() const
 {
-    auto search = m_eventsCache.find(midiChannel);
-
-    if (search == m_eventsCache.end() || fromTick >= toTick) {
-        return {};
-    }
-
-    Events result;
-
-    for (const auto& pair : search->second) {
-        if (pair.first < fromTick || pair.first > toTick) {
-            continue;
-        }
-
-        result.insert(pair);
-    }
-
-    return result;
+    return m_cacheCounters;
 }
 
 Ms::Score* MasterNotationMidiData::score() const
@@ -223,6 +246,8 @@ MidiStream MasterNotationMidiData::buildMidiStream(const Ms::Part* part) const
 
     stream.lastTick = masterScore()->lastMeasure()->endTick().ticks() - 1;
 
+    std::vector<channel_t> allMidiChannels;
+
     for (auto it = part->instruments()->cbegin(); it != part->instruments()->cend(); ++it) {
         const Ms::Instrument* instrument = it->second;
 
@@ -232,6 +257,7 @@ MidiStream MasterNotationMidiData::buildMidiStream(const Ms::Part* part) const
         for (const Ms::Channel* channel : instrument->channel()) {
             channel_t midiChannel = channel->channel();
             midiChannels.push_back(midiChannel);
+            allMidiChannels.push_back(midiChannel);
         }
 
         std::list<InstrumentChannel*> channelList(instrument->channel().begin(), instrument->channel().end());
@@ -253,6 +279,30 @@ MidiStream MasterNotationMidiData::buildMidiStream(const Ms::Part* part) const
         });
     }
 
+    stream.allEventsRequest.onNotify(this, [this, stream, allMidiChannels]() mutable {
+        Events allEvents;
+
+        //! NOTE The score may have grown since the stream was built
+        const Ms::Measure* lastMeasure = masterScore()->lastMeasure();
+        if (!lastMeasure) {
+            stream.allEventsStream.send(std::move(allEvents));
+            return;
+        }
+
+        tick_t lastTick = lastMeasure->endTick().ticks() - 1;
+
+        for (const channel_t& midiChannel : allMidiChannels) {
+            Events events = retrieveEvents(midiChannel, 0, lastTick);
+
+            for (auto& pair : events) {
+                std::vector<Event>& eventsAtTick = allEvents[pair.first];
+                eventsAtTick.insert(eventsAtTick.end(), pair.second.begin(), pair.second.end());
+            }
+        }
+
+        stream.allEventsStream.send(std::move(allEvents));
+    });
+
     return stream;
 }
 
@@ -352,54 +402,203 @@ Ret MasterNotationMidiData::playHarmonyMidiData(const Ms::Harmony* harmony) cons
     return make_ret(Ret::Code::Ok);
 }
 
-void MasterNotationMidiData::loadEvents(const tick_t fromTick, const tick_t toTick) const
+void MasterNotationMidiData::updateRenderSettings() const
 {
-    Ms::EventMap msevents = renderMsEvents(fromTick, toTick);
+    bool playRepeats = configuration()->isPlayRepeatsEnabled();
+    bool metronome = configuration()->isMetronomeEnabled();
+
+    //! NOTE Setting it dirties the playlist, and other renderers (e.g. the exports) switch it without restoring it
+    bool expandRepeatsChanged = masterScore()->expandRepeats() != playRepeats;
+    if (expandRepeatsChanged) {
+        masterScore()->setExpandRepeats(playRepeats);
+    }
 
-    if (msevents.empty()) {
+    if (m_renderSettingsValid && !expandRepeatsChanged && playRepeats == m_playRepeats && metronome == m_metronome) {
         return;
     }
 
-    TicksRange renderedTickRange;
-    renderedTickRange.start = fromTick;
-    renderedTickRange.end = toTick;
+    //! NOTE Both settings change the rendered events (and the unrolled ticks for the repeats),
+    //! so nothing of the cache can be reused
+    m_playRepeats = playRepeats;
+    m_metronome = metronome;
+    m_renderSettingsValid = true;
+
+    m_cacheCounters.invalidated += m_chunksCache.size();
+    m_chunksCache.clear();
+    m_midiRenderImpl->setScoreChanged();
+}
 
-    m_renderRanges.insertOrReplace(renderedTickRange.start, std::move(renderedTickRange));
+void MasterNotationMidiData::ensureChunkEvents(const Ms::MidiRenderer::Chunk& chunk) const
+{
+    tick_t utick1 = static_cast<tick_t>(chunk.utick1());
+    tick_t utick2 = static_cast<tick_t>(chunk.utick2());
+
+    auto search = m_chunksCache.find(utick1);
+    if (search != m_chunksCache.end() && search->second.utick2 == utick2
+        && search->second.tick1 == chunk.tick1() && search->second.tick2 == chunk.tick2()) {
+        ++m_cacheCounters.hits;
+        return;
+    }
+
+    ++m_cacheCounters.misses;
+    renderChunk(chunk);
+}
+
+void MasterNotationMidiData::renderChunk(const Ms::MidiRenderer::Chunk& chunk) const
+{
+    tick_t utick1 = static_cast<tick_t>(chunk.utick1());
+    tick_t utick2 = static_cast<tick_t>(chunk.utick2());
+
+    //! NOTE The partition may have changed since the overlapping entries were rendered
+    auto it = m_chunksCache.lower_bound(utick1);
+    if (it != m_chunksCache.begin() && std::prev(it)->second.utick2 > utick1) {
+        --it;
+    }
+    while (it != m_chunksCache.end() && it->first < utick2) {
+        it = m_chunksCache.erase(it);
+    }
+
+    Ms::MidiRenderer::Context ctx;
+    ctx.metronome = m_metronome;
+    ctx.renderHarmony = true;
+
+    Ms::EventMap msevents;
+    m_midiRenderImpl->renderChunk(chunk, &msevents, ctx);
+
+    ChunkEvents chunkEvents;
+    chunkEvents.utick2 = utick2;
+    chunkEvents.tick1 = chunk.tick1();
+    chunkEvents.tick2 = chunk.tick2();
+    chunkEvents.lastEventTick = utick1;
 
     for (auto& pair : convertMsEvents(std::move(msevents))) {
+        chunkEvents.lastEventTick = std::max(chunkEvents.lastEventTick, pair.first);
+
         for (Event& event : pair.second) {
-            Events& chunk = m_eventsCache[event.channel()];
-            std::vector<Event>& events = chunk[pair.first];
+            std::vector<Event>& events = chunkEvents.events[event.channel()][pair.first];
             events.push_back(std::move(event));
         }
     }
+
+    m_cacheCounters.renderedTicks += utick2 - utick1;
+    m_chunksCache.emplace(utick1, std::move(chunkEvents));
 }
 
-bool MasterNotationMidiData::hasCachedEvents(const channel_t midiChannel) const
+void MasterNotationMidiData::invalidateChunks()
 {
-    return m_eventsCache.find(midiChannel) != m_eventsCache.end();
+    Ms::MasterScore* ms = masterScore();
+    if (!ms || !m_midiRenderImpl) {
+        return;
+    }
+
+    m_midiRenderImpl->setScoreChanged();
+
+    Ms::PlaybackChanges changes = ms->takePlaybackChanges();
+
+    //! NOTE Inserted or removed measures move all the following chunks
+    int endTick = ms->endTick().ticks();
+    if (endTick != m_scoreEndTick) {
+        m_scoreEndTick = endTick;
+        changes.all = true;
+    }
+
+    //! NOTE So do edited repeats, voltas and jumps, which only dirty the playlist
+    std::vector<int> segments = repeatSegments();
+    if (segments != m_repeatSegments) {
+        m_repeatSegments = std::move(segments);
+        changes.all = true;
+    }
+
+    if (changes.isEmpty() || changes.all) {
+        m_cacheCounters.invalidated += m_chunksCache.size();
+        for (const auto& pair : m_chunksCache) {
+            m_pendingChunks.insert(pair.first);
+        }
+        m_chunksCache.clear();
+        return;
+    }
+
+    std::set<tick_t> invalidChunks;
+
+    for (auto it = m_chunksCache.cbegin(); it != m_chunksCache.cend(); ++it) {
+        const ChunkEvents& chunk = it->second;
+        if (chunk.tick1 > changes.tickTo || chunk.tick2 < changes.tickFrom) {
+            continue;
+        }
+
+        invalidChunks.insert(it->first);
+
+        //! NOTE Ties and hairpins of the chunk played right before may sound into the changed range,
+        //! so it is rendered again too
+        if (it != m_chunksCache.cbegin()) {
+            auto prev = std::prev(it);
+            if (prev->second.utick2 == it->first) {
+                invalidChunks.insert(prev->first);
+            }
+        }
+    }
+
+    for (tick_t utick1 : invalidChunks) {
+        ++m_cacheCounters.invalidated;
+        m_pendingChunks.insert(utick1);
+        m_chunksCache.erase(utick1);
+    }
 }
 
-Ms::EventMap MasterNotationMidiData::renderMsEvents(const tick_t fromTick, const tick_t toTick) const
+std::vector<int> MasterNotationMidiData::repeatSegments() const
 {
-    Ms::EventMap msevents;
+    std::vector<int> result;
+    for (const Ms::RepeatSegment* segment : masterScore()->repeatList()) {
+        result.push_back(segment->tick);
+        result.push_back(segment->utick);
+        result.push_back(segment->len());
+    }
 
-    std::vector<Ms::MidiRenderer::Chunk> mschunks = m_midiRenderImpl->chunksFromRange(fromTick, toTick);
-    if (mschunks.empty()) {
-        return msevents;
+    return result;
+}
+
+void MasterNotationMidiData::scheduleChunksRendering()
+{
+    if (m_renderingScheduled || m_pendingChunks.empty()) {
+        return;
     }
 
-    masterScore()->setExpandRepeats(configuration()->isPlayRepeatsEnabled());
+    m_renderingScheduled = true;
 
-    Ms::MidiRenderer::Context ctx;
-    ctx.metronome = configuration()->isMetronomeEnabled();
-    ctx.renderHarmony = true;
+    //! NOTE One chunk per call, so that the UI thread stays responsive between them
+    async::Async::call(this, [this]() {
+        m_renderingScheduled = false;
+        renderNextPendingChunk();
+        scheduleChunksRendering();
+    });
+}
 
-    for (const auto& mschunk : mschunks) {
-        m_midiRenderImpl->renderChunk(mschunk, &msevents, ctx);
+void MasterNotationMidiData::renderNextPendingChunk()
+{
+    if (m_pendingChunks.empty() || !masterScore() || !m_midiRenderImpl) {
+        m_pendingChunks.clear();
+        return;
     }
 
-    return msevents;
+    tick_t utick1 = *m_pendingChunks.begin();
+    m_pendingChunks.erase(m_pendingChunks.begin());
+
+    updateRenderSettings();
+
+    for (const Ms::MidiRenderer::Chunk& chunk : m_midiRenderImpl->chunksFromRange(utick1, utick1)) {
+        if (static_cast<tick_t>(chunk.utick1()) > utick1 || static_cast<tick_t>(chunk.utick2()) <= utick1) {
+            continue;
+        }
+
+        auto search = m_chunksCache.find(static_cast<tick_t>(chunk.utick1()));
+        if (search != m_chunksCache.end() && search->second.utick2 == static_cast<tick_t>(chunk.utick2())) {
+            break;
+        }
+
+        ++m_cacheCounters.prerendered;
+        renderChunk(chunk);
+        break;
+    }
 }
 
 Events MasterNotationMidiData::convertMsEvents(Ms::EventMap&& eventMap) const
@@ -530,50 +729,3 @@ Events MasterNotationMidiData::eventsFromHarmony(const Element* harmonyElement,
 
     return result;
 }
-
-MasterNotationMidiData::TickRangeMap MasterNotationMidiData::RenderRangeMap::unrenderedGaps(const tick_t from, const tick_t to) const
-{
-    TickRangeMap result;
-
-    TicksRange searchRange = { from, to };
-
-    std::vector<TicksRange> unrenderedGaps;
-
-    if (m_renderedRanges.empty()) {
-        result.emplace(from, std::move(searchRange));
-        return result;
-    }
-
-    for (const auto& range : m_renderedRanges) {
-        if (range.second.contains(searchRange)) {
-            return {};
-        } else if (range.second.containsTick(searchRange.start)) {
-            searchRange.start = range.second.end;
-        } else if (range.second.containsTick(searchRange.end)) {
-            searchRange.end = range.second.start;
-        }
-    }
-
-    result.emplace(from, std::move(searchRange));
-    return result;
-}
-
-void MasterNotationMidiData::RenderRangeMap::insertOrReplace(const tick_t key, MasterNotationMidiData::TicksRange&& newRange)
-{
-    auto it = m_renderedRanges.begin();
-
-    while (it != m_renderedRanges.end()) {
-        if (newRange.contains(it->second)) {
-            it = m_renderedRanges.erase(it);
-        } else {
-            ++it;
-        }
-    }
-
-    m_renderedRanges.emplace(key, newRange);
-}
-
-void MasterNotationMidiData::RenderRangeMap::clear()
-{
-    m_renderedRanges.clear();
-}
@@ -24,7 +24,9 @@
 #define MU_NOTATION_MASTERNOTATIONMIDIDATA_H
 
 #include <map>
+#include <set>
 #include <unordered_map>
+#include <vector>
 
 #include "async/asyncable.h"
 #include "async/notification.h"
@@ -53,38 +55,19 @@ public:
     midi::Events retrieveEventsForElement(const Element* element, const midi::channel_t midiChannel) const override;
     std::vector<midi::Event> retrieveSetupEvents(const std::list<InstrumentChannel*> instrChannel) const override;
 
+    MidiEventsCacheCounters eventsCacheCounters() const override;
+
 private:
-    struct TicksRange {
-        midi::tick_t start = 0;
-        midi::tick_t end = 0;
-
-        bool operator <(const TicksRange& other) const
-        {
-            return start < other.start;
-        }
-
-        bool contains(const TicksRange& other) const
-        {
-            return other.start >= start && other.end <= end;
-        }
-
-        bool containsTick(const midi::tick_t tick) const
-        {
-            return tick >= start && tick <= end;
-        }
+    //! NOTE Events of one MidiRenderer chunk, split by channel
+    struct ChunkEvents {
+        midi::tick_t utick2 = 0;
+        int tick1 = 0; // score ticks, used for the invalidation
+        int tick2 = 0;
+        midi::tick_t lastEventTick = 0;
+        std::unordered_map<midi::channel_t, midi::Events> events;
     };
 
-    using TickRangeMap = std::map<midi::tick_t, TicksRange>;
-
-    struct RenderRangeMap {
-        TickRangeMap unrenderedGaps(const midi::tick_t from, const midi::tick_t to) const;
-
-        void insertOrReplace(const midi::tick_t key, TicksRange&& newRange);
-        void clear();
-
-    private:
-        mutable TickRangeMap m_renderedRanges;
-    };
+    using ChunkEventsMap = std::map<midi::tick_t /*utick1*/, ChunkEvents>;
 
     Ms::Score* score() const;
     Ms::MasterScore* masterScore() const;
@@ -99,19 +82,30 @@ private:
     Ret playChordMidiData(const Ms::Chord* chord) const;
     Ret playHarmonyMidiData(const Ms::Harmony* harmony) const;
 
-    void loadEvents(const midi::tick_t fromTick, const midi::tick_t toTick) const;
-    midi::Events eventsFromRange(const midi::channel_t midiChannel, const midi::tick_t fromTick, const midi::tick_t toTick) const;
-    bool hasCachedEvents(const midi::channel_t midiChannel) const;
+    void updateRenderSettings() const;
+    void ensureChunkEvents(const Ms::MidiRenderer::Chunk& chunk) const;
+    void renderChunk(const Ms::MidiRenderer::Chunk& chunk) const;
+    void invalidateChunks();
+    std::vector<int> repeatSegments() const;
+    void scheduleChunksRendering();
+    void renderNextPendingChunk();
 
-    Ms::EventMap renderMsEvents(const midi::tick_t fromTick, const midi::tick_t toTick) const;
     midi::Events convertMsEvents(Ms::EventMap&& eventMap) const;
 
     midi::Events eventsFromNote(const Element* noteElement, const midi::channel_t midiChannel) const;
     midi::Events eventsFromChord(const Element* chordElement, const midi::channel_t midiChannel) const;
     midi::Events eventsFromHarmony(const Element* harmonyElement, const midi::channel_t midiChannel) const;
 
-    mutable RenderRangeMap m_renderRanges;
-    mutable std::unordered_map<midi::channel_t, midi::Events> m_eventsCache = {};
+    mutable ChunkEventsMap m_chunksCache;
+    std::set<midi::tick_t> m_pendingChunks; // utick1 of the chunks to render again in the background
+    bool m_renderingScheduled = false;
+    mutable MidiEventsCacheCounters m_cacheCounters;
+
+    mutable bool m_renderSettingsValid = false;
+    mutable bool m_playRepeats = false;
+    mutable bool m_metronome = false;
+    int m_scoreEndTick = -1;
+    std::vector<int> m_repeatSegments; // tick, utick and length of each repeat segment
 
     std::map<ID /*partId*/, midi::MidiData> m_midiDataMap;
 
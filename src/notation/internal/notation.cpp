@@ -21,10 +21,14 @@
  */
 #include "notation.h"
 
+#include <cmath>
+
+#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QScreen>
 
 #include "log.h"
+#include "async/async.h"
 
 #include "libmscore/masterscore.h"
 #include "libmscore/scorefont.h"
@@ -47,6 +51,16 @@
 
 using namespace mu::notation;
 
+//! NOTE Pages are rasterized only when zoomed out, where a page costs a lot of
+//! vector drawing for few device pixels
+static constexpr qreal RASTER_CACHE_MAX_ZOOM = 0.5;
+static constexpr int RASTER_CACHE_PAGES_PER_FRAME = 2;
+
+//! NOTE The pending layout is continued by a few pages at a time,
+//! while the step stays short enough for the view to keep responding
+static constexpr size_t LAYOUT_STEP_PAGES = 2;
+static constexpr qint64 LAYOUT_STEP_MAX_MS = 30;
+
 Notation::Notation(Ms::Score* score)
 {
     m_scoreGlobal = new Ms::MScore(); //! TODO May be static?
@@ -61,6 +75,27 @@ Notation::Notation(Ms::Score* score)
     m_style = std::make_shared<NotationStyle>(this);
     m_elements = std::make_shared<NotationElements>(this);
 
+    m_rasterCache = std::make_shared<PageRasterCache>();
+    m_rasterCache->setMemoryLimit(static_cast<size_t>(configuration()->canvasRasterCacheSizeMb()) * 1024 * 1024);
+
+    configuration()->canvasRasterCacheSizeMbChanged().onReceive(this, [this](int sizeMb) {
+        m_rasterCache->setMemoryLimit(static_cast<size_t>(sizeMb) * 1024 * 1024);
+    });
+
+    //! NOTE Selection, the score config (frames, page margins, unprintable elements, irregular measures)
+    //! and colors change the look of pages without a relayout
+    m_interaction->selectionChanged().onNotify(this, [this]() {
+        m_rasterCache->clear(m_score);
+    });
+
+    m_interaction->scoreConfigChanged().onReceive(this, [this](ScoreConfigType) {
+        m_rasterCache->clear(m_score);
+    });
+
+    configuration()->foregroundChanged().onNotify(this, [this]() {
+        m_rasterCache->clear();
+    });
+
     m_interaction->noteInput()->noteAdded().onNotify(this, [this]() {
         notifyAboutNotationChanged();
     });
@@ -77,6 +112,15 @@ Notation::Notation(Ms::Score* score)
         notifyAboutNotationChanged();
     });
 
+    //! NOTE Every change (commands, undo/redo, restyle) can leave a pending layout, see Ms::Score::update
+    m_notationChanged.onNotify(this, [this]() {
+        if (m_score) {
+            m_rasterCache->removeDeletedPages(m_score);
+        }
+
+        scheduleLayoutStep();
+    });
+
     m_midiInput->noteChanged().onNotify(this, [this]() {
         notifyAboutNotationChanged();
     });
@@ -90,6 +134,7 @@ Notation::Notation(Ms::Score* score)
     });
 
     engravingConfiguration()->selectionColorChanged().onReceive(this, [this](int, const mu::draw::Color&) {
+        m_rasterCache->clear();
         notifyAboutNotationChanged();
     });
 
@@ -138,6 +183,8 @@ void Notation::setScore(Ms::Score* score)
         static_cast<NotationInteraction*>(m_interaction.get())->init();
         static_cast<NotationPlayback*>(m_playback.get())->init();
     }
+
+    scheduleLayoutStep();
 }
 
 Ms::MScore* Notation::scoreGlobal() const
@@ -162,7 +209,7 @@ void Notation::setViewMode(const ViewMode& viewMode)
     }
 
     score()->setLayoutMode(viewMode);
-    score()->doLayout();
+    score()->doLayoutRange(Fraction(0, 1), Fraction(-1, 1), score()->masterScore()->layoutStepPages());
     notifyAboutNotationChanged();
 }
 
@@ -201,6 +248,10 @@ void Notation::paint(mu::draw::Painter* painter, const RectF& frameRect)
 
 void Notation::paintPages(draw::Painter* painter, const RectF& frameRect, const QList<Ms::Page*>& pages, bool paintBorders) const
 {
+    const qreal scaling = painter->worldTransform().m11();
+    const bool useRasterCache = paintBorders && isRasterCacheUsable(scaling);
+    int renderBudget = RASTER_CACHE_PAGES_PER_FRAME;
+
     for (Ms::Page* page : pages) {
         RectF pageRect(page->abbox().translated(page->pos()));
 
@@ -218,18 +269,85 @@ void Notation::paintPages(draw::Painter* painter, const RectF& frameRect, const
 
         PointF pagePosition(page->pos());
         painter->translate(pagePosition);
+
+        if (useRasterCache && paintCachedPage(painter, page, scaling, renderBudget)) {
+            painter->translate(-pagePosition);
+            continue;
+        }
+
         paintForeground(painter, page->bbox());
         painter->setClipping(true);
         painter->setClipRect(page->bbox());
 
-        QList<Element*> elements = page->items(frameRect.translated(-page->pos()));
-        engraving::Paint::paintElements(*painter, elements);
+        engraving::Paint::paintSortedElements(*painter, page->paintItems(frameRect.translated(-page->pos())));
 
         painter->translate(-pagePosition);
         painter->setClipping(false);
     }
 }
 
+bool Notation::isRasterCacheUsable(qreal scaling) const
+{
+    if (score()->printing()) {
+        return false;
+    }
+
+    return scaling > 0 && scaling <= configuration()->notationScaling() * RASTER_CACHE_MAX_ZOOM;
+}
+
+//! NOTE Pages missing in the cache are rendered a few per frame, the rest
+//! is drawn as vectors meanwhile, so every frame stays exact
+bool Notation::paintCachedPage(draw::Painter* painter, Ms::Page* page, qreal scaling, int& renderBudget) const
+{
+    const int zoomLevel = PageRasterCache::zoomLevel(scaling);
+    const QPixmap* pixmap = m_rasterCache->pixmap(page, zoomLevel);
+
+    if (!pixmap) {
+        if (renderBudget <= 0) {
+            return false;
+        }
+
+        --renderBudget;
+        m_rasterCache->insert(page, zoomLevel, renderPage(page, scaling));
+
+        pixmap = m_rasterCache->pixmap(page, zoomLevel);
+        if (!pixmap) {
+            return false;
+        }
+    }
+
+    PointF topLeft = page->bbox().topLeft() * scaling;
+
+    painter->save();
+    painter->scale(1.0 / scaling, 1.0 / scaling);
+    painter->drawPixmap(topLeft, *pixmap);
+    painter->restore();
+
+    return true;
+}
+
+QPixmap Notation::renderPage(Ms::Page* page, qreal scaling) const
+{
+    const RectF pageRect = page->bbox();
+    const qreal dpr = QGuiApplication::primaryScreen()->devicePixelRatio();
+
+    QPixmap pixmap(static_cast<int>(std::ceil(pageRect.width() * scaling * dpr)),
+                   static_cast<int>(std::ceil(pageRect.height() * scaling * dpr)));
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+
+    mu::draw::Painter painter(&pixmap, "pagerastercache");
+    painter.setAntialiasing(true);
+    painter.scale(scaling, scaling);
+    painter.translate(-pageRect.topLeft());
+
+    paintForeground(&painter, pageRect);
+    engraving::Paint::paintSortedElements(painter, page->paintItems());
+    painter.endDraw();
+
+    return pixmap;
+}
+
 void Notation::paintPageBorder(draw::Painter* painter, const Ms::Page* page) const
 {
     using namespace mu::draw;
@@ -289,6 +407,35 @@ void Notation::notifyAboutNotationChanged()
     m_notationChanged.notify();
 }
 
+//! NOTE The engraving model isn't thread-safe, so the pending layout runs in the main thread,
+//! in steps queued between the events. Each step publishes the new pages to the views
+//! by notationChanged, which schedules the next step
+void Notation::scheduleLayoutStep()
+{
+    if (m_isLayoutStepScheduled || !m_score || !m_score->isLayoutPending()) {
+        return;
+    }
+
+    m_isLayoutStepScheduled = true;
+
+    async::Async::call(this, [this]() {
+        m_isLayoutStepScheduled = false;
+
+        if (!m_score || !m_score->isLayoutPending()) {
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        do {
+            m_score->layoutNextPages(LAYOUT_STEP_PAGES);
+        } while (m_score->isLayoutPending() && timer.elapsed() < LAYOUT_STEP_MAX_MS);
+
+        notifyAboutNotationChanged();
+    });
+}
+
 INotationInteractionPtr Notation::interaction() const
 {
     return m_interaction;
@@ -28,6 +28,7 @@
 
 #include "../inotation.h"
 #include "igetscore.h"
+#include "pagerastercache.h"
 #include "../inotationconfiguration.h"
 
 namespace Ms {
@@ -81,13 +82,19 @@ protected:
 
 private:
     friend class NotationInteraction;
+    friend class MasterNotation;
 
     void paintPages(mu::draw::Painter* painter, const RectF& frameRect, const QList<Ms::Page*>& pages, bool paintBorders) const;
+    bool paintCachedPage(mu::draw::Painter* painter, Ms::Page* page, qreal scaling, int& renderBudget) const;
+    QPixmap renderPage(Ms::Page* page, qreal scaling) const;
+    bool isRasterCacheUsable(qreal scaling) const;
     void paintPageBorder(mu::draw::Painter* painter, const Ms::Page* page) const;
     void paintForeground(mu::draw::Painter* painter, const RectF& pageRect) const;
 
     QSizeF viewSize() const;
 
+    virtual void scheduleLayoutStep();
+
     QSizeF m_viewSize;
     Ms::MScore* m_scoreGlobal = nullptr;
     Ms::Score* m_score = nullptr;
@@ -100,6 +107,9 @@ private:
     INotationMidiInputPtr m_midiInput = nullptr;
     INotationAccessibilityPtr m_accessibility = nullptr;
     INotationElementsPtr m_elements = nullptr;
+
+    PageRasterCachePtr m_rasterCache = nullptr;
+    bool m_isLayoutStepScheduled = false;
 };
 }
 
@@ -55,6 +55,7 @@ static const Settings::Key FOREGROUND_WALLPAPER_PATH(module_name, "ui/canvas/for
 static const Settings::Key FOREGROUND_USE_COLOR(module_name, "ui/canvas/foreground/useColor");
 
 static const Settings::Key SELECTION_PROXIMITY(module_name, "ui/canvas/misc/selectionProximity");
+static const Settings::Key RASTER_CACHE_SIZE(module_name, "ui/canvas/misc/rasterCacheSizeMb");
 
 static const Settings::Key DEFAULT_ZOOM_TYPE(module_name, "ui/canvas/zoomDefaultType");
 static const Settings::Key DEFAULT_ZOOM(module_name, "ui/canvas/zoomDefaultLevel");
@@ -152,6 +153,10 @@ void NotationConfiguration::init()
     fileSystem()->makePath(userStylesPath());
 
     settings()->setDefaultValue(SELECTION_PROXIMITY, Val(6));
+    settings()->setDefaultValue(RASTER_CACHE_SIZE, Val(256));
+    settings()->valueChanged(RASTER_CACHE_SIZE).onReceive(nullptr, [this](const Val& val) {
+        m_canvasRasterCacheSizeMbChanged.send(val.toInt());
+    });
     settings()->setDefaultValue(IS_MIDI_INPUT_ENABLED, Val(false));
     settings()->setDefaultValue(IS_AUTOMATICALLY_PAN_ENABLED, Val(true));
     settings()->setDefaultValue(IS_PLAY_REPEATS_ENABLED, Val(false));
@@ -344,6 +349,21 @@ void NotationConfiguration::setSelectionProximity(int proxymity)
     settings()->setSharedValue(SELECTION_PROXIMITY, Val(proxymity));
 }
 
+int NotationConfiguration::canvasRasterCacheSizeMb() const
+{
+    return settings()->value(RASTER_CACHE_SIZE).toInt();
+}
+
+void NotationConfiguration::setCanvasRasterCacheSizeMb(int sizeMb)
+{
+    settings()->setSharedValue(RASTER_CACHE_SIZE, Val(sizeMb));
+}
+
+async::Channel<int> NotationConfiguration::canvasRasterCacheSizeMbChanged() const
+{
+    return m_canvasRasterCacheSizeMbChanged;
+}
+
 ZoomType NotationConfiguration::defaultZoomType() const
 {
     return static_cast<ZoomType>(settings()->value(DEFAULT_ZOOM_TYPE).toInt());
@@ -694,6 +714,11 @@ void NotationConfiguration::setUserScoreOrderListPaths(const io::paths& paths)
     }
 }
 
+io::path NotationConfiguration::instrumentTemplatesCachePath() const
+{
+    return globalConfiguration()->userAppDataPath() + "/instruments.cache";
+}
+
 io::path NotationConfiguration::firstScoreOrderListPath() const
 {
     return settings()->value(FIRST_SCORE_ORDER_LIST_KEY).toString();
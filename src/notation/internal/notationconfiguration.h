@@ -81,6 +81,10 @@ public:
     int selectionProximity() const override;
     void setSelectionProximity(int proxymity) override;
 
+    int canvasRasterCacheSizeMb() const override;
+    void setCanvasRasterCacheSizeMb(int sizeMb) override;
+    async::Channel<int> canvasRasterCacheSizeMbChanged() const override;
+
     ZoomType defaultZoomType() const override;
     void setDefaultZoomType(ZoomType zoomType) override;
 
@@ -159,6 +163,8 @@ public:
     io::paths userScoreOrderListPaths() const override;
     void setUserScoreOrderListPaths(const io::paths& paths) override;
 
+    io::path instrumentTemplatesCachePath() const override;
+
 private:
     io::path firstInstrumentListPath() const;
     void setFirstInstrumentListPath(const io::path& path);
@@ -175,6 +181,7 @@ private:
     async::Notification m_backgroundChanged;
     async::Notification m_foregroundChanged;
     async::Channel<int> m_currentZoomChanged;
+    async::Channel<int> m_canvasRasterCacheSizeMbChanged;
     async::Channel<framework::Orientation> m_canvasOrientationChanged;
     async::Channel<io::path> m_userStylesPathChanged;
     async::Notification m_instrumentListPathsChanged;
@@ -1102,7 +1102,8 @@ bool NotationInteraction::drop(const PointF& pos, Qt::KeyboardModifiers modifier
 
 void NotationInteraction::selectInstrument(Ms::InstrumentChange* instrumentChange)
 {
-    if (!instrumentChange) {
+    //! NOTE The instruments scene module is not set up in converter mode
+    if (!instrumentChange || !selectInstrumentScenario()) {
         return;
     }
 
@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "pagerastercache.h"
+
+#include <cmath>
+#include <set>
+
+#include "libmscore/page.h"
+#include "libmscore/score.h"
+
+using namespace mu::notation;
+
+//! NOTE Pixmaps are blitted 1:1, so the zoom level is the scaling itself, quantized
+//! finely enough that two different zoom steps never share a level
+int PageRasterCache::zoomLevel(qreal scaling)
+{
+    return static_cast<int>(std::lround(scaling * 10000.0));
+}
+
+void PageRasterCache::setMemoryLimit(size_t bytes)
+{
+    m_memoryLimit = bytes;
+    evict();
+}
+
+size_t PageRasterCache::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+const QPixmap* PageRasterCache::pixmap(const Ms::Page* page, int zoomLevel)
+{
+    auto it = m_entries.find({ page, zoomLevel });
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+
+    if (it->second.layoutRevision != page->layoutRevision()) {
+        remove(it);
+        return nullptr;
+    }
+
+    it->second.lastUsed = ++m_useCounter;
+    return &it->second.pixmap;
+}
+
+void PageRasterCache::insert(const Ms::Page* page, int zoomLevel, const QPixmap& pixmap)
+{
+    auto it = m_entries.find({ page, zoomLevel });
+    if (it != m_entries.end()) {
+        remove(it);
+    }
+
+    Entry entry;
+    entry.score = page->score();
+    entry.pixmap = pixmap;
+    entry.layoutRevision = page->layoutRevision();
+    entry.lastUsed = ++m_useCounter;
+
+    m_memoryUsage += pixmapSize(pixmap);
+    m_entries.emplace(Key { page, zoomLevel }, std::move(entry));
+
+    evict();
+}
+
+void PageRasterCache::clear()
+{
+    m_entries.clear();
+    m_memoryUsage = 0;
+}
+
+void PageRasterCache::clear(const Ms::Score* score)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.score == score) {
+            m_memoryUsage -= pixmapSize(it->second.pixmap);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PageRasterCache::removeDeletedPages(const Ms::Score* score)
+{
+    const QList<Ms::Page*>& pages = score->pages();
+    const std::set<const Ms::Page*> existingPages(pages.cbegin(), pages.cend());
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.score == score && existingPages.find(it->first.page) == existingPages.end()) {
+            m_memoryUsage -= pixmapSize(it->second.pixmap);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t PageRasterCache::pixmapSize(const QPixmap& pixmap)
+{
+    return static_cast<size_t>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+void PageRasterCache::remove(std::map<Key, Entry>::iterator it)
+{
+    m_memoryUsage -= pixmapSize(it->second.pixmap);
+    m_entries.erase(it);
+}
+
+void PageRasterCache::evict()
+{
+    while (m_memoryUsage > m_memoryLimit && !m_entries.empty()) {
+        auto lru = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->second.lastUsed < lru->second.lastUsed) {
+                lru = it;
+            }
+        }
+        remove(lru);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_NOTATION_PAGERASTERCACHE_H
+#define MU_NOTATION_PAGERASTERCACHE_H
+
+#include <map>
+#include <memory>
+
+#include <QPixmap>
+
+namespace Ms {
+class Page;
+class Score;
+}
+
+namespace mu::notation {
+//! NOTE Keeps pages rendered into pixmaps at the zoom levels they were viewed at.
+//! A pixmap is valid as long as layout didn't touch its page (see Page::layoutRevision),
+//! the least recently used pixmaps are evicted when the memory limit is exceeded.
+//! The master score and its parts share one cache, so they share the memory limit too.
+class PageRasterCache
+{
+public:
+    static int zoomLevel(qreal scaling);
+
+    void setMemoryLimit(size_t bytes);
+    size_t memoryUsage() const;
+
+    const QPixmap* pixmap(const Ms::Page* page, int zoomLevel);
+    void insert(const Ms::Page* page, int zoomLevel, const QPixmap& pixmap);
+
+    void clear();
+    void clear(const Ms::Score* score);
+
+    //! NOTE Pages deleted by a relayout are not asked for any more, their pixmaps would stay until evicted
+    void removeDeletedPages(const Ms::Score* score);
+
+private:
+    struct Key {
+        const Ms::Page* page = nullptr;
+        int zoomLevel = 0;
+
+        bool operator<(const Key& other) const
+        {
+            if (page != other.page) {
+                return page < other.page;
+            }
+            return zoomLevel < other.zoomLevel;
+        }
+    };
+
+    struct Entry {
+        const Ms::Score* score = nullptr;
+        QPixmap pixmap;
+        uint64_t layoutRevision = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    static size_t pixmapSize(const QPixmap& pixmap);
+
+    void remove(std::map<Key, Entry>::iterator it);
+    void evict();
+
+    std::map<Key, Entry> m_entries;
+    size_t m_memoryUsage = 0;
+    size_t m_memoryLimit = 0;
+    uint64_t m_useCounter = 0;
+};
+
+using PageRasterCachePtr = std::shared_ptr<PageRasterCache>;
+}
+
+#endif // MU_NOTATION_PAGERASTERCACHE_H
@@ -21,6 +21,7 @@
  */
 #include "notationpaintview.h"
 
+#include <chrono>
 #include <QPainter>
 
 #include "actions/actiontypes.h"
@@ -39,6 +40,9 @@ static constexpr qreal CANVAS_SIDE_MARGIN = 8000;
 static constexpr qreal SCROLL_LIMIT_OFF_OFFSET = 0.75;
 static constexpr qreal SCROLL_LIMIT_ON_OFFSET = 0.02;
 
+static constexpr int FRAME_TIME_STATS_WINDOW = 120;
+static constexpr double FRAME_TIME_BUDGET_MS = 1000.0 / 60.0;
+
 NotationPaintView::NotationPaintView(QQuickItem* parent)
     : QQuickPaintedItem(parent)
 {
@@ -348,6 +352,8 @@ void NotationPaintView::paint(QPainter* qp)
 
     TRACEFUNC;
 
+    auto frameStart = std::chrono::steady_clock::now();
+
     mu::draw::Painter mup(qp, "notationview");
     mu::draw::Painter* painter = &mup;
 
@@ -362,6 +368,34 @@ void NotationPaintView::paint(QPainter* qp)
     m_noteInputCursor->paint(painter);
     m_loopInMarker->paint(painter);
     m_loopOutMarker->paint(painter);
+
+    std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+    updateFrameTimeStats(frameTime.count());
+}
+
+void NotationPaintView::updateFrameTimeStats(double frameTimeMs)
+{
+    FrameTimeStats& stats = m_frameTimeStats;
+    stats.frames++;
+    stats.totalMs += frameTimeMs;
+    stats.maxMs = std::max(stats.maxMs, frameTimeMs);
+    if (frameTimeMs > FRAME_TIME_BUDGET_MS) {
+        stats.slowFrames++;
+    }
+
+    if (stats.frames < FRAME_TIME_STATS_WINDOW) {
+        return;
+    }
+
+    //! NOTE Report only windows with frames over budget, so idle repaints don't spam the log
+    if (stats.slowFrames > 0) {
+        LOGD() << "paint frames: " << stats.frames
+               << ", avg: " << (stats.totalMs / stats.frames) << " ms"
+               << ", max: " << stats.maxMs << " ms"
+               << ", over budget: " << stats.slowFrames;
+    }
+
+    stats = FrameTimeStats();
 }
 
 void NotationPaintView::onNotationSetup()
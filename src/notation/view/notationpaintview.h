@@ -189,6 +189,7 @@ private:
     QPointF alignToCurrentPageBorder(const QRectF& showRect, const QPointF& pos) const;
 
     void paintBackground(const RectF& rect, draw::Painter* painter);
+    void updateFrameTimeStats(double frameTimeMs);
 
     PointF canvasCenter() const;
     std::pair<int, int> constraintCanvas(int dx, int dy) const;
@@ -203,6 +204,15 @@ private:
 
     qreal m_previousVerticalScrollPosition = 0;
     qreal m_previousHorizontalScrollPosition = 0;
+
+    struct FrameTimeStats {
+        int frames = 0;
+        int slowFrames = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    FrameTimeStats m_frameTimeStats;
 };
 }
 
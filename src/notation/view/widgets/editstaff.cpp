@@ -554,6 +554,11 @@ void EditStaff::applyPartProperties()
 
 void EditStaff::showReplaceInstrumentDialog()
 {
+    //! NOTE The instruments scene module is not set up in converter mode
+    if (!selectInstrumentsScenario()) {
+        return;
+    }
+
     RetVal<Instrument> selectedInstrument = selectInstrumentsScenario()->selectInstrument(m_instrumentKey);
     if (!selectedInstrument.ret) {
         LOGE() << selectedInstrument.ret.toString();
@@ -51,11 +51,11 @@ using namespace mu::palette;
 using namespace mu::modularity;
 using namespace mu::ui;
 
-static std::shared_ptr<Ms::PaletteProvider> s_paletteProvider = std::make_shared<Ms::PaletteProvider>();
-static std::shared_ptr<PaletteActionsController> s_actionsController = std::make_shared<PaletteActionsController>();
-static std::shared_ptr<PaletteUiActions> s_paletteUiActions = std::make_shared<PaletteUiActions>(s_actionsController);
-static std::shared_ptr<PaletteConfiguration> s_configuration = std::make_shared<PaletteConfiguration>();
-static std::shared_ptr<PaletteWorkspaceSetup> s_paletteWorkspaceSetup = std::make_shared<PaletteWorkspaceSetup>();
+static std::shared_ptr<Ms::PaletteProvider> s_paletteProvider;
+static std::shared_ptr<PaletteActionsController> s_actionsController;
+static std::shared_ptr<PaletteUiActions> s_paletteUiActions;
+static std::shared_ptr<PaletteConfiguration> s_configuration;
+static std::shared_ptr<PaletteWorkspaceSetup> s_paletteWorkspaceSetup;
 
 static void palette_init_qrc()
 {
@@ -69,6 +69,13 @@ std::string PaletteModule::moduleName() const
 
 void PaletteModule::registerExports()
 {
+    //! NOTE Created here rather than statically, so nothing is created when the module is not set up (converter mode)
+    s_paletteProvider = std::make_shared<Ms::PaletteProvider>();
+    s_actionsController = std::make_shared<PaletteActionsController>();
+    s_paletteUiActions = std::make_shared<PaletteUiActions>(s_actionsController);
+    s_configuration = std::make_shared<PaletteConfiguration>();
+    s_paletteWorkspaceSetup = std::make_shared<PaletteWorkspaceSetup>();
+
     ioc()->registerExport<IPaletteProvider>(moduleName(), s_paletteProvider);
     ioc()->registerExport<IPaletteConfiguration>(moduleName(), s_configuration);
 }
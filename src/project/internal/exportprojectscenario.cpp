@@ -28,6 +28,14 @@ using namespace mu::project;
 using namespace mu::notation;
 using namespace mu::framework;
 
+//! NOTE The pages can still be laid out in steps, see Notation::scheduleLayoutStep
+static void finishLayout(const INotationPtrList& notations)
+{
+    for (INotationPtr notation : notations) {
+        notation->elements()->msScore()->finishLayout();
+    }
+}
+
 std::vector<INotationWriter::UnitType> ExportProjectScenario::supportedUnitTypes(const ExportType& exportType) const
 {
     IF_ASSERT_FAILED(!exportType.suffixes.isEmpty()) {
@@ -63,6 +71,8 @@ bool ExportProjectScenario::exportScores(const INotationPtrList& notations, cons
         return false;
     }
 
+    finishLayout(notations);
+
     bool isCreatingOnlyOneFile = this->isCreatingOnlyOneFile(notations, unitType);
 
     // If isCreatingOnlyOneFile, the save dialog has already asked whether to replace
@@ -165,6 +175,7 @@ mu::io::path ExportProjectScenario::askExportPath(const INotationPtrList& notati
     // types in the save dialog and therefore we can put the file dialog in charge of
     // asking the user whether an existing file should be overridden. Otherwise, we
     // will take care of that ourselves.
+    finishLayout(notations);
     bool isCreatingOnlyOneFile = this->isCreatingOnlyOneFile(notations, unitType);
     bool isExportingOnlyOneScore = notations.size() == 1;
 
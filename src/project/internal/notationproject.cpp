@@ -127,6 +127,7 @@ mu::Ret NotationProject::doLoad(engraving::MscReader& reader, const io::path& st
     }
 
     // Setup master score
+    setupLayoutSteps(project->masterScore());
     err = project->setupMasterScore();
     if (err != engraving::Err::NoError) {
         return make_ret(err);
@@ -190,6 +191,7 @@ mu::Ret NotationProject::doImport(const io::path& path, const io::path& stylePat
     }
 
     // Setup master score
+    setupLayoutSteps(project->masterScore());
     engraving::Err err = project->setupMasterScore();
     if (err != engraving::Err::NoError) {
         return make_ret(err);
@@ -291,6 +293,8 @@ mu::Ret NotationProject::save(const io::path& path, SaveMode saveMode)
     case SaveMode::SaveAs:
     case SaveMode::SaveCopy:
         return saveScore(path);
+    case SaveMode::AutoSave:
+        return saveScore(path, saveMode);
     }
 
     return make_ret(notation::Err::UnknownError);
@@ -326,7 +330,8 @@ mu::Ret NotationProject::saveScore(const io::path& path, SaveMode saveMode)
         m_engravingProject->setPath(path.toQString());
     }
 
-    Ret ret = doSave(true);
+    //! NOTE The autosave should not block the UI for long, so it uses the fast compression
+    Ret ret = doSave(true, saveMode == SaveMode::AutoSave);
     if (!ret) {
         ret.setText(Ms::MScore::lastError.toStdString());
     } else if (saveMode != SaveMode::SaveCopy || oldFilePath == path) {
@@ -336,11 +341,15 @@ mu::Ret NotationProject::saveScore(const io::path& path, SaveMode saveMode)
     return make_ret(Ret::Code::Ok);
 }
 
-mu::Ret NotationProject::doSave(bool generateBackup)
+mu::Ret NotationProject::doSave(bool generateBackup, bool fastCompression)
 {
+    TRACEFUNC;
+    BEGIN_STEP_TIME("Save");
+
     // Step 1: create backup if need
     if (generateBackup) {
         makeCurrentFileAsBackup();
+        STEP_TIME("Save", "backup created");
     }
 
     // Step 2: check writable
@@ -355,6 +364,7 @@ mu::Ret NotationProject::doSave(bool generateBackup)
     MscWriter::Params params;
     params.filePath = m_engravingProject->path();
     params.mode = mcsIoModeBySuffix(suffix);
+    params.fastCompression = fastCompression;
     IF_ASSERT_FAILED(params.mode != MscIoMode::Unknown) {
         return make_ret(Ret::Code::InternalError);
     }
@@ -365,8 +375,11 @@ mu::Ret NotationProject::doSave(bool generateBackup)
         LOGE() << "failed write project to buffer";
         return ret;
     }
+    STEP_TIME("Save", "project written");
 
+    // waits for the compression of the files and writes the archive
     msczWriter.close();
+    STEP_TIME("Save", "archive closed");
 
     // make file readable by all
     QFile::setPermissions(info.filePath(), QFile::ReadOwner | QFile::WriteOwner | QFile::ReadUser | QFile::ReadGroup | QFile::ReadOther);
@@ -465,6 +478,17 @@ mu::Ret NotationProject::saveSelectionOnScore(const mu::io::path& path)
     return ret;
 }
 
+//! NOTE In the editor the whole score is laid out in steps, so the first pages
+//! are shown at once and the rest is laid out meanwhile, see Notation::scheduleLayoutStep
+static constexpr size_t LAYOUT_STEP_PAGES = 2;
+
+void NotationProject::setupLayoutSteps(Ms::MasterScore* score)
+{
+    if (application()->runMode() == framework::IApplication::RunMode::Editor) {
+        score->setLayoutStepPages(LAYOUT_STEP_PAGES);
+    }
+}
+
 mu::Ret NotationProject::exportProject(const io::path& path, const std::string& suffix)
 {
     QFile file(path.toQString());
@@ -476,6 +500,8 @@ mu::Ret NotationProject::exportProject(const io::path& path, const std::string&
         return false;
     }
 
+    m_masterNotation->masterScore()->finishLayout();
+
     Ret ret = writer->write(m_masterNotation, file);
     file.close();
 
@@ -28,6 +28,7 @@
 #include "inotationreadersregister.h"
 #include "inotationwritersregister.h"
 #include "system/ifilesystem.h"
+#include "global/iapplication.h"
 
 #include "engraving/engravingproject.h"
 
@@ -45,6 +46,7 @@ class NotationProject : public INotationProject
     INJECT(project, system::IFileSystem, fileSystem)
     INJECT(project, INotationReadersRegister, readers)
     INJECT(project, INotationWritersRegister, writers)
+    INJECT(project, framework::IApplication, application)
 
 public:
     NotationProject();
@@ -70,11 +72,12 @@ private:
 
     Ret doLoad(engraving::MscReader& reader, const io::path& stylePath, bool forceMode);
     Ret doImport(const io::path& path, const io::path& stylePath, bool forceMode);
+    void setupLayoutSteps(Ms::MasterScore* score);
 
     Ret saveScore(const io::path& path = io::path(), SaveMode saveMode = SaveMode::Save);
     Ret saveSelectionOnScore(const io::path& path = io::path());
     Ret exportProject(const io::path& path, const std::string& suffix);
-    Ret doSave(bool generateBackup);
+    Ret doSave(bool generateBackup, bool fastCompression = false);
     Ret makeCurrentFileAsBackup();
     Ret writeProject(engraving::MscWriter& msczWriter, bool onlySelection);
 
@@ -52,7 +52,7 @@ void ProjectAutoSaver::onTrySave()
         return;
     }
 
-    Ret ret = project->save();
+    Ret ret = project->save(io::path(), SaveMode::AutoSave);
     if (!ret) {
         LOGE() << "[autosave] failed to save project, err: " << ret.toString();
         return;
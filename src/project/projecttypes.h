@@ -47,7 +47,8 @@ enum class SaveMode
     Save,
     SaveAs,
     SaveCopy,
-    SaveSelection
+    SaveSelection,
+    AutoSave
 };
 
 struct ProjectMeta
@@ -43,6 +43,16 @@ unsigned int AudioConfigurationStub::driverBufferSize() const
     return 0;
 }
 
+bool AudioConfigurationStub::isWorkerRealtimePriorityEnabled() const
+{
+    return false;
+}
+
+size_t AudioConfigurationStub::trackFreezeMemoryLimit() const
+{
+    return 0;
+}
+
 bool AudioConfigurationStub::isShowControlsInMixer() const
 {
     return false;
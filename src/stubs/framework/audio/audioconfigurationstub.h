@@ -37,6 +37,9 @@ public:
     int audioChannelsCount() const override;
     unsigned int driverBufferSize() const override;  // samples
 
+    bool isWorkerRealtimePriorityEnabled() const override;
+    size_t trackFreezeMemoryLimit() const override;
+
     bool isShowControlsInMixer() const override;
     void setIsShowControlsInMixer(bool show) override;
 
@@ -41,7 +41,7 @@ void AbstractInvoker::invoke(int type, const NotifyData& data)
             invokeCallback(type, c, data);
         } else {
             auto functor = [this, type, c, data]() { invokeCallback(type, c, data); };
-            QueuedInvoker::instance()->invoke(c.threadID, functor);
+            QueuedInvoker::instance()->invoke(c.threadID, std::move(functor));
         }
     }
 }
@@ -62,6 +62,11 @@ void AbstractInvoker::onMainThreadInvoke(const std::function<void(const std::fun
     QueuedInvoker::instance()->onMainThreadInvoke(f);
 }
 
+void AbstractInvoker::onQueued(const std::thread::id& th, const std::function<void()>& f)
+{
+    QueuedInvoker::instance()->onQueued(th, f);
+}
+
 bool AbstractInvoker::isConnected() const
 {
     for (auto it = m_callbacks.cbegin(); it != m_callbacks.cend(); ++it) {
@@ -64,6 +64,7 @@ public:
 
     static void processEvents();
     static void onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f);
+    static void onQueued(const std::thread::id& th, const std::function<void()>& f);
 
 protected:
     explicit AbstractInvoker();
@@ -107,6 +108,13 @@ inline void onMainThreadInvoke(const std::function<void(const std::function<void
 {
     AbstractInvoker::onMainThreadInvoke(f);
 }
+
+// f is called (on the invoking thread) each time a call is queued for the thread th,
+// so a thread waiting for events can be woken up
+inline void onQueued(const std::thread::id& th, const std::function<void()>& f)
+{
+    AbstractInvoker::onQueued(th, f);
+}
 }
 }
 
@@ -2,41 +2,171 @@
 
 using namespace deto::async;
 
+// ThreadQueue
+
+ThreadQueue::ThreadQueue(const std::thread::id& th)
+    : m_threadId(th), m_slots(new Slot[CAPACITY])
+{
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        m_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+ThreadQueue::~ThreadQueue() = default;
+
+bool ThreadQueue::tryPushToRing(QueuedFunctor& f)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &m_slots[pos & (CAPACITY - 1)];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->f = std::move(f);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void ThreadQueue::push(QueuedFunctor&& f)
+{
+    // once the ring has overflowed, keep adding to the overflow list until the consumer has drained it,
+    // otherwise a later call could overtake an earlier one
+    if (!m_overflowing.load(std::memory_order_acquire)) {
+        if (tryPushToRing(f)) {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_overflow.push_back(std::move(f));
+    m_overflowing.store(true, std::memory_order_release);
+}
+
+void ThreadQueue::process()
+{
+    // only the calls queued before this point are processed, the calls queued by them wait for the next time
+    const size_t end = m_enqueuePos.load(std::memory_order_acquire);
+    while (m_dequeuePos != end) {
+        Slot& slot = m_slots[m_dequeuePos & (CAPACITY - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+            break; // the producer has taken the slot, but has not written it yet
+        }
+
+        QueuedFunctor f = std::move(slot.f);
+        slot.seq.store(m_dequeuePos + CAPACITY, std::memory_order_release);
+        ++m_dequeuePos;
+
+        f();
+    }
+
+    if (!m_overflowing.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // the overflow list is only used by producers while the ring is full, and is taken as a whole
+    // once everything queued to the ring before it has been processed
+    if (m_dequeuePos != m_enqueuePos.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::deque<QueuedFunctor> overflow;
+    {
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        overflow.swap(m_overflow);
+        m_overflowing.store(false, std::memory_order_release);
+    }
+
+    for (QueuedFunctor& f : overflow) {
+        f();
+    }
+}
+
+// QueuedInvoker
+
 QueuedInvoker* QueuedInvoker::instance()
 {
     static QueuedInvoker i;
     return &i;
 }
 
-void QueuedInvoker::invoke(const std::thread::id& th, const Functor& f, bool isAlwaysQueued)
+QueuedInvoker::~QueuedInvoker()
 {
-    if (m_onMainThreadInvoke) {
-        if (th == m_mainThreadID) {
-            m_onMainThreadInvoke(f, isAlwaysQueued);
+    ThreadQueue* q = m_queues.load(std::memory_order_acquire);
+    while (q) {
+        ThreadQueue* next = q->next;
+        delete q;
+        q = next;
+    }
+}
+
+ThreadQueue* QueuedInvoker::queue(const std::thread::id& th)
+{
+    for (ThreadQueue* q = m_queues.load(std::memory_order_acquire); q; q = q->next) {
+        if (q->threadId() == th) {
+            return q;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_queuesMutex);
+    ThreadQueue* head = m_queues.load(std::memory_order_acquire);
+    for (ThreadQueue* q = head; q; q = q->next) {
+        if (q->threadId() == th) {
+            return q;
         }
     }
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    m_queues[th].push(f);
+    // queues are never removed, so readers can walk the list without locking
+    ThreadQueue* q = new ThreadQueue(th);
+    q->next = head;
+    m_queues.store(q, std::memory_order_release);
+    return q;
+}
+
+void QueuedInvoker::enqueue(const std::thread::id& th, QueuedFunctor&& f)
+{
+    ThreadQueue* q = queue(th);
+    q->push(std::move(f));
+
+    const Functor* onQueued = q->onQueued.load(std::memory_order_acquire);
+    if (onQueued) {
+        (*onQueued)();
+    }
 }
 
 void QueuedInvoker::processEvents()
 {
-    Queue q;
-    {
-        std::lock_guard<std::recursive_mutex> lock(m_mutex);
-        auto n = m_queues.extract(std::this_thread::get_id());
-        if (!n.empty()) {
-            q = n.mapped();
-        }
+    static thread_local ThreadQueue* q = nullptr;
+    if (!q) {
+        q = queue(std::this_thread::get_id());
     }
-    while (!q.empty()) {
-        const auto& f = q.front();
-        if (f) {
-            f();
-        }
-        q.pop();
+
+    q->process();
+}
+
+void QueuedInvoker::onQueued(const std::thread::id& th, const Functor& f)
+{
+    ThreadQueue* q = queue(th);
+
+    std::lock_guard<std::mutex> lock(m_queuesMutex);
+    const Functor* onQueued = nullptr;
+    if (f) {
+        m_onQueuedCallbacks.emplace_back(new Functor(f));
+        onQueued = m_onQueuedCallbacks.back().get();
     }
+
+    // the previous callback is kept alive, a producer may still be calling it
+    q->onQueued.store(onQueued, std::memory_order_release);
 }
 
 void QueuedInvoker::onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f)
@@ -2,13 +2,160 @@
 #define DETO_ASYNC_QUEUEDINVOKER_H
 
 #include <functional>
-#include <queue>
-#include <map>
+#include <atomic>
+#include <memory>
+#include <deque>
+#include <vector>
 #include <mutex>
 #include <thread>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 namespace deto {
 namespace async {
+// Move-only callable with inline storage, so queuing a call does not allocate
+// (callables larger than the buffer are still put on the heap)
+class QueuedFunctor
+{
+public:
+    static constexpr size_t INLINE_SIZE = 96;
+
+    QueuedFunctor() = default;
+
+    template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, QueuedFunctor>::value>::type>
+    explicit QueuedFunctor(F&& f)
+    {
+        using T = typename std::decay<F>::type;
+        if constexpr (sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t)
+                      && std::is_nothrow_move_constructible<T>::value) {
+            new (m_buf) T(std::forward<F>(f));
+            m_ops = &InlineOps<T>::ops;
+        } else {
+            *reinterpret_cast<T**>(m_buf) = new T(std::forward<F>(f));
+            m_ops = &HeapOps<T>::ops;
+        }
+    }
+
+    QueuedFunctor(QueuedFunctor&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    QueuedFunctor& operator=(QueuedFunctor&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    QueuedFunctor(const QueuedFunctor&) = delete;
+    QueuedFunctor& operator=(const QueuedFunctor&) = delete;
+
+    ~QueuedFunctor()
+    {
+        reset();
+    }
+
+    explicit operator bool() const { return m_ops != nullptr; }
+
+    void operator()()
+    {
+        m_ops->call(m_buf);
+    }
+
+    void reset()
+    {
+        if (m_ops) {
+            m_ops->destroy(m_buf);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (* call)(void*);
+        void (* move)(void* dst, void* src);
+        void (* destroy)(void*);
+    };
+
+    template<typename T>
+    struct InlineOps {
+        static void call(void* p) { (*static_cast<T*>(p))(); }
+        static void move(void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); static_cast<T*>(src)->~T(); }
+        static void destroy(void* p) { static_cast<T*>(p)->~T(); }
+        static constexpr Ops ops = { &call, &move, &destroy };
+    };
+
+    template<typename T>
+    struct HeapOps {
+        static void call(void* p) { (**static_cast<T**>(p))(); }
+        static void move(void* dst, void* src) { *static_cast<T**>(dst) = *static_cast<T**>(src); }
+        static void destroy(void* p) { delete *static_cast<T**>(p); }
+        static constexpr Ops ops = { &call, &move, &destroy };
+    };
+
+    void moveFrom(QueuedFunctor& other)
+    {
+        m_ops = other.m_ops;
+        if (m_ops) {
+            m_ops->move(m_buf, other.m_buf);
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char m_buf[INLINE_SIZE];
+    const Ops* m_ops = nullptr;
+};
+
+template<typename T>
+constexpr QueuedFunctor::Ops QueuedFunctor::InlineOps<T>::ops;
+
+template<typename T>
+constexpr QueuedFunctor::Ops QueuedFunctor::HeapOps<T>::ops;
+
+// Queue of the calls for one thread: many producers, the thread itself is the only consumer.
+// A bounded lock-free ring (D. Vyukov's algorithm); if the consumer falls behind and the ring is full,
+// the calls go to a locked overflow list until the consumer has caught up
+class ThreadQueue
+{
+public:
+    using Functor = std::function<void ()>;
+
+    explicit ThreadQueue(const std::thread::id& th);
+    ~ThreadQueue();
+
+    std::thread::id threadId() const { return m_threadId; }
+
+    void push(QueuedFunctor&& f);
+    void process();
+
+    std::atomic<const Functor*> onQueued { nullptr };
+    ThreadQueue* next = nullptr; // set before the queue is published, never changed after
+
+private:
+    static constexpr size_t CAPACITY = 1024; // power of two
+
+    struct Slot {
+        std::atomic<size_t> seq { 0 };
+        QueuedFunctor f;
+    };
+
+    bool tryPushToRing(QueuedFunctor& f);
+
+    const std::thread::id m_threadId;
+    std::unique_ptr<Slot[]> m_slots;
+
+    alignas(64) std::atomic<size_t> m_enqueuePos { 0 };
+    alignas(64) size_t m_dequeuePos = 0;
+
+    std::atomic<bool> m_overflowing { false };
+    std::mutex m_overflowMutex;
+    std::deque<QueuedFunctor> m_overflow;
+};
+
 class QueuedInvoker
 {
 public:
@@ -17,18 +164,40 @@ public:
 
     using Functor = std::function<void ()>;
 
-    void invoke(const std::thread::id& th, const Functor& f, bool isAlwaysQueued = false);
+    template<typename F>
+    void invoke(const std::thread::id& th, F&& f, bool isAlwaysQueued = false)
+    {
+        if (!isCallable(f)) {
+            return;
+        }
+
+        if (m_onMainThreadInvoke && th == m_mainThreadID) {
+            m_onMainThreadInvoke(Functor(std::forward<F>(f)), isAlwaysQueued);
+            return;
+        }
+
+        enqueue(th, QueuedFunctor(std::forward<F>(f)));
+    }
+
     void processEvents();
     void onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f);
+    void onQueued(const std::thread::id& th, const Functor& f);
 
 private:
 
     QueuedInvoker() = default;
+    ~QueuedInvoker();
+
+    template<typename F>
+    static bool isCallable(const F&) { return true; }
+    static bool isCallable(const Functor& f) { return static_cast<bool>(f); }
 
-    using Queue = std::queue<Functor>;
+    ThreadQueue* queue(const std::thread::id& th);
+    void enqueue(const std::thread::id& th, QueuedFunctor&& f);
 
-    std::recursive_mutex m_mutex;
-    std::map<std::thread::id, Queue > m_queues;
+    std::atomic<ThreadQueue*> m_queues { nullptr };
+    std::mutex m_queuesMutex; // only for adding queues and replacing the onQueued callbacks
+    std::vector<std::unique_ptr<const Functor> > m_onQueuedCallbacks;
 
     std::function<void(const std::function<void()>&, bool)> m_onMainThreadInvoke;
     std::thread::id m_mainThreadID;
@@ -163,7 +163,7 @@ static int inflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     return err;
 }
 
-static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen)
+static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen, int level)
 {
     z_stream stream;
     int err;
@@ -180,7 +180,7 @@ static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     stream.zfree = (free_func)0;
     stream.opaque = (voidpf)0;
 
-    err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    err = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
     if (err != Z_OK) {
         return err;
     }
@@ -553,19 +553,22 @@ public:
         : MQZipPrivate(device, ownDev),
         status(MQZipWriter::NoError),
         permissions(QFile::ReadOwner | QFile::WriteOwner),
-        compressionPolicy(MQZipWriter::AlwaysCompress)
+        compressionPolicy(MQZipWriter::AlwaysCompress),
+        compressionLevel(Z_DEFAULT_COMPRESSION)
     {
     }
 
     MQZipWriter::Status status;
     QFile::Permissions permissions;
     MQZipWriter::CompressionPolicy compressionPolicy;
+    int compressionLevel;
 
     enum EntryType {
         Directory, File, Symlink
     };
 
     void addEntry(EntryType type, const QString& fileName, const QByteArray& contents);
+    void addEntry(EntryType type, const QString& fileName, const MQZipWriter::PreparedFile& file);
 };
 
 LocalFileHeader CentralFileHeader::toLocalHeader() const
@@ -675,27 +678,11 @@ void MQZipReaderPrivate::scanFiles()
     }
 }
 
-void MQZipWriterPrivate::addEntry(EntryType type, const QString& fileName,
-                                  const QByteArray& contents /*, QFile::Permissions permissions, QZip::Method m*/)
+MQZipWriter::PreparedFile MQZipWriter::prepareFile(const QByteArray& contents, CompressionPolicy policy, int level)
 {
-#ifndef NDEBUG
-    static const char* const entryTypes[] = {
-        "directory",
-        "file     ",
-        "symlink  " };
-    ZDEBUG() << "adding" << entryTypes[type] << ":" << fileName.toUtf8().data()
-             << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
-#endif
-
-    if (!(device->isOpen() || device->open(QIODevice::WriteOnly))) {
-        status = MQZipWriter::FileOpenError;
-        return;
-    }
-    device->seek(start_of_directory);
-
     // don't compress small files
-    MQZipWriter::CompressionPolicy compression = compressionPolicy;
-    if (compressionPolicy == MQZipWriter::AutoCompress) {
+    MQZipWriter::CompressionPolicy compression = policy;
+    if (policy == MQZipWriter::AutoCompress) {
         if (contents.length() < 64) {
             compression = MQZipWriter::NeverCompress;
         } else {
@@ -703,24 +690,21 @@ void MQZipWriterPrivate::addEntry(EntryType type, const QString& fileName,
         }
     }
 
-    FileHeader header;
-    memset(&header.h, 0, sizeof(CentralFileHeader));
-    writeUInt(header.h.signature, 0x02014b50);
+    PreparedFile file;
+    file.uncompressedSize = contents.length();
+    file.crc32 = ::crc32(0, 0, 0);
+    file.crc32 = ::crc32(file.crc32, (const uchar*)contents.constData(), contents.length());
+    file.data = contents;
 
-    writeUShort(header.h.version_needed, ZIP_VERSION);
-    writeUInt(header.h.uncompressed_size, contents.length());
-    writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
-    QByteArray data = contents;
     if (compression == MQZipWriter::AlwaysCompress) {
-        writeUShort(header.h.compression_method, CompressionMethodDeflated);
-
+        QByteArray data;
         ulong len = contents.length();
         // shamelessly copied form zlib
         len += (len >> 12) + (len >> 14) + 11;
         int res;
         do {
             data.resize(len);
-            res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length());
+            res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length(), level);
 
             switch (res) {
             case Z_OK:
@@ -728,19 +712,64 @@ void MQZipWriterPrivate::addEntry(EntryType type, const QString& fileName,
                 break;
             case Z_MEM_ERROR:
                 qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
+                file.ok = false;
                 break;
             case Z_BUF_ERROR:
                 len *= 2;
                 break;
             }
         } while (res == Z_BUF_ERROR);
+
+        // store the original if the compression does not help (already compressed data)
+        if (res == Z_OK && data.length() < contents.length()) {
+            file.data = data;
+            file.deflated = true;
+        }
+    }
+
+    return file;
+}
+
+void MQZipWriterPrivate::addEntry(EntryType type, const QString& fileName, const QByteArray& contents)
+{
+    addEntry(type, fileName, MQZipWriter::prepareFile(contents, compressionPolicy, compressionLevel));
+}
+
+void MQZipWriterPrivate::addEntry(EntryType type, const QString& fileName,
+                                  const MQZipWriter::PreparedFile& file /*, QFile::Permissions permissions, QZip::Method m*/)
+{
+#ifndef NDEBUG
+    static const char* const entryTypes[] = {
+        "directory",
+        "file     ",
+        "symlink  " };
+    ZDEBUG() << "adding" << entryTypes[type] << ":" << fileName.toUtf8().data()
+             << (type == 2 ? QByteArray(" -> " + file.data).constData() : "");
+#endif
+
+    if (!file.ok) {
+        return;
+    }
+
+    if (!(device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = MQZipWriter::FileOpenError;
+        return;
+    }
+    device->seek(start_of_directory);
+
+    FileHeader header;
+    memset(&header.h, 0, sizeof(CentralFileHeader));
+    writeUInt(header.h.signature, 0x02014b50);
+
+    writeUShort(header.h.version_needed, ZIP_VERSION);
+    writeUInt(header.h.uncompressed_size, file.uncompressedSize);
+    writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
+    const QByteArray& data = file.data;
+    if (file.deflated) {
+        writeUShort(header.h.compression_method, CompressionMethodDeflated);
     }
-// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
     writeUInt(header.h.compressed_size, data.length());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uchar*)contents.constData(), contents.length());
-    writeUInt(header.h.crc_32, crc_32);
+    writeUInt(header.h.crc_32, file.crc32);
 
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     ushort general_purpose_bits = Utf8Names; // always use utf-8
@@ -1280,6 +1309,20 @@ MQZipWriter::CompressionPolicy MQZipWriter::compressionPolicy() const
     return d->compressionPolicy;
 }
 
+/*!
+    Sets the zlib compression \a level of the compressed files, -1 is the default level,
+    1 is the fastest.
+*/
+void MQZipWriter::setCompressionLevel(int level)
+{
+    d->compressionLevel = level;
+}
+
+int MQZipWriter::compressionLevel() const
+{
+    return d->compressionLevel;
+}
+
 /*!
     Sets the permissions that will be used for newly added files.
 
@@ -1321,6 +1364,14 @@ void MQZipWriter::addFile(const QString& fileName, const QByteArray& data)
     d->addEntry(MQZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), data);
 }
 
+/*!
+    Add the file prepared by prepareFile() to the archive.
+*/
+void MQZipWriter::addPreparedFile(const QString& fileName, const PreparedFile& file)
+{
+    d->addEntry(MQZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), file);
+}
+
 /*!
     Add a file to the archive with \a device as the source of the contents.
     The contents returned from QIODevice::readAll() will be used as the
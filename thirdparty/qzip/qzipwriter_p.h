@@ -94,6 +94,10 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    // zlib compression level, -1 is the default
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
     void setCreationPermissions(QFile::Permissions permissions);
     QFile::Permissions creationPermissions() const;
 
@@ -101,6 +105,19 @@ public:
 
     void addFile(const QString &fileName, QIODevice *device);
 
+    // the compressed contents of a file, prepareFile() does not touch the archive,
+    // so the files can be prepared in parallel and then added in the wanted order
+    struct PreparedFile {
+        QByteArray data;
+        uint crc32 = 0;
+        uint uncompressedSize = 0;
+        bool deflated = false;
+        bool ok = true;
+    };
+
+    static PreparedFile prepareFile(const QByteArray &data, CompressionPolicy policy, int level = -1);
+    void addPreparedFile(const QString &fileName, const PreparedFile &file);
+
     void addDirectory(const QString &dirName);
 
     void addSymLink(const QString &fileName, const QString &destination);